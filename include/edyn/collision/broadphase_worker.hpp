@@ -24,6 +24,7 @@ class broadphase_worker {
     void collide_tree_async(const dynamic_tree &tree, entt::entity entity, const AABB &offset_aabb, size_t result_index);
 
     void common_update();
+    void prefetch_paged_meshes();
 
 public:
 
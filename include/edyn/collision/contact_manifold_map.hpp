@@ -1,17 +1,28 @@
 #ifndef EDYN_COLLISION_CONTACT_MANIFOLD_MAP
 #define EDYN_COLLISION_CONTACT_MANIFOLD_MAP
 
-#include <map>
+#include <vector>
+#include <cstdint>
 #include <utility>
 #include <entt/entity/fwd.hpp>
+#include <entt/entity/entity.hpp>
 #include "edyn/util/entity_pair.hpp"
 
 namespace edyn {
 
 /**
- * @brief Maps a pair of entities to their contact manifold.
+ * @brief Maps a pair of entities to their contact manifold. Entries are kept
+ * in an open-addressing hash table with linear probing, keyed by the pair of
+ * entities packed into a single integer regardless of their order. Lookups
+ * do not modify the table, thus it can be queried from multiple threads
+ * concurrently as long as no manifolds are created or destroyed meanwhile.
  */
 class contact_manifold_map {
+    struct slot {
+        uint64_t key {0};
+        entt::entity manifold_entity {entt::null};
+    };
+
 public:
     contact_manifold_map(entt::registry &);
 
@@ -35,11 +46,43 @@ public:
     /*! @copydoc get */
     entt::entity get(entt::entity, entt::entity) const;
 
+    /**
+     * @brief Finds the manifold entity joining a pair of entities with a
+     * single lookup.
+     * @param pair The pair of entities.
+     * @return Entity of manifold connecting the two entities or `entt::null`
+     * if there's none.
+     */
+    entt::entity find(entity_pair) const;
+
+    /*! @copydoc find */
+    entt::entity find(entt::entity, entt::entity) const;
+
+    /**
+     * @brief Number of manifolds in the map.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Reserves space for the given number of manifolds. Should be
+     * called before creating a batch of manifolds so the table is grown
+     * at most once for the whole batch.
+     * @param count Total number of manifolds expected in the map.
+     */
+    void reserve(size_t count);
+
     void on_construct_contact_manifold(entt::registry &, entt::entity);
     void on_destroy_contact_manifold(entt::registry &, entt::entity);
 
 private:
-    std::map<entity_pair, entt::entity> m_pair_map;
+    static uint64_t make_key(entt::entity, entt::entity);
+    size_t find_slot(uint64_t key) const;
+    void insert(uint64_t key, entt::entity manifold_entity);
+    void erase(uint64_t key);
+    void rehash(size_t capacity);
+
+    std::vector<slot> m_slots;
+    size_t m_size {0};
 };
 
 }
@@ -31,6 +31,7 @@ class narrowphase {
     };
 
     void clear_contact_manifold_events();
+    void update_rotated_meshes();
 
 public:
     narrowphase(entt::registry &);
@@ -17,6 +17,7 @@ struct compound_shape;
 struct plane_shape;
 struct mesh_shape;
 struct paged_mesh_shape;
+struct heightfield_shape;
 
 /**
  * @brief Info provided when raycasting a box.
@@ -72,6 +73,14 @@ struct paged_mesh_raycast_info {
     size_t triangle_index;
 };
 
+/**
+ * @brief Info provided when raycasting a height field.
+ */
+struct heightfield_raycast_info {
+    // Index of triangle the ray intersects.
+    size_t triangle_index;
+};
+
 /**
  * @brief Info provided when raycasting a compound.
  */
@@ -107,7 +116,8 @@ struct shape_raycast_result {
         polyhedron_raycast_info,
         compound_raycast_info,
         mesh_raycast_info,
-        paged_mesh_raycast_info
+        paged_mesh_raycast_info,
+        heightfield_raycast_info
     > info_var;
 };
 
@@ -156,6 +166,7 @@ shape_raycast_result shape_raycast(const compound_shape &, const raycast_context
 shape_raycast_result shape_raycast(const plane_shape &, const raycast_context &);
 shape_raycast_result shape_raycast(const mesh_shape &, const raycast_context &);
 shape_raycast_result shape_raycast(const paged_mesh_shape &, const raycast_context &);
+shape_raycast_result shape_raycast(const heightfield_shape &, const raycast_context &);
 
 }
 
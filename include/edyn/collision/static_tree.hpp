@@ -7,6 +7,7 @@
 #include <numeric>
 #include <algorithm>
 #include "edyn/collision/query_tree.hpp"
+#include "edyn/util/mappable_vector.hpp"
 
 namespace edyn {
 
@@ -135,22 +136,37 @@ public:
         m_nodes.clear();
     }
 
+    /**
+     * @brief Number of bytes allocated for the nodes of this tree.
+     */
+    size_t memory_usage() const {
+        return m_nodes.capacity() * sizeof(tree_node);
+    }
+
     template<typename Archive>
     friend void serialize(Archive &archive, static_tree &tree);
     friend size_t serialization_sizeof(const static_tree &tree);
 
 private:
-    std::vector<tree_node> m_nodes;
+    mappable_vector<tree_node> m_nodes;
 };
 
 template<typename Func>
 void static_tree::query(const AABB &aabb, Func func) const {
+    if (m_nodes.empty()) {
+        return;
+    }
+
     uint32_t root_node_idx = 0;
     query_tree(*this, root_node_idx, EDYN_NULL_NODE, aabb, func);
 }
 
 template<typename Func>
 void static_tree::raycast(vector3 p0, vector3 p1, Func func) const {
+    if (m_nodes.empty()) {
+        return;
+    }
+
     uint32_t root_node_idx = 0;
     raycast_tree(*this, root_node_idx, EDYN_NULL_NODE, p0, p1, func);
 }
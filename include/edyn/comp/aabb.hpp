@@ -8,6 +8,10 @@ namespace edyn {
 
 /**
  * @brief Axis-aligned bounding box.
+ * @remark The AABBs of simulated entities in the main registry are only
+ * updated by the island workers once they move by more than
+ * `edyn::contact_breaking_threshold`, thus they only enclose the current
+ * bounds of the shape once inflated by that amount.
  */
 struct AABB {
     vector3 min;
@@ -49,6 +53,13 @@ inline AABB enclosing_aabb(const AABB &b0, const AABB &b1) {
     };
 }
 
+// Returns the AABB enclosing the region swept by `aabb` moving with constant
+// velocity `v` for the duration `time`.
+inline AABB swept_aabb(const AABB &aabb, const vector3 &v, scalar time) {
+    auto displacement = v * time;
+    return enclosing_aabb(aabb, {aabb.min + displacement, aabb.max + displacement});
+}
+
 template<typename Archive>
 void serialize(Archive &archive, AABB &aabb) {
     archive(aabb.min);
@@ -1,28 +1,59 @@
 #ifndef EDYN_COMP_DIRTY_HPP
 #define EDYN_COMP_DIRTY_HPP
 
-#include <set>
+#include <array>
+#include <bitset>
+#include <vector>
+#include <algorithm>
 #include <entt/entity/fwd.hpp>
 #include <entt/core/type_info.hpp>
+#include "edyn/comp/shared_comp.hpp"
+#include "edyn/util/tuple_util.hpp"
 
 namespace edyn {
 
+namespace detail {
+    template<typename Tuple>
+    struct tuple_type_ids;
+
+    template<typename... Ts>
+    struct tuple_type_ids<std::tuple<Ts...>> {
+        static entt::id_type get(size_t index) {
+            static const auto ids = std::array<entt::id_type, sizeof...(Ts)>{entt::type_index<Ts>::value()...};
+            return ids[index];
+        }
+    };
+}
+
 /**
  * @brief Marks an entity as dirty, consequently scheduling them for a refresh
  *      in the other end, i.e. from island worker to island coordinator and
  *      vice versa. These components are consumed by an island worker or
  *      coordinator in their update, i.e. they get processed and deleted right
  *      after.
+ * @remark Shared components are tracked in bitsets by their index in
+ *      `shared_components_t`, which is also their index in a
+ *      `component_index_source`. Other components, such as external
+ *      components, are tracked by type id.
  */
 struct dirty {
+    static constexpr size_t num_shared_components = std::tuple_size_v<shared_components_t>;
+
     // If the entity was just created, this flag must be set.
     bool is_new_entity {false};
 
-    using id_set_t = std::set<entt::id_type>;
+    using index_set_t = std::bitset<num_shared_components>;
+    using id_set_t = std::vector<entt::id_type>;
+
+    // Indices of shared components.
+    index_set_t created_indexes;
+    index_set_t updated_indexes;
+    index_set_t destroyed_indexes;
 
-    id_set_t created_indexes;
-    id_set_t updated_indexes;
-    id_set_t destroyed_indexes;
+    // Type ids of components which are not shared.
+    id_set_t created_ids;
+    id_set_t updated_ids;
+    id_set_t destroyed_ids;
 
     /**
      * @brief Marks the given components as created.
@@ -31,7 +62,7 @@ struct dirty {
      */
     template<typename... Ts>
     dirty & created() {
-        return cud<Ts...>(&dirty::created_indexes);
+        return cud<Ts...>(&dirty::created_indexes, &dirty::created_ids);
     }
 
     /**
@@ -41,7 +72,7 @@ struct dirty {
      */
     template<typename... Ts>
     dirty & updated() {
-        return cud<Ts...>(&dirty::updated_indexes);
+        return cud<Ts...>(&dirty::updated_indexes, &dirty::updated_ids);
     }
 
     /**
@@ -51,7 +82,7 @@ struct dirty {
      */
     template<typename... Ts>
     dirty & destroyed() {
-        return cud<Ts...>(&dirty::destroyed_indexes);
+        return cud<Ts...>(&dirty::destroyed_indexes, &dirty::destroyed_ids);
     }
 
     /**
@@ -64,19 +95,94 @@ struct dirty {
     }
 
     dirty & merge(const dirty &other) {
-        created_indexes.insert(other.created_indexes.begin(), other.created_indexes.end());
-        updated_indexes.insert(other.updated_indexes.begin(), other.updated_indexes.end());
-        destroyed_indexes.insert(other.destroyed_indexes.begin(), other.destroyed_indexes.end());
+        created_indexes |= other.created_indexes;
+        updated_indexes |= other.updated_indexes;
+        destroyed_indexes |= other.destroyed_indexes;
+        merge_ids(created_ids, other.created_ids);
+        merge_ids(updated_ids, other.updated_ids);
+        merge_ids(destroyed_ids, other.destroyed_ids);
         return *this;
     }
 
+    /**
+     * @brief Invokes `func` with the type id of each created component.
+     */
+    template<typename Func>
+    void each_created_id(Func func) const {
+        each_id(created_indexes, created_ids, func);
+    }
+
+    /**
+     * @brief Invokes `func` with the type id of each updated component.
+     */
+    template<typename Func>
+    void each_updated_id(Func func) const {
+        each_id(updated_indexes, updated_ids, func);
+    }
+
+    /**
+     * @brief Invokes `func` with the type id of each destroyed component.
+     */
+    template<typename Func>
+    void each_destroyed_id(Func func) const {
+        each_id(destroyed_indexes, destroyed_ids, func);
+    }
+
+    /**
+     * @brief Invokes `func` with the index of each set bit.
+     */
+    template<typename Func>
+    static void each_index(const index_set_t &indexes, Func func) {
+        if (indexes.none()) {
+            return;
+        }
+
+        for (size_t i = 0; i < indexes.size(); ++i) {
+            if (indexes.test(i)) {
+                func(i);
+            }
+        }
+    }
+
 private:
     // CUD: Create, Update, Delete.
     template<typename... Ts>
-    dirty & cud(id_set_t dirty:: *member) {
-        ((this->*member).insert(entt::type_index<Ts>::value()), ...);
+    dirty & cud(index_set_t dirty:: *indexes, id_set_t dirty:: *ids) {
+        (insert<Ts>(this->*indexes, this->*ids), ...);
         return *this;
     }
+
+    template<typename T>
+    static void insert(index_set_t &indexes, id_set_t &ids) {
+        if constexpr(tuple_has_type<T, shared_components_t>::value) {
+            indexes.set(tuple_type_index_of<size_t, T, shared_components_t>::value);
+        } else {
+            auto id = entt::type_index<T>::value();
+
+            if (std::find(ids.begin(), ids.end(), id) == ids.end()) {
+                ids.push_back(id);
+            }
+        }
+    }
+
+    static void merge_ids(id_set_t &ids, const id_set_t &other) {
+        for (auto id : other) {
+            if (std::find(ids.begin(), ids.end(), id) == ids.end()) {
+                ids.push_back(id);
+            }
+        }
+    }
+
+    template<typename Func>
+    static void each_id(const index_set_t &indexes, const id_set_t &ids, Func &func) {
+        each_index(indexes, [&] (size_t index) {
+            func(detail::tuple_type_ids<shared_components_t>::get(index));
+        });
+
+        for (auto id : ids) {
+            func(id);
+        }
+    }
 };
 
 }
@@ -2,6 +2,7 @@
 #define EDYN_COMP_ROTATED_MESH_LIST_HPP
 
 #include <memory>
+#include <cstdint>
 #include <entt/entity/fwd.hpp>
 #include <entt/entity/entity.hpp>
 #include "edyn/math/quaternion.hpp"
@@ -29,6 +30,15 @@ struct rotated_mesh_list {
 
     // Entity of next rotated mesh in the linked list.
     entt::entity next {entt::null};
+
+    // Value of the rotated mesh version when the rotated meshes in this list
+    // were last updated. Only meaningful for the head of the list. Zero means
+    // the list has never been updated.
+    uint32_t version {0};
+
+    // Orientation of the body when the rotated meshes in this list were last
+    // updated. Only meaningful for the head of the list.
+    quaternion body_orientation {quaternion_identity};
 };
 
 }
@@ -29,6 +29,10 @@ struct settings {
     unsigned num_restitution_iterations {8};
     unsigned num_individual_restitution_iterations {3};
 
+    // Number of steps ahead to predict the motion of bodies in order to
+    // prefetch the submeshes of paged triangle meshes they might touch.
+    unsigned num_paged_mesh_prefetch_steps {4};
+
     make_reg_op_builder_func_t make_reg_op_builder {&make_reg_op_builder_default};
     std::shared_ptr<component_index_source> index_source;
     external_system_func_t external_system_init {nullptr};
@@ -17,6 +17,13 @@ public:
 
     void update(scalar dt);
 
+    /**
+     * @brief Number of constraint rows solved in the last update.
+     */
+    size_t num_rows() const {
+        return m_row_cache.rows.size();
+    }
+
 private:
     entt::registry *m_registry;
     row_cache m_row_cache;
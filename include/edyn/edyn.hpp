@@ -36,6 +36,7 @@
 #include "parallel/island_coordinator.hpp"
 #include "util/moment_of_inertia.hpp"
 #include "util/registry_operation_builder.hpp"
+#include "util/presentation_snapshot.hpp"
 #include "collision/contact_manifold_map.hpp"
 #include "context/settings.hpp"
 #include "collision/raycast.hpp"
@@ -50,6 +51,11 @@ struct init_config {
     // Number of worker threads to spawn. If zero, value will be taken from
     // `std::thread::hardware_concurrency`.
     size_t num_worker_threads {0};
+
+    // Whether to pin each worker thread to a logical core. Island workers
+    // prefer to run in the same worker thread they ran last, which keeps
+    // their data in that core's cache if the thread doesn't migrate.
+    bool pin_worker_threads {false};
 };
 
 /**
@@ -111,6 +117,57 @@ void set_paused(entt::registry &registry, bool paused);
  */
 void update(entt::registry &registry);
 
+/**
+ * @brief Starts an update of the simulation in a background job, which is an
+ * alternative to `edyn::update` that does not block the calling thread while
+ * the coordination of background simulation jobs takes place. The registry
+ * must not be accessed until `edyn::wait_update` is called, thus other work
+ * can be done in the meantime, such as submitting the last frame for
+ * rendering. Presentation data of the previous update remains available via
+ * `edyn::get_presentation_snapshot`. All other functions in this file which
+ * modify or query simulation state throw `std::logic_error` while the update
+ * is pending. Signals, such as contact started and ended, are emitted in the
+ * background job.
+ * @param registry Data source.
+ */
+void update_async(entt::registry &registry);
+
+/**
+ * @brief Waits for the update started by `edyn::update_async` to finish, after
+ * which the registry can be accessed again. The presentation position and
+ * orientation of rigid bodies are refreshed by the background job and its
+ * snapshot replaces the one returned by `edyn::get_presentation_snapshot`.
+ * Only blocks if the background job has not finished yet. Throws
+ * `std::logic_error` if there's no pending update.
+ * @param registry Data source.
+ */
+void wait_update(entt::registry &registry);
+
+/**
+ * @brief Checks whether an update started by `edyn::update_async` has not been
+ * completed by `edyn::wait_update` yet.
+ * @param registry Data source.
+ * @return Whether an asynchronous update is pending.
+ */
+bool is_update_pending(const entt::registry &registry);
+
+/**
+ * @brief Gets the presentation position and orientation of all rigid bodies
+ * as of the last update completed by `edyn::wait_update`. Unlike the registry,
+ * the snapshot can be read while an update is pending, since the background
+ * job fills a separate buffer which is only swapped in by `edyn::wait_update`.
+ * The returned reference remains valid until the registry is detached. Not
+ * updated by `edyn::update`.
+ * @param registry Data source.
+ * @return Presentation snapshot.
+ */
+const presentation_snapshot & get_presentation_snapshot(const entt::registry &registry);
+
+namespace detail {
+    // Throws `std::logic_error` if an asynchronous update is pending.
+    void throw_if_update_pending(const entt::registry &registry, const char *caller);
+}
+
 /**
  * @brief Runs a single step for a paused simulation.
  * @param registry Data source.
@@ -155,6 +212,7 @@ auto get_component_indices(entt::registry &registry) {
  */
 template<typename... Component>
 void register_external_components(entt::registry &registry) {
+    detail::throw_if_update_pending(registry, "edyn::register_external_components");
     auto &settings = registry.ctx<edyn::settings>();
 
     settings.make_reg_op_builder = [] () {
@@ -254,6 +312,8 @@ void set_should_collide(entt::registry &registry, should_collide_func_t func);
  */
 template<typename... Component>
 void refresh(entt::registry &registry, entt::entity entity) {
+    detail::throw_if_update_pending(registry, "edyn::refresh");
+
     if (auto *coordinator = registry.try_ctx<island_coordinator>(); coordinator) {
         coordinator->refresh<Component...>(entity);
     }
@@ -418,6 +478,25 @@ unsigned get_solver_individual_restitution_iterations(const entt::registry &regi
  */
 void set_solver_individual_restitution_iterations(entt::registry &registry, unsigned iterations);
 
+/**
+ * @brief Get the number of steps ahead used to prefetch paged triangle mesh
+ * submeshes.
+ * @param registry Data source.
+ * @return Number of prefetch steps.
+ */
+unsigned get_paged_mesh_prefetch_steps(const entt::registry &registry);
+
+/**
+ * @brief Set the number of steps ahead used to prefetch paged triangle mesh
+ * submeshes. Before each step, the AABB of each moving body is extended by
+ * its velocity over this many steps and the submeshes that intersect it start
+ * loading, so they're likely available once the body reaches them. Zero
+ * disables prefetching.
+ * @param registry Data source.
+ * @param steps Number of prefetch steps.
+ */
+void set_paged_mesh_prefetch_steps(entt::registry &registry, unsigned steps);
+
 /**
  * @brief Use the provided material when two rigid bodies with the given
  * material ids collide.
@@ -0,0 +1,91 @@
+#ifndef EDYN_MATH_QUANTIZATION_HPP
+#define EDYN_MATH_QUANTIZATION_HPP
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include "edyn/math/vector3.hpp"
+
+namespace edyn {
+
+// Series of functions to store vectors in fewer bits.
+
+// Maps a value in the [0, 1] range into a 16-bit unsigned integer.
+inline uint16_t quantize_unorm16(scalar v) {
+    v = std::clamp(v, scalar(0), scalar(1));
+    return static_cast<uint16_t>(std::round(v * scalar(UINT16_MAX)));
+}
+
+inline scalar dequantize_unorm16(uint16_t q) {
+    return scalar(q) / scalar(UINT16_MAX);
+}
+
+/**
+ * @brief Quantizes a position relative to the box starting at `origin` with
+ * size `UINT16_MAX * scale`.
+ * @param v Position which must be contained in the box.
+ * @param origin Minimum of the box.
+ * @param inv_scale Reciprocal of `scale` in each coordinate, or zero if the
+ * box has no extent along that axis.
+ * @return Quantized position.
+ */
+inline std::array<uint16_t, 3> quantize_position(const vector3 &v, const vector3 &origin,
+                                                 const vector3 &inv_scale) {
+    auto q = (v - origin) * inv_scale;
+    auto max = scalar(UINT16_MAX);
+    return {
+        static_cast<uint16_t>(std::round(std::clamp(q.x, scalar(0), max))),
+        static_cast<uint16_t>(std::round(std::clamp(q.y, scalar(0), max))),
+        static_cast<uint16_t>(std::round(std::clamp(q.z, scalar(0), max)))
+    };
+}
+
+inline vector3 dequantize_position(const std::array<uint16_t, 3> &q, const vector3 &origin,
+                                   const vector3 &scale) {
+    return origin + vector3{scalar(q[0]), scalar(q[1]), scalar(q[2])} * scale;
+}
+
+/**
+ * @brief Packs a unit vector into 32 bits using an octahedral mapping, where
+ * the unit sphere is projected onto an octahedron which is then unfolded
+ * onto a square. Each coordinate of the square is stored in 16 bits.
+ * @param n A unit vector.
+ * @return Packed unit vector.
+ */
+inline uint32_t pack_unit_vector_octahedral(const vector3 &n) {
+    auto l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    auto px = n.x / l1;
+    auto py = n.y / l1;
+
+    if (n.z < 0) {
+        auto fx = (scalar(1) - std::abs(py)) * (px < 0 ? scalar(-1) : scalar(1));
+        auto fy = (scalar(1) - std::abs(px)) * (py < 0 ? scalar(-1) : scalar(1));
+        px = fx;
+        py = fy;
+    }
+
+    auto qx = quantize_unorm16(px * scalar(0.5) + scalar(0.5));
+    auto qy = quantize_unorm16(py * scalar(0.5) + scalar(0.5));
+
+    return static_cast<uint32_t>(qx) | (static_cast<uint32_t>(qy) << 16);
+}
+
+inline vector3 unpack_unit_vector_octahedral(uint32_t packed) {
+    auto px = dequantize_unorm16(packed & 0xffff) * scalar(2) - scalar(1);
+    auto py = dequantize_unorm16(packed >> 16) * scalar(2) - scalar(1);
+    auto pz = scalar(1) - std::abs(px) - std::abs(py);
+
+    if (pz < 0) {
+        auto fx = (scalar(1) - std::abs(py)) * (px < 0 ? scalar(-1) : scalar(1));
+        auto fy = (scalar(1) - std::abs(px)) * (py < 0 ? scalar(-1) : scalar(1));
+        px = fx;
+        py = fy;
+    }
+
+    return normalize(vector3{px, py, pz});
+}
+
+}
+
+#endif // EDYN_MATH_QUANTIZATION_HPP
@@ -133,11 +133,11 @@ public:
     void export_dirty_steady(const entt::registry &registry,
                              entt::entity entity, const dirty &dirty,
                              registry_snapshot &snap, entt::entity dest_client_entity) override {
-        for (auto id : dirty.updated_indexes) {
+        dirty.each_updated_id([&] (entt::id_type id) {
             if ((*m_should_export_steady_by_type_id)(registry, entity, id, dest_client_entity)) {
                 export_by_type_id(registry, entity, id, snap);
             }
-        }
+        });
     }
 
     bool contains_transient(const entt::registry &registry, entt::entity entity) const override {
@@ -8,6 +8,8 @@
 #include <entt/entity/entity.hpp>
 #include "edyn/config/config.h"
 #include "edyn/util/entity_pair.hpp"
+#include "edyn/parallel/job_dispatcher.hpp"
+#include "edyn/parallel/parallel_for.hpp"
 
 namespace edyn {
 
@@ -26,12 +28,41 @@ public:
         std::vector<entt::entity> edges;
     };
 
+    using connected_components_t = std::vector<connected_component>;
+
+    /**
+     * @brief Outcome of `check_disconnection`.
+     */
+    enum class disconnection_result {
+        // All pairs of nodes joined by removed edges are still connected.
+        connected,
+        // At least one pair of nodes is not connected anymore.
+        disconnected,
+        // The search was stopped after visiting the maximum number of nodes,
+        // thus connectivity has to be determined otherwise.
+        undetermined
+    };
+
+    // Default maximum number of nodes visited by `check_disconnection`.
+    constexpr static size_t default_max_disconnection_visits = 4096;
+
 private:
     struct node {
         entt::entity entity;
         bool non_connecting;
         index_type adjacency_index;
         index_type next;
+        // Incremented when the node is removed, which tells apart nodes
+        // which reuse the same index.
+        uint32_t generation;
+    };
+
+    // Pair of connecting nodes which were joined by a removed edge.
+    struct disconnection_candidate {
+        index_type node_index0;
+        index_type node_index1;
+        uint32_t generation0;
+        uint32_t generation1;
     };
 
     struct edge {
@@ -47,6 +78,23 @@ private:
         index_type next;
     };
 
+    // Adjacency in compressed sparse row form. Holds the index of the first
+    // edge of the linked list of edges between the two nodes.
+    struct compact_adjacency {
+        index_type node_index;
+        index_type edge_index;
+    };
+
+    /**
+     * @brief Visits all adjacencies of a node using the compressed sparse row
+     * form if available.
+     * @param func Function with signature `void(index_type neighbor_index,
+     * index_type edge_index)` where `edge_index` is the first edge between
+     * the two nodes.
+     */
+    template<typename Func>
+    void each_adjacency(index_type node_index, Func func) const;
+
     void insert_adjacency(index_type node_index0, index_type node_index1, index_type edge_index);
     index_type insert_adjacency_one_way(index_type node_index0, index_type node_index1, index_type edge_index);
     index_type create_adjacency(index_type destination_node_index, index_type edge_index);
@@ -56,6 +104,31 @@ private:
     double efficiency() const;
     void optimize();
 
+    disconnection_result is_connected(index_type node_index0, index_type node_index1, size_t &budget);
+    connected_components_t connected_components_parallel();
+
+    /**
+     * @brief Calculates the root of the connected component of every node
+     * using a concurrent union-find over all edges joining two connecting
+     * nodes. Roots are the lowest node index in their component.
+     * @param reachable If not null, only edges where both nodes are marked
+     * as reachable in this array are considered.
+     * @param roots Receives the root of each node.
+     */
+    void find_roots_parallel(const std::vector<uint8_t> *reachable,
+                             std::vector<index_type> &roots) const;
+
+    // Minimum number of start nodes for `reach` to calculate the reachable
+    // connected components in parallel.
+    constexpr static size_t parallel_reach_min_nodes = 4096;
+
+    template<typename It, typename VisitNodeFunc,
+             typename VisitEdgeFunc, typename ShouldFunc,
+             typename ComponentFunc>
+    void reach_parallel(It first, It last, VisitNodeFunc visitNodeFunc,
+                        VisitEdgeFunc visitEdgeFunc, ShouldFunc shouldFunc,
+                        ComponentFunc componentFunc);
+
 public:
     index_type insert_node(entt::entity entity, bool non_connecting = false);
     void remove_node(index_type node_index);
@@ -70,12 +143,61 @@ public:
 
     bool is_connecting_node(index_type node_index) const;
 
+    /**
+     * @brief Number of nodes in this graph.
+     */
+    size_t num_nodes() const {
+        return m_node_count;
+    }
+
+    /**
+     * @brief Number of edges in this graph.
+     */
+    size_t num_edges() const {
+        return m_edge_count;
+    }
+
     /**
      * @brief Calculate whether this graph contains a single connected component.
      * @return Whether this graph is a single connected component.
      */
     bool is_single_connected_component();
 
+    /**
+     * @brief Rebuilds the adjacency lists in compressed sparse row form, i.e.
+     * the neighbors of all nodes are laid out contiguously in node order,
+     * which makes traversals considerably faster on large graphs. Should be
+     * called after bulk changes. The compact form is discarded on the next
+     * change, falling back to the linked adjacency lists.
+     */
+    void compact();
+
+    /**
+     * @brief Enables recording the nodes joined by removed edges, which is
+     * required by `check_disconnection`.
+     * @param track Whether to record removals.
+     */
+    void set_track_disconnections(bool track);
+
+    /**
+     * @brief Checks whether edges and nodes removed since the last call have
+     * split a connected component in two. Only the nodes that were joined by
+     * the removed edges are considered. A breadth-first search is run from
+     * both nodes of each pair, always expanding the smaller frontier, until
+     * the searches meet or one side runs out of nodes. If the pair was
+     * disconnected, the cost is proportional to the smaller of the two
+     * components. If it is still connected, the searches stop once they meet,
+     * which is quick when a short path remains but can take most of the
+     * component otherwise. Thus, the search is stopped once `max_visits`
+     * nodes have been visited in total.
+     * @param max_visits Maximum number of nodes to visit.
+     * @return Whether the removals have disconnected the graph, or
+     * `disconnection_result::undetermined` if the search was stopped early, in
+     * which case the whole graph should be checked instead, e.g. via
+     * `is_single_connected_component`. Candidates are discarded either way.
+     */
+    disconnection_result check_disconnection(size_t max_visits = default_max_disconnection_visits);
+
     /**
      * @brief Visit neighboring nodes of a node.
      * @tparam Func Visitor function type.
@@ -120,6 +242,12 @@ public:
      * @param shouldFunc Function that returns whether to proceed visitng node.
      * @param componentFunc Function called for each connected component that is
      * formed.
+     * @remark If a large number of nodes is provided, the connected components
+     * are found in parallel and `shouldFunc` is called for all nodes in the
+     * graph from multiple threads, thus it must not have side effects. The
+     * other functions are still called from the calling thread, one connected
+     * component at a time in the order of the provided nodes, though nodes
+     * are visited in order of index within each component in that case.
      */
     template<typename It, typename VisitNodeFunc,
              typename VisitEdgeFunc, typename ShouldFunc,
@@ -128,12 +256,11 @@ public:
                VisitEdgeFunc visitEdgeFunc, ShouldFunc shouldFunc,
                ComponentFunc componentFunc);
 
-    using connected_components_t = std::vector<connected_component>;
-
     /**
      * Calculates and returns all connected components of this graph.
      * Non-connecting nodes are not walked through and can be present in
-     * multiple connected components.
+     * multiple connected components. Large graphs are processed in parallel
+     * using a concurrent union-find.
      * @return The connected components.
      */
     connected_components_t connected_components();
@@ -158,6 +285,25 @@ private:
     std::vector<bool> m_visited;
     std::vector<bool> m_visited_edges;
 
+    // Pairs of connecting nodes which were joined by removed edges and might
+    // have become disconnected.
+    std::vector<disconnection_candidate> m_disconnection_candidates;
+    bool m_track_disconnections {false};
+    // Side of the bidirectional search from which a node was reached, or zero.
+    std::vector<uint8_t> m_search_side;
+    // Scratch storage for the bidirectional search, kept to avoid allocating
+    // in every call. Current and next frontier of each side and nodes whose
+    // side has to be reset at the end.
+    std::vector<index_type> m_search_frontier[2];
+    std::vector<index_type> m_search_next_frontier;
+    std::vector<index_type> m_search_touched;
+
+    // Adjacencies in compressed sparse row form. The adjacencies of the node
+    // at index `i` are in the range `[m_compact_offsets[i], m_compact_offsets[i + 1])`.
+    std::vector<index_type> m_compact_offsets;
+    std::vector<compact_adjacency> m_compact_adjacencies;
+    bool m_compact {false};
+
     size_t m_node_count;
     size_t m_edge_count;
 
@@ -166,6 +312,26 @@ private:
     size_t m_adjacencies_free_list {null_index};
 };
 
+template<typename Func>
+void entity_graph::each_adjacency(index_type node_index, Func func) const {
+    if (m_compact) {
+        auto end = m_compact_offsets[node_index + 1];
+
+        for (auto i = m_compact_offsets[node_index]; i < end; ++i) {
+            auto &adj = m_compact_adjacencies[i];
+            func(adj.node_index, adj.edge_index);
+        }
+    } else {
+        auto adj_index = m_nodes[node_index].adjacency_index;
+
+        while (adj_index != null_index) {
+            auto &adj = m_adjacencies[adj_index];
+            func(adj.node_index, adj.edge_index);
+            adj_index = adj.next;
+        }
+    }
+}
+
 template<typename Func>
 void entity_graph::visit_neighbors(index_type node_index, Func func) const {
     EDYN_ASSERT(node_index < m_nodes.size());
@@ -235,6 +401,17 @@ void entity_graph::reach(It first, It last, VisitNodeFunc visitNodeFunc,
                          ComponentFunc componentFunc) {
     EDYN_ASSERT(std::distance(first, last) > 0);
 
+    // The parallel search goes over the entire graph, thus it is only worth
+    // it if a significant part of the graph is about to be reached.
+    auto num_start_nodes = static_cast<size_t>(std::distance(first, last));
+
+    if (num_start_nodes >= parallel_reach_min_nodes &&
+        num_start_nodes * 4 >= m_node_count &&
+        job_dispatcher::global().running()) {
+        reach_parallel(first, last, visitNodeFunc, visitEdgeFunc, shouldFunc, componentFunc);
+        return;
+    }
+
     m_visited.assign(m_nodes.size(), false);
     m_visited_edges.assign(m_edges.size(), false);
 
@@ -274,12 +451,7 @@ void entity_graph::reach(It first, It last, VisitNodeFunc visitNodeFunc,
             }
 
             // Visit all edges in all adjacencies.
-            auto adj_index = node.adjacency_index;
-
-            while (adj_index != null_index) {
-                auto &adj = m_adjacencies[adj_index];
-                auto edge_index = adj.edge_index;
-
+            each_adjacency(node_index, [&] (index_type neighbor_index, index_type edge_index) {
                 while (edge_index != null_index) {
                     auto &edge = m_edges[edge_index];
 
@@ -293,16 +465,12 @@ void entity_graph::reach(It first, It last, VisitNodeFunc visitNodeFunc,
                 }
 
                 // Perhaps visit neighboring node and its edges next.
-                auto neighbor_index = adj.node_index;
-
                 if (!m_visited[neighbor_index] && shouldFunc(neighbor_index)) {
                     to_visit.emplace_back(neighbor_index);
                     // Set as visited to avoid adding it to `to_visit` more than once.
                     m_visited[neighbor_index] = true;
                 }
-
-                adj_index = adj.next;
-            }
+            });
         }
 
         // Finished one connected component.
@@ -320,6 +488,99 @@ void entity_graph::reach(It first, It last, VisitNodeFunc visitNodeFunc,
     }
 }
 
+template<typename It, typename VisitNodeFunc,
+         typename VisitEdgeFunc, typename ShouldFunc,
+         typename ComponentFunc>
+void entity_graph::reach_parallel(It first, It last, VisitNodeFunc visitNodeFunc,
+                                  VisitEdgeFunc visitEdgeFunc, ShouldFunc shouldFunc,
+                                  ComponentFunc componentFunc) {
+    // Find out which nodes can be visited and the connected components formed
+    // by them in parallel.
+    auto reachable = std::vector<uint8_t>(m_nodes.size(), 0);
+
+    parallel_for(size_t{0}, m_nodes.size(), [&] (size_t node_index) {
+        if (m_nodes[node_index].entity != entt::null && shouldFunc(node_index)) {
+            reachable[node_index] = 1;
+        }
+    });
+
+    auto roots = std::vector<index_type>{};
+    find_roots_parallel(&reachable, roots);
+
+    // Group reachable connecting nodes by root, in order of node index.
+    auto offsets = std::vector<index_type>(m_nodes.size() + 1, 0);
+
+    for (size_t node_index = 0; node_index < m_nodes.size(); ++node_index) {
+        if (reachable[node_index] && !m_nodes[node_index].non_connecting) {
+            ++offsets[roots[node_index] + 1];
+        }
+    }
+
+    for (size_t i = 1; i < offsets.size(); ++i) {
+        offsets[i] += offsets[i - 1];
+    }
+
+    auto members = std::vector<index_type>(offsets.back());
+    auto cursor = std::vector<index_type>(offsets.begin(), offsets.end() - 1);
+
+    for (size_t node_index = 0; node_index < m_nodes.size(); ++node_index) {
+        if (reachable[node_index] && !m_nodes[node_index].non_connecting) {
+            members[cursor[roots[node_index]]++] = node_index;
+        }
+    }
+
+    // Invoke the callbacks sequentially, one component at a time. Reachable
+    // non-connecting nodes are visited once in each component they touch.
+    m_visited.assign(m_nodes.size(), false);
+    m_visited_edges.assign(m_edges.size(), false);
+    auto component_stamp = std::vector<index_type>(m_nodes.size(), null_index);
+
+    for (auto it = first; it != last; ++it) {
+        auto start_node_index = *it;
+        EDYN_ASSERT(!m_nodes[start_node_index].non_connecting);
+
+        if (!reachable[start_node_index]) {
+            continue;
+        }
+
+        auto root = roots[start_node_index];
+
+        if (m_visited[root]) {
+            continue;
+        }
+
+        m_visited[root] = true;
+
+        for (auto i = offsets[root]; i < offsets[root + 1]; ++i) {
+            auto node_index = members[i];
+            visitNodeFunc(m_nodes[node_index].entity);
+
+            each_adjacency(node_index, [&] (index_type neighbor_index, index_type edge_index) {
+                while (edge_index != null_index) {
+                    auto &edge = m_edges[edge_index];
+
+                    if (!m_visited_edges[edge_index]) {
+                        EDYN_ASSERT(edge.entity != entt::null);
+                        visitEdgeFunc(edge.entity);
+                        m_visited_edges[edge_index] = true;
+                    }
+
+                    edge_index = edge.next;
+                }
+
+                if (m_nodes[neighbor_index].non_connecting &&
+                    reachable[neighbor_index] &&
+                    component_stamp[neighbor_index] != root) {
+                    component_stamp[neighbor_index] = root;
+                    visitNodeFunc(m_nodes[neighbor_index].entity);
+                }
+            });
+        }
+
+        componentFunc();
+    }
+}
+
 template<typename Func>
 void entity_graph::traverse_connecting_nodes(index_type start_node_index, Func func) {
     m_visited.assign(m_nodes.size(), false);
@@ -343,21 +604,14 @@ void entity_graph::traverse_connecting_nodes(index_type start_node_index, Func f
         func(node_index);
 
         // Add neighbors to be visited.
-        auto adj_index = node.adjacency_index;
-
-        while (adj_index != null_index) {
-            auto &adj = m_adjacencies[adj_index];
-            auto neighbor_index = adj.node_index;
-
+        each_adjacency(node_index, [&] (index_type neighbor_index, index_type) {
             if (!m_visited[neighbor_index]) {
                 // Insert to beginning for a breadth-first traversal.
                 to_visit.insert(to_visit.begin(), neighbor_index);
                 // Set as visited to avoid adding it to `to_visit` more than once.
                 m_visited[neighbor_index] = true;
             }
-
-            adj_index = adj.next;
-        }
+        });
     }
 }
 
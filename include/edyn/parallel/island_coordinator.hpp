@@ -58,7 +58,7 @@ public:
 
     void on_destroy_island_resident(entt::registry &, entt::entity);
     void on_destroy_multi_island_resident(entt::registry &, entt::entity);
-    void on_island_reg_ops(entt::entity, const msg::island_reg_ops &);
+    void on_island_reg_ops(entt::entity, msg::island_reg_ops &);
     void on_split_island(entt::entity, const msg::split_island &);
 
     void on_destroy_contact_manifold(entt::registry &, entt::entity);
@@ -4,6 +4,7 @@
 #include <mutex>
 #include <memory>
 #include <atomic>
+#include <cstdint>
 #include <optional>
 #include <entt/entity/fwd.hpp>
 #include <condition_variable>
@@ -61,6 +62,8 @@ class island_worker final {
     void go_to_sleep();
     bool should_split();
     void sync();
+    void sync_aabbs();
+    void sync_manifolds();
     void sync_dirty();
     void update();
 
@@ -84,7 +87,7 @@ public:
     void on_construct_compound_shape(entt::registry &, entt::entity);
     void on_destroy_rotated_mesh_list(entt::registry &, entt::entity);
 
-    void on_island_reg_ops(const msg::island_reg_ops &msg);
+    void on_island_reg_ops(msg::island_reg_ops &msg);
     void on_set_paused(const msg::set_paused &msg);
     void on_step_simulation(const msg::step_simulation &msg);
     void on_set_settings(const msg::set_settings &msg);
@@ -131,6 +134,14 @@ private:
 
     std::atomic<int> m_reschedule_counter {0};
 
+    // Index of the worker thread where this job last ran. It's preferred
+    // when rescheduling to keep the registry warm in that core's cache.
+    std::atomic<size_t> m_worker_index {SIZE_MAX};
+
+    // Estimated cost of a step, used as the job priority so that larger
+    // islands start running before smaller ones.
+    std::atomic<uint32_t> m_step_cost {0};
+
     std::atomic<bool> m_terminating {false};
     std::atomic<bool> m_terminated {false};
     std::mutex m_terminate_mutex;
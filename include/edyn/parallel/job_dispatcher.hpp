@@ -3,9 +3,12 @@
 
 #include <map>
 #include <vector>
+#include <cstdint>
 #include <thread>
 #include <mutex>
+#include <atomic>
 #include <shared_mutex>
+#include <condition_variable>
 #include "edyn/parallel/worker.hpp"
 #include "edyn/parallel/job_scheduler.hpp"
 
@@ -16,31 +19,85 @@ class job_queue;
 class job_queue_scheduler;
 
 /**
- * Manages a set of worker threads and dispatches jobs to them.
+ * Manages a set of worker threads and dispatches jobs to them. Each worker has
+ * a lock-free deque of jobs. Jobs scheduled from a worker thread are inserted
+ * in its own deque, otherwise they're distributed among the workers. Idle
+ * workers steal jobs from other workers.
  */
 class job_dispatcher {
 public:
+    static constexpr size_t invalid_worker_index = SIZE_MAX;
+
+    // A job is only scheduled in its preferred worker if it has less than
+    // this number of jobs pending. Otherwise it's considered overloaded.
+    static constexpr size_t max_affine_pending_jobs = 4;
+
     static job_dispatcher &global();
 
     job_dispatcher();
     ~job_dispatcher();
 
     void start();
-    void start(size_t num_worker_threads);
 
+    /**
+     * Starts the worker threads.
+     * @param num_worker_threads Number of worker threads to spawn.
+     * @param pin_to_cores Whether to pin each worker thread to a logical core.
+     */
+    void start(size_t num_worker_threads, bool pin_to_cores = false);
+
+    /**
+     * Stops the scheduler and the worker threads. Jobs that are pending in
+     * the workers are run before the threads are joined, as well as any jobs
+     * they schedule in turn, thus jobs must not keep rescheduling themselves
+     * indefinitely. Jobs scheduled to run after a delay which haven't become
+     * due yet are discarded.
+     */
     void stop();
 
     bool running() const;
 
     /**
-     * Schedules a job to run asynchronously in a worker thread.
+     * Schedules a job to run asynchronously in a worker thread. If called from
+     * a worker thread, the job is inserted into its local deque.
      */
     void async(const job &);
 
+    /**
+     * Schedules a batch of jobs to run asynchronously in worker threads. The
+     * jobs are distributed among the workers and sleeping workers are woken
+     * up once for the entire batch.
+     */
+    void async(const job *jobs, size_t count);
+
+    /**
+     * Schedules a job to run asynchronously preferably in the given worker,
+     * which is usually the worker where it last ran so it finds its data
+     * still in that core's cache. If that worker has too many pending jobs,
+     * it's scheduled as in `async(const job &)`.
+     * @param j The job.
+     * @param worker_index Index of preferred worker, or `invalid_worker_index`
+     * for no preference.
+     * @param priority Jobs with higher priority are taken first from the
+     * inbox of a worker. Prioritized jobs scheduled from a worker thread go
+     * into its inbox instead of its local deque.
+     */
+    void async_with_affinity(const job &j, size_t worker_index, uint32_t priority = 0);
+
+    /**
+     * Batch version of `async_with_affinity`.
+     */
+    void async_with_affinity(const job *jobs, const size_t *worker_indices,
+                             const uint32_t *priorities, size_t count);
+
     /**
      * Schedules a job to run asynchronously in a worker thread after a delay.
+     * @param worker_index Index of preferred worker, as in
+     * `async_with_affinity`.
+     * @param priority Job priority, as in `async_with_affinity`.
      */
-    void async_after(double delta_time, const job &);
+    void async_after(double delta_time, const job &, size_t worker_index = invalid_worker_index,
+                     uint32_t priority = 0);
 
     /**
      * Schedules a job to run in a specific thread.
@@ -79,9 +136,64 @@ public:
      */
     size_t num_workers() const;
 
+    /**
+     * Whether the current thread is a worker thread of this dispatcher.
+     */
+    bool is_current_thread_worker() const;
+
+    /**
+     * Index of the worker running in the current thread, or
+     * `invalid_worker_index` if it's not a worker thread of this dispatcher.
+     */
+    size_t current_worker_index() const;
+
+    /**
+     * Marks the current position of the local deque of the current worker.
+     * Jobs scheduled from this thread afterwards are above the mark. Must be
+     * called from a worker thread of this dispatcher.
+     */
+    int64_t local_job_mark() const;
+
+    /**
+     * Runs the most recent job scheduled from the current worker thread if
+     * it was scheduled after the given mark and hasn't been taken by another
+     * worker. Used to run the jobs a thread depends on while waiting for
+     * them, without running unrelated jobs. Must be called from a worker
+     * thread of this dispatcher.
+     * @param mark A value previously returned by `local_job_mark()`.
+     * @return Whether a job was executed.
+     */
+    bool run_local_job_after(int64_t mark);
+
+    friend class worker;
+
 private:
+    worker &get_worker(size_t index) {
+        return *m_workers[index];
+    }
+
+    bool is_running() const {
+        return m_running.load(std::memory_order_relaxed);
+    }
+
+    // Inserts a job in a worker without notifying sleeping workers.
+    void push_job(const job &, size_t worker_index, uint32_t priority);
+
+    // Wakes up sleeping workers after jobs are scheduled.
+    void notify_job_available(size_t num_jobs = 1);
+
+    // Puts the calling worker to sleep until a job is scheduled.
+    void park();
+
     std::vector<std::unique_ptr<std::thread>> m_threads;
-    std::map<std::thread::id, std::unique_ptr<worker>> m_workers;
+    std::vector<std::unique_ptr<worker>> m_workers;
+    std::atomic<bool> m_running {false};
+
+    // Parking of idle workers.
+    std::mutex m_park_mutex;
+    std::condition_variable m_park_cv;
+    std::atomic<size_t> m_num_parked {0};
+    std::atomic<uint64_t> m_epoch {0};
 
     // Job queue for regular threads.
     std::vector<job_queue *> m_queues;
@@ -93,7 +205,7 @@ private:
 
     job_scheduler m_scheduler;
 
-    std::atomic<size_t> m_start;
+    std::atomic<size_t> m_start {0};
 };
 
 }
@@ -6,6 +6,7 @@
 #include <memory>
 #include <vector>
 #include <atomic>
+#include <cstdint>
 #include <condition_variable>
 #include "edyn/parallel/job.hpp"
 
@@ -14,12 +15,31 @@ namespace edyn {
 class job_dispatcher;
 
 /**
- * Schedules jobs for execution at a later time in a `job_dispatcher`.
+ * Schedules jobs for execution at a later time in a `job_dispatcher`. Jobs are
+ * kept in a binary min-heap ordered by timestamp, thus scheduling a job takes
+ * logarithmic time. All expired jobs are dispatched in one batch, in order of
+ * decreasing priority.
  */
 class job_scheduler final {
     struct timed_job {
         job m_job;
         double m_timestamp;
+        // Preserves insertion order for jobs with the same timestamp.
+        uint64_t m_sequence;
+        // Preferred worker.
+        size_t m_worker_index;
+        uint32_t m_priority;
+    };
+
+    // Heap comparison which puts the earliest job at the front.
+    struct timed_job_later {
+        bool operator()(const timed_job &lhs, const timed_job &rhs) const {
+            if (lhs.m_timestamp != rhs.m_timestamp) {
+                return lhs.m_timestamp > rhs.m_timestamp;
+            }
+
+            return lhs.m_sequence > rhs.m_sequence;
+        }
     };
 
     void update();
@@ -31,12 +51,17 @@ public:
     void start();
     void stop();
 
-    void schedule_after(const job &, double delta_time);
+    void schedule_after(const job &, double delta_time, size_t worker_index, uint32_t priority);
 
 private:
     job_dispatcher *m_dispatcher;
     std::unique_ptr<std::thread> m_thread;
     std::vector<timed_job> m_jobs;
+    std::vector<timed_job> m_expired;
+    std::vector<job> m_expired_jobs;
+    std::vector<size_t> m_expired_worker_indices;
+    std::vector<uint32_t> m_expired_priorities;
+    uint64_t m_sequence {0};
     std::mutex m_mutex;
     std::condition_variable m_cv;
     std::atomic_bool m_running;
@@ -2,28 +2,58 @@
 #define EDYN_PARALLEL_MESSAGE_QUEUE_HPP
 
 #include <array>
+#include <atomic>
+#include <memory>
 #include <cstdint>
-#include <mutex>
-#include <shared_mutex>
-#include <queue>
-#include <cstdint>
-#include <algorithm>
+#include <stdexcept>
 #include <entt/entity/fwd.hpp>
 #include <entt/signal/fwd.hpp>
-#include <entt/core/type_info.hpp>
+#include <entt/signal/sigh.hpp>
+#include "edyn/config/config.h"
+#include "edyn/parallel/spsc_queue.hpp"
 
 namespace edyn {
 
+namespace detail {
+    // Maximum number of distinct message types that can go through a message
+    // queue.
+    constexpr size_t max_message_types = 64;
+
+    inline std::atomic<size_t> message_type_counter {0};
+
+    /**
+     * @brief Sequential index of a message type, which is used as the slot of
+     * the pool of this type in a message queue. It's assigned on first use
+     * and is the same for all queues.
+     */
+    template<typename Message>
+    size_t message_type_index() {
+        static const size_t index = message_type_counter.fetch_add(1, std::memory_order_relaxed);
+
+        // Checked in all builds since a pool beyond this limit would be
+        // out of bounds.
+        if (index >= max_message_types) {
+            throw std::length_error("edyn::message_queue: too many message types");
+        }
+
+        return index;
+    }
+}
+
 /**
- * @brief A message queue intended for single-producer single-consumer usage
- * between two threads.
+ * @brief A message queue for single-producer single-consumer usage between
+ * two threads. Each message type has its own wait-free ring of messages which
+ * sits at a fixed slot, thus pushing and draining messages doesn't require
+ * any locks.
+ * @remark Pools are not protected by a mutex, thus messages must be sent from
+ * a single thread only, even if the `message_queue_input` is copied. Sending
+ * from multiple threads requires external synchronization.
  */
 class message_queue {
     // Based on `entt::dispatcher`.
     struct basic_pool {
         virtual ~basic_pool() = default;
         virtual void publish() = 0;
-        virtual entt::id_type type_id() const = 0;
     };
 
     template<typename Message>
@@ -34,47 +64,53 @@ class message_queue {
         template<typename... Args>
         void push(Args &&... args) {
             // Expected to be called from the producer thread only.
-            auto lock = std::lock_guard(m_mutex);
             if constexpr(std::is_aggregate_v<Message>) {
-                m_messages.push_back(Message{std::forward<Args>(args)...});
+                m_messages.emplace(Message{std::forward<Args>(args)...});
             } else {
-                m_messages.emplace_back(std::forward<Args>(args)...);
+                m_messages.emplace(std::forward<Args>(args)...);
             }
         }
 
         void publish() override {
             // Expected to be called from the consumer thread only.
-            auto lock = std::unique_lock(m_mutex);
-            auto messages = std::move(m_messages);
-            lock.unlock();
-
-            for (auto &msg : messages) {
+            m_messages.consume_all([&] (Message &msg) {
                 m_signal.publish(msg);
-            }
+            });
         }
 
         sink_type sink() {
             return entt::sink{m_signal};
         }
 
-        entt::id_type type_id() const ENTT_NOEXCEPT override {
-            return entt::type_index<Message>::value();
-        }
-
     private:
-        std::mutex m_mutex;
         signal_type m_signal{};
-        std::vector<Message> m_messages;
+        spsc_queue<Message> m_messages;
     };
 
     template<typename Message>
     pool_handler<Message> & assure() {
         static_assert(std::is_same_v<Message, std::decay_t<Message>>, "Invalid event type");
 
-        auto it = std::find_if(m_pools.begin(), m_pools.end(),
-            [id = entt::type_index<Message>::value()](const auto &cpool) { return id == cpool->type_id(); });
-        return static_cast<pool_handler<Message> &>(it == m_pools.cend() ?
-            *m_pools.emplace_back(new pool_handler<Message>{}) : **it);
+        auto index = detail::message_type_index<Message>();
+        auto *pool = m_pools[index].load(std::memory_order_acquire);
+
+        if (pool == nullptr) {
+            // The pool can be created by the producer when sending the first
+            // message or by the consumer when connecting to its sink.
+            auto *new_pool = new pool_handler<Message>{};
+
+            if (m_pools[index].compare_exchange_strong(pool, new_pool, std::memory_order_acq_rel)) {
+                pool = new_pool;
+            } else {
+                delete new_pool;
+            }
+
+            auto end = m_pools_end.load(std::memory_order_relaxed);
+            while (end < index + 1 &&
+                   !m_pools_end.compare_exchange_weak(end, index + 1, std::memory_order_release));
+        }
+
+        return static_cast<pool_handler<Message> &>(*pool);
     }
 
     template<typename Message>
@@ -93,9 +129,10 @@ class message_queue {
 
     void update() const {
         // Expected to be called from the consumer thread only.
-        auto lock = std::shared_lock(m_mutex);
-        for (auto &pool : m_pools) {
-            if (pool) {
+        auto end = m_pools_end.load(std::memory_order_acquire);
+
+        for (size_t i = 0; i < end; ++i) {
+            if (auto *pool = m_pools[i].load(std::memory_order_acquire)) {
                 pool->publish();
             }
         }
@@ -104,8 +141,21 @@ class message_queue {
     friend class message_queue_input;
     friend class message_queue_output;
 
-    mutable std::shared_mutex m_mutex;
-    std::vector<std::unique_ptr<basic_pool>> m_pools;
+public:
+    message_queue() = default;
+    message_queue(const message_queue &) = delete;
+    message_queue & operator=(const message_queue &) = delete;
+
+    ~message_queue() {
+        for (auto &pool : m_pools) {
+            delete pool.load(std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::array<std::atomic<basic_pool *>, detail::max_message_types> m_pools {};
+    // One past the highest slot in use.
+    std::atomic<size_t> m_pools_end {0};
 };
 
 class message_queue_input {
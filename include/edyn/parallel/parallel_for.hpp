@@ -1,7 +1,9 @@
 #ifndef EDYN_PARALLEL_PARALLEL_FOR_HPP
 #define EDYN_PARALLEL_PARALLEL_FOR_HPP
 
+#include <mutex>
 #include <atomic>
+#include <thread>
 #include <condition_variable>
 #include "edyn/config/config.h"
 #include "edyn/parallel/job.hpp"
@@ -63,7 +65,32 @@ struct parallel_for_context {
         }
     }
 
-    void wait() {
+    bool is_done() {
+        std::lock_guard lock(mutex);
+        return done;
+    }
+
+    /**
+     * Waits for all jobs to finish.
+     * @param local_job_mark Mark of the local deque taken before the jobs were
+     * dispatched if the current thread is a worker.
+     */
+    void wait(job_dispatcher &dispatcher, int64_t local_job_mark) {
+        // Worker threads run the jobs dispatched by this loop which haven't
+        // been taken by other workers instead of blocking, which makes it
+        // possible to nest parallel for loops without starving the workers.
+        // Only jobs scheduled by this thread after the loop started are run,
+        // thus unrelated jobs are never pulled into the wait.
+        if (dispatcher.is_current_thread_worker()) {
+            while (!is_done()) {
+                if (!dispatcher.run_local_job_after(local_job_mark)) {
+                    std::this_thread::yield();
+                }
+            }
+
+            return;
+        }
+
         std::unique_lock lock(mutex);
         cv.wait(lock, [&] { return done; });
     }
@@ -143,6 +170,11 @@ void parallel_for(job_dispatcher &dispatcher, IndexType first, IndexType last, I
     auto ctx_ptr = reinterpret_cast<intptr_t>(&context);
     archive(ctx_ptr);
 
+    // Jobs dispatched from a worker thread go into its local deque above
+    // this mark.
+    auto local_job_mark = dispatcher.is_current_thread_worker() ?
+        dispatcher.local_job_mark() : int64_t{0};
+
     // Dispatch background jobs.
     for (size_t i = 0; i < num_jobs; ++i) {
         dispatcher.async(child_job);
@@ -152,7 +184,7 @@ void parallel_for(job_dispatcher &dispatcher, IndexType first, IndexType last, I
     detail::run_parallel_for(context);
 
     // Wait all background jobs to finish.
-    context.wait();
+    context.wait(dispatcher, local_job_mark);
 }
 
 /**
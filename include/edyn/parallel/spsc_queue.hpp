@@ -0,0 +1,141 @@
+#ifndef EDYN_PARALLEL_SPSC_QUEUE_HPP
+#define EDYN_PARALLEL_SPSC_QUEUE_HPP
+
+#include <new>
+#include <array>
+#include <atomic>
+#include <utility>
+#include <cstddef>
+#include <type_traits>
+
+namespace edyn {
+
+/**
+ * @brief An unbounded wait-free queue for a single producer thread and a single
+ * consumer thread. Elements are stored in linked blocks of fixed size. The
+ * producer only allocates a block when the current one is full and the
+ * consumer hands exhausted blocks back to the producer for reuse, thus no
+ * allocations happen in the steady state.
+ * @tparam T Element type.
+ * @tparam BlockSize Number of elements per block.
+ */
+template<typename T, size_t BlockSize = 64>
+class spsc_queue {
+    struct block {
+        std::array<std::aligned_storage_t<sizeof(T), alignof(T)>, BlockSize> slots;
+        // Number of elements written by the producer.
+        std::atomic<size_t> count {0};
+        // Next block, assigned by the producer once this one is full.
+        std::atomic<block *> next {nullptr};
+        // Number of elements read by the consumer.
+        size_t read {0};
+
+        T *get(size_t index) {
+            return std::launder(reinterpret_cast<T *>(&slots[index]));
+        }
+    };
+
+public:
+    spsc_queue()
+        : m_head(new block)
+        , m_tail(m_head)
+    {}
+
+    spsc_queue(const spsc_queue &) = delete;
+    spsc_queue & operator=(const spsc_queue &) = delete;
+
+    ~spsc_queue() {
+        consume_all([] (T &) {});
+        delete m_head;
+        delete m_spare.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Constructs an element at the end of the queue. Must only be
+     * called from the producer thread.
+     */
+    template<typename... Args>
+    void emplace(Args &&... args) {
+        auto count = m_tail->count.load(std::memory_order_relaxed);
+
+        if (count == BlockSize) {
+            auto *next = m_spare.exchange(nullptr, std::memory_order_acquire);
+
+            if (next == nullptr) {
+                next = new block;
+            }
+
+            m_tail->next.store(next, std::memory_order_release);
+            m_tail = next;
+            count = 0;
+        }
+
+        new (&m_tail->slots[count]) T(std::forward<Args>(args)...);
+        m_tail->count.store(count + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Invokes `func` for every element available and removes them
+     * from the queue. Must only be called from the consumer thread.
+     * @return Number of elements consumed.
+     */
+    template<typename Func>
+    size_t consume_all(Func func) {
+        size_t num_consumed = 0;
+
+        while (true) {
+            auto count = m_head->count.load(std::memory_order_acquire);
+
+            for (; m_head->read < count; ++m_head->read) {
+                auto *element = m_head->get(m_head->read);
+                func(*element);
+                element->~T();
+                ++num_consumed;
+            }
+
+            if (m_head->read < BlockSize) {
+                break;
+            }
+
+            auto *next = m_head->next.load(std::memory_order_acquire);
+
+            if (next == nullptr) {
+                break;
+            }
+
+            // The producer does not access this block anymore. Recycle it.
+            auto *exhausted = m_head;
+            m_head = next;
+            exhausted->count.store(0, std::memory_order_relaxed);
+            exhausted->next.store(nullptr, std::memory_order_relaxed);
+            exhausted->read = 0;
+            delete m_spare.exchange(exhausted, std::memory_order_release);
+        }
+
+        return num_consumed;
+    }
+
+    /**
+     * @brief Whether there are no elements available. Must only be called from
+     * the consumer thread.
+     */
+    bool empty() const {
+        if (m_head->read < m_head->count.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        return m_head->read < BlockSize || m_head->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    // Block being read. Only accessed by the consumer.
+    alignas(64) block *m_head;
+    // Block being written. Only accessed by the producer.
+    alignas(64) block *m_tail;
+    // An unused block which can be reused by the producer.
+    std::atomic<block *> m_spare {nullptr};
+};
+
+}
+
+#endif // EDYN_PARALLEL_SPSC_QUEUE_HPP
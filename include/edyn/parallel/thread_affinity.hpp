@@ -0,0 +1,20 @@
+#ifndef EDYN_PARALLEL_THREAD_AFFINITY_HPP
+#define EDYN_PARALLEL_THREAD_AFFINITY_HPP
+
+#include <thread>
+#include <cstddef>
+
+namespace edyn {
+
+/**
+ * @brief Restricts a thread to run on a single logical core.
+ * @param thread The thread to be pinned.
+ * @param core_index Index of the logical core. Wraps around if greater than
+ * or equal to the number of cores.
+ * @return Whether the affinity was set. It's not supported on all platforms.
+ */
+bool set_thread_affinity(std::thread &thread, size_t core_index);
+
+}
+
+#endif // EDYN_PARALLEL_THREAD_AFFINITY_HPP
@@ -0,0 +1,96 @@
+#ifndef EDYN_PARALLEL_WORK_STEALING_DEQUE_HPP
+#define EDYN_PARALLEL_WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include "edyn/parallel/job.hpp"
+
+namespace edyn {
+
+/**
+ * Lock-free Chase-Lev deque of jobs. The owner thread pushes and pops jobs
+ * at the bottom in LIFO order while other threads steal jobs from the top.
+ * The storage grows as needed and is only released on destruction, since
+ * thieves may still be reading from a previous buffer.
+ */
+class work_stealing_deque {
+public:
+    work_stealing_deque(size_t initial_capacity = 256);
+
+    work_stealing_deque(const work_stealing_deque &) = delete;
+    work_stealing_deque & operator=(const work_stealing_deque &) = delete;
+
+    /**
+     * Inserts a job at the bottom. Must only be called by the owner thread.
+     */
+    void push(const job &);
+
+    /**
+     * Removes the job at the bottom. Must only be called by the owner thread.
+     */
+    bool pop(job &);
+
+    /**
+     * Removes the job at the bottom only if it was pushed at or after the
+     * given position. Must only be called by the owner thread.
+     * @param position A value previously returned by `bottom()`.
+     */
+    bool pop_after(int64_t position, job &);
+
+    /**
+     * Position where the next job will be pushed. Must only be called by the
+     * owner thread.
+     */
+    int64_t bottom() const {
+        return m_bottom.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Removes the job at the top. Can be called from any thread. Might fail
+     * if another thread takes the same job concurrently.
+     */
+    bool steal(job &);
+
+    /**
+     * An estimate of the number of jobs, which might be outdated by the time
+     * it returns.
+     */
+    size_t size() const;
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+private:
+    struct buffer {
+        int64_t mask;
+        std::unique_ptr<job[]> jobs;
+
+        buffer(size_t capacity)
+            : mask(static_cast<int64_t>(capacity) - 1)
+            , jobs(new job[capacity])
+        {}
+
+        int64_t capacity() const {
+            return mask + 1;
+        }
+
+        job &operator[](int64_t index) {
+            return jobs[index & mask];
+        }
+    };
+
+    buffer *grow(buffer *buf, int64_t top, int64_t bottom);
+
+    alignas(64) std::atomic<int64_t> m_top {0};
+    alignas(64) std::atomic<int64_t> m_bottom {0};
+    std::atomic<buffer *> m_buffer;
+    // All buffers ever allocated. Only accessed by the owner thread.
+    std::vector<std::unique_ptr<buffer>> m_buffers;
+};
+
+}
+
+#endif // EDYN_PARALLEL_WORK_STEALING_DEQUE_HPP
@@ -1,63 +1,118 @@
 #ifndef EDYN_PARALLEL_WORKER_HPP
 #define EDYN_PARALLEL_WORKER_HPP
 
+#include <mutex>
 #include <atomic>
-#include <memory>
-#include "edyn/parallel/job_queue.hpp"
+#include <vector>
+#include <cstdint>
+#include "edyn/parallel/job.hpp"
+#include "edyn/parallel/work_stealing_deque.hpp"
 
 namespace edyn {
 
+class job_dispatcher;
+
 /**
- * A worker that runs jobs in a thread.
+ * A worker that runs jobs in a thread. Jobs scheduled from the worker thread
+ * go into its local deque and jobs scheduled from other threads go into its
+ * inbox. When it runs out of jobs it steals from other workers, then spins
+ * for a while before going to sleep.
  */
 class worker {
+    struct inbox_job {
+        job m_job;
+        uint32_t m_priority;
+        uint64_t m_sequence;
+    };
+
+    // Heap comparison which puts the job to be run next at the front.
+    struct inbox_job_after {
+        bool operator()(const inbox_job &lhs, const inbox_job &rhs) const {
+            if (lhs.m_priority != rhs.m_priority) {
+                return lhs.m_priority < rhs.m_priority;
+            }
+
+            return lhs.m_sequence > rhs.m_sequence;
+        }
+    };
+
 public:
-    void push_job(const job &j) {
-        m_queue.push(j);
-        ++m_size;
-    }
+    worker(job_dispatcher &dispatcher, size_t index);
 
-    void run() {
-        m_running = true;
+    /**
+     * Inserts a job into the local deque. Must be called from the worker
+     * thread.
+     */
+    void push_local(const job &);
 
-        for (;;) {
-            auto j = m_queue.pop();
-            j();
-            --m_size;
+    /**
+     * Inserts a job into the inbox. Can be called from any thread. Jobs with
+     * higher priority are taken from the inbox first and jobs with the same
+     * priority are taken in insertion order.
+     */
+    void push_external(const job &, uint32_t priority = 0);
 
-            if (!m_running) {
-                break;
-            }
-        }
-    }
+    void run();
 
-    void once() {
-        job j;
-        while (m_queue.try_pop(j)) {
-            j();
-            --m_size;
-        }
+    /**
+     * Position of the bottom of the local deque, which marks the jobs pushed
+     * afterwards. Must be called from the worker thread.
+     */
+    int64_t local_job_mark() const {
+        return m_deque.bottom();
     }
 
-    void stop() {
-        m_running = false;
-        m_queue.push(job::noop()); // Unblock queue with a no-op job.
-    }
+    /**
+     * Runs the job at the bottom of the local deque if it was pushed after
+     * the given mark. Must be called from the worker thread.
+     * @return Whether a job was executed.
+     */
+    bool run_local_job_after(int64_t mark);
+
+    /**
+     * Takes a job from this worker to be run in another thread.
+     */
+    bool try_steal(job &);
+
+    bool has_jobs() const;
+
+    /**
+     * Approximate number of jobs waiting in the local deque and inbox.
+     */
+    size_t num_pending_jobs() const;
 
-    size_t size() {
-        return m_size.load();
+    job_dispatcher &get_dispatcher() const {
+        return *m_dispatcher;
     }
 
-    job_queue &get_queue() {
-        return m_queue;
+    size_t index() const {
+        return m_index;
     }
 
+    /**
+     * Worker running in the current thread, or null if it's not a worker
+     * thread.
+     */
+    static worker *current();
+
 private:
-    std::atomic_bool m_running {false};
-    job_queue m_queue;
-    std::atomic<size_t> m_size;
+    bool try_pop(job &);
+    bool try_pop_inbox(job &);
+    bool try_steal_from_others(job &);
+
+    job_dispatcher *m_dispatcher;
+    size_t m_index;
+    work_stealing_deque m_deque;
+
+    std::mutex m_inbox_mutex;
+    std::vector<inbox_job> m_inbox;
+    uint64_t m_inbox_sequence {0};
+    std::atomic<size_t> m_inbox_size {0};
+
+    // State of random number generator used to pick victims.
+    uint32_t m_random_state;
 };
 
 }
 
-#endif // EDYN_PARALLEL_WORKER_HPP
\ No newline at end of file
+#endif // EDYN_PARALLEL_WORKER_HPP
@@ -99,6 +99,18 @@ public:
         m_file.close();
     }
 
+    bool is_file_good() const {
+        return m_file.good();
+    }
+
+    void seek_position(size_t pos) {
+        m_file.seekp(pos);
+    }
+
+    size_t tell_position() {
+        return m_file.tellp();
+    }
+
 private:
     template<typename T>
     void write_bytes(T &t) {
@@ -0,0 +1,51 @@
+#ifndef EDYN_SERIALIZATION_MAPPABLE_VECTOR_S11N_HPP
+#define EDYN_SERIALIZATION_MAPPABLE_VECTOR_S11N_HPP
+
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include "edyn/util/mappable_vector.hpp"
+#include "edyn/serialization/std_s11n.hpp"
+
+namespace edyn {
+
+// Uses the same format as `std::vector`. Mapped vectors are written as if
+// they were owned and always become owned when read, except by archives
+// which have a specific overload, such as `mapped_input_archive`.
+template<typename Archive, typename T>
+void serialize(Archive &archive, mappable_vector<T> &vector) {
+    if constexpr(Archive::is_output::value) {
+        if (vector.is_mapped()) {
+            auto values = std::vector<T>(vector.size());
+
+            for (size_t i = 0; i < values.size(); ++i) {
+                values[i] = std::as_const(vector)[i];
+            }
+
+            archive(values);
+            return;
+        }
+    } else {
+        vector = {};
+    }
+
+    archive(vector.m_vector);
+    vector.sync();
+}
+
+template<typename T>
+size_t serialization_sizeof(const mappable_vector<T> &vector) {
+    if (!vector.is_mapped()) {
+        return serialization_sizeof(vector.m_vector);
+    }
+
+    if constexpr(std::is_same_v<T, bool>) {
+        return serialization_sizeof(std::vector<bool>(vector.size()));
+    } else {
+        return sizeof(uint16_t) + vector.size() * sizeof(T);
+    }
+}
+
+}
+
+#endif // EDYN_SERIALIZATION_MAPPABLE_VECTOR_S11N_HPP
@@ -0,0 +1,272 @@
+#ifndef EDYN_SERIALIZATION_MAPPED_ARCHIVE_HPP
+#define EDYN_SERIALIZATION_MAPPED_ARCHIVE_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <type_traits>
+#include "edyn/config/config.h"
+#include "edyn/serialization/s11n_util.hpp"
+#include "edyn/util/mappable_vector.hpp"
+
+namespace edyn {
+
+/**
+ * Alignment of arrays in a mapped archive. Arrays of trivially copyable types
+ * are stored as a contiguous block of raw bytes starting at a multiple of
+ * this value, which allows them to be read directly from memory mapped files.
+ */
+constexpr size_t mapped_archive_alignment = 16;
+
+/**
+ * Writes values into a file using a layout which can be read without parsing
+ * by a `mapped_input_archive`. Vectors of trivially copyable types are written
+ * as a 64-bit element count followed by the aligned raw elements.
+ */
+class mapped_output_archive {
+public:
+    using is_input = std::false_type;
+    using is_output = std::true_type;
+
+    mapped_output_archive(std::ofstream &file)
+        : m_file(&file)
+        , m_position(0)
+    {}
+
+    template<typename T>
+    void operator()(T& t) {
+        if constexpr(std::is_fundamental_v<T>) {
+            align(alignof(T));
+            write_bytes(&t, sizeof(T));
+        } else {
+            serialize(*this, t);
+        }
+    }
+
+    template<typename T>
+    void operator()(std::vector<T> &vector) {
+        uint64_t size = vector.size();
+        operator()(size);
+
+        if constexpr(std::is_trivially_copyable_v<T>) {
+            align(mapped_archive_alignment);
+            write_bytes(vector.data(), vector.size() * sizeof(T));
+        } else {
+            for (auto &value : vector) {
+                operator()(value);
+            }
+        }
+    }
+
+    void operator()(std::vector<bool> &vector) {
+        uint64_t size = vector.size();
+        operator()(size);
+
+        // One byte per element so it can be read with no bit manipulation.
+        for (size_t i = 0; i < vector.size(); ++i) {
+            uint8_t value = vector[i];
+            write_bytes(&value, sizeof(value));
+        }
+    }
+
+    template<typename... Ts>
+    void operator()(Ts&... t) {
+        (operator()(t), ...);
+    }
+
+    /**
+     * Writes zeros until the position is a multiple of `alignment`.
+     */
+    void align(size_t alignment) {
+        static const char zeros[64] = {};
+        EDYN_ASSERT(alignment <= sizeof(zeros));
+        auto padding = (alignment - m_position % alignment) % alignment;
+        write_bytes(zeros, padding);
+    }
+
+    /**
+     * Number of bytes written since the archive was created.
+     */
+    size_t position() const {
+        return m_position;
+    }
+
+private:
+    void write_bytes(const void *data, size_t size) {
+        m_file->write(reinterpret_cast<const char *>(data), size);
+        m_position += size;
+    }
+
+    std::ofstream *m_file;
+    size_t m_position;
+};
+
+/**
+ * Reads values from a buffer written by a `mapped_output_archive`, usually a
+ * memory mapped file. Vectors of trivially copyable types are assigned directly
+ * from the buffer with a single copy, except for a `mappable_vector`, which is
+ * mapped onto the buffer with no copy at all unless disabled, in which case
+ * the buffer must outlive it. The buffer must be aligned to
+ * `mapped_archive_alignment`.
+ */
+class mapped_input_archive {
+public:
+    using data_type = uint8_t;
+    using buffer_type = const data_type*;
+    using is_input = std::true_type;
+    using is_output = std::false_type;
+
+    mapped_input_archive(buffer_type buffer, size_t size, bool map_vectors = true)
+        : m_buffer(buffer)
+        , m_size(size)
+        , m_position(0)
+        , m_failed(false)
+        , m_map_vectors(map_vectors)
+    {
+        EDYN_ASSERT(reinterpret_cast<uintptr_t>(buffer) % mapped_archive_alignment == 0);
+    }
+
+    template<typename T>
+    void operator()(T& t) {
+        if constexpr(std::is_fundamental_v<T>) {
+            align(alignof(T));
+
+            if (auto *data = read_bytes(sizeof(T))) {
+                std::memcpy(&t, data, sizeof(T));
+            }
+        } else {
+            serialize(*this, t);
+        }
+    }
+
+    template<typename T>
+    void operator()(std::vector<T> &vector) {
+        uint64_t size = 0;
+        operator()(size);
+
+        if (m_failed) {
+            return;
+        }
+
+        if constexpr(std::is_trivially_copyable_v<T>) {
+            align(mapped_archive_alignment);
+
+            if (size > (m_size - std::min(m_position, m_size)) / sizeof(T)) {
+                m_failed = true;
+                return;
+            }
+
+            auto *data = reinterpret_cast<const T *>(read_bytes(size * sizeof(T)));
+            vector.assign(data, data + size);
+        } else {
+            vector.resize(size);
+
+            for (auto &value : vector) {
+                operator()(value);
+            }
+        }
+    }
+
+    void operator()(std::vector<bool> &vector) {
+        uint64_t size = 0;
+        operator()(size);
+
+        if (auto *data = read_bytes(size)) {
+            vector.resize(size);
+
+            for (size_t i = 0; i < size; ++i) {
+                vector[i] = data[i] != 0;
+            }
+        }
+    }
+
+    template<typename T>
+    void operator()(mappable_vector<T> &vector) {
+        if (!m_map_vectors) {
+            serialize(*this, vector);
+            return;
+        }
+
+        if constexpr(std::is_trivially_copyable_v<T>) {
+            uint64_t size = 0;
+            operator()(size);
+
+            if (m_failed) {
+                return;
+            }
+
+            align(mapped_archive_alignment);
+
+            if (size > (m_size - std::min(m_position, m_size)) / sizeof(T)) {
+                m_failed = true;
+                return;
+            }
+
+            auto *data = reinterpret_cast<const T *>(read_bytes(size * sizeof(T)));
+            vector.map(data, size);
+        } else {
+            auto values = std::vector<T>{};
+            operator()(values);
+            vector = {};
+            vector.assign(values.begin(), values.end());
+        }
+    }
+
+    void operator()(mappable_vector<bool> &vector) {
+        if (!m_map_vectors) {
+            serialize(*this, vector);
+            return;
+        }
+
+        uint64_t size = 0;
+        operator()(size);
+
+        if (auto *data = read_bytes(size)) {
+            vector.map(data, size);
+        }
+    }
+
+    template<typename... Ts>
+    void operator()(Ts&... t) {
+        (operator()(t), ...);
+    }
+
+    void align(size_t alignment) {
+        m_position += (alignment - m_position % alignment) % alignment;
+    }
+
+    size_t position() const {
+        return m_position;
+    }
+
+    bool failed() const {
+        return m_failed;
+    }
+
+private:
+    // Returns a pointer to the next `size` bytes and advances, or nullptr if
+    // there aren't enough bytes left.
+    buffer_type read_bytes(size_t size) {
+        if (m_failed || m_position > m_size || size > m_size - m_position) {
+            m_failed = true;
+            return nullptr;
+        }
+
+        auto *data = m_buffer + m_position;
+        m_position += size;
+        return data;
+    }
+
+    buffer_type m_buffer;
+    const size_t m_size;
+    size_t m_position;
+    bool m_failed;
+    bool m_map_vectors;
+};
+
+}
+
+#endif // EDYN_SERIALIZATION_MAPPED_ARCHIVE_HPP
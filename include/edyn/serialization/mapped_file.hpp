@@ -0,0 +1,55 @@
+#ifndef EDYN_SERIALIZATION_MAPPED_FILE_HPP
+#define EDYN_SERIALIZATION_MAPPED_FILE_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace edyn {
+
+/**
+ * @brief A read-only view of a file mapped into memory. Pages are loaded by
+ * the operating system as they're accessed and are shared with every other
+ * process that maps the same file.
+ */
+class mapped_file {
+public:
+    mapped_file() = default;
+    mapped_file(const mapped_file &) = delete;
+    mapped_file & operator=(const mapped_file &) = delete;
+
+    ~mapped_file() {
+        close();
+    }
+
+    /**
+     * @brief Maps the entire file into memory.
+     * @param path Path to file.
+     * @return Whether the file was successfully mapped.
+     */
+    bool open(const std::string &path);
+
+    void close();
+
+    bool is_open() const {
+        return m_data != nullptr;
+    }
+
+    const uint8_t * data() const {
+        return m_data;
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+private:
+    const uint8_t *m_data {nullptr};
+    size_t m_size {0};
+    // Platform specific handle of the mapping, if needed.
+    void *m_handle {nullptr};
+};
+
+}
+
+#endif // EDYN_SERIALIZATION_MAPPED_FILE_HPP
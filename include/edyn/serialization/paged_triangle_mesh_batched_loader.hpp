@@ -0,0 +1,170 @@
+#ifndef EDYN_SERIALIZATION_PAGED_TRIANGLE_MESH_BATCHED_LOADER_HPP
+#define EDYN_SERIALIZATION_PAGED_TRIANGLE_MESH_BATCHED_LOADER_HPP
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <condition_variable>
+#include "edyn/shapes/paged_triangle_mesh.hpp"
+#include "edyn/shapes/triangle_mesh_page_loader.hpp"
+#include "edyn/serialization/random_access_file.hpp"
+#include "edyn/parallel/job.hpp"
+#include <entt/signal/sigh.hpp>
+
+namespace edyn {
+
+/**
+ * @brief Histogram of page load latencies, measured from the moment a page
+ * is requested until it's handed over to the paged triangle mesh. Bucket `i`
+ * counts loads which took less than `2^i` microseconds and at least
+ * `2^(i-1)`. The last bucket also counts all slower loads.
+ */
+struct page_load_latency_histogram {
+    static constexpr size_t num_buckets = 24;
+    std::array<uint64_t, num_buckets> counts {};
+
+    uint64_t total_count() const;
+
+    /**
+     * @brief Upper bound of the bucket where the given fraction of the loads
+     * is reached, e.g. `0.99` for the 99th percentile.
+     * @param fraction Value in the [0, 1] range.
+     * @return Latency in microseconds.
+     */
+    uint64_t percentile_us(double fraction) const;
+};
+
+/**
+ * @brief Page loader for paged triangle mesh files written in the `embedded`
+ * mode which serves all requests from a dedicated I/O thread. Pending requests
+ * are sorted by their position in the file and submeshes which are adjacent
+ * are read together in a single positional read, i.e. `pread`, without seeking
+ * a shared file position. The number of submeshes being read or deserialized
+ * at once is bounded and the rest wait in a queue. Deserialization runs in
+ * background jobs.
+ */
+class paged_triangle_mesh_batched_loader: public triangle_mesh_page_loader_base {
+public:
+    /**
+     * @param max_in_flight Maximum number of submeshes being read or
+     * deserialized at the same time.
+     * @param max_read_size Maximum number of bytes read at once when merging
+     * reads of adjacent submeshes.
+     */
+    paged_triangle_mesh_batched_loader(size_t max_in_flight = 32,
+                                       size_t max_read_size = size_t(1) << 20);
+    ~paged_triangle_mesh_batched_loader();
+
+    paged_triangle_mesh_batched_loader(const paged_triangle_mesh_batched_loader &) = delete;
+    paged_triangle_mesh_batched_loader & operator=(const paged_triangle_mesh_batched_loader &) = delete;
+
+    bool open(const std::string &path);
+
+    /**
+     * @brief Stops the I/O thread, waits for pending deserialization jobs
+     * and closes the file. Requests still in the queue are discarded.
+     */
+    void close();
+
+    bool is_open() const {
+        return m_file.is_open();
+    }
+
+    void load(size_t index) override;
+
+    /**
+     * @brief Requests multiple submeshes at once, which guarantees they're
+     * seen together by the I/O thread and can be read in a single batch if
+     * they're adjacent in the file and the in-flight limit allows.
+     * @param indices Submesh indices.
+     */
+    void load(const std::vector<size_t> &indices);
+
+    virtual entt::sink<entt::sigh<loaded_mesh_func_t>> on_load_sink() override {
+        return {m_loaded_signal};
+    }
+
+    page_load_latency_histogram get_latency_histogram() const;
+
+    /**
+     * @brief Number of reads issued to the file. Less than the number of loaded
+     * submeshes when reads are merged.
+     */
+    size_t num_reads() const {
+        return m_num_reads.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of submeshes which were read and handed over. Duplicate
+     * requests which were merged into another are not counted.
+     */
+    size_t num_loaded() const {
+        return m_num_loaded.load(std::memory_order_relaxed);
+    }
+
+    void reset_stats();
+
+    friend void serialize(paged_triangle_mesh_batched_loader &loader,
+                          paged_triangle_mesh &paged_tri_mesh);
+    friend void batched_loader_deserialize_job_func(job::data_type &);
+
+private:
+    struct request {
+        size_t index;
+        uint64_t time;
+    };
+
+    // A group of submeshes which are contiguous in the file and were read
+    // into a single buffer.
+    struct read_batch {
+        std::vector<uint8_t> buffer;
+        std::vector<request> requests;
+        std::vector<size_t> buffer_offsets;
+    };
+
+    void run();
+    void read(std::vector<request> &requests);
+    void record_load(const request &req);
+    void finish_requests(size_t count);
+    size_t submesh_offset(size_t index) const;
+    size_t submesh_size(size_t index) const;
+
+    random_access_file m_file;
+    std::string m_path;
+    size_t m_base_offset {0};
+    std::vector<size_t> m_offsets;
+
+    size_t m_max_in_flight;
+    size_t m_max_read_size;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<request> m_queue;
+    size_t m_num_in_flight {0};
+    bool m_running {false};
+
+    std::array<std::atomic<uint64_t>, page_load_latency_histogram::num_buckets> m_latency_counts {};
+    std::atomic<size_t> m_num_reads {0};
+    std::atomic<size_t> m_num_loaded {0};
+
+    entt::sigh<loaded_mesh_func_t> m_loaded_signal;
+};
+
+/**
+ * @brief Reads a paged triangle mesh written in the `embedded` mode by a
+ * `paged_triangle_mesh_file_output_archive`. Submeshes are loaded on demand
+ * afterwards.
+ * @param loader Loader with an open file.
+ * @param paged_tri_mesh Paged triangle mesh using the same loader.
+ */
+void serialize(paged_triangle_mesh_batched_loader &loader,
+               paged_triangle_mesh &paged_tri_mesh);
+
+}
+
+#endif // EDYN_SERIALIZATION_PAGED_TRIANGLE_MESH_BATCHED_LOADER_HPP
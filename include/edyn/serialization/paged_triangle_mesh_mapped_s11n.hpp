@@ -0,0 +1,120 @@
+#ifndef EDYN_SERIALIZATION_PAGED_TRIANGLE_MESH_MAPPED_S11N_HPP
+#define EDYN_SERIALIZATION_PAGED_TRIANGLE_MESH_MAPPED_S11N_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <memory>
+#include "edyn/shapes/paged_triangle_mesh.hpp"
+#include "edyn/shapes/triangle_mesh_page_loader.hpp"
+#include "edyn/serialization/mapped_file.hpp"
+#include <entt/signal/sigh.hpp>
+
+namespace edyn {
+
+/**
+ * Version of the memory mapped paged triangle mesh file layout. Files written
+ * with a different version are rejected when opened.
+ */
+constexpr uint32_t paged_triangle_mesh_mapped_version = 2;
+
+/**
+ * Alignment of each submesh in a memory mapped paged triangle mesh file.
+ */
+constexpr size_t paged_triangle_mesh_mapped_submesh_alignment = 64;
+
+/**
+ * @brief Writes a paged triangle mesh into a file which can be memory mapped
+ * and loaded with a `paged_triangle_mesh_mapped_loader`.
+ *
+ * The file starts with a header containing an identifier, the layout version
+ * and the size of `scalar`, followed by the submesh tree and the submeshes.
+ * Each submesh starts at a multiple of
+ * `paged_triangle_mesh_mapped_submesh_alignment` and has all of its arrays
+ * (i.e. vertices, indices, normals, edge and adjacency data and the flattened
+ * triangle tree) stored as raw aligned blocks. A table with the offset and
+ * size of each submesh is placed at the end.
+ *
+ * All submeshes must be loaded, which is the case right after
+ * `create_paged_triangle_mesh`.
+ * @param path Path of file to be written.
+ * @param paged_tri_mesh The paged triangle mesh.
+ * @return Whether the file was successfully written.
+ */
+bool write_paged_triangle_mesh_mapped(const std::string &path,
+                                      paged_triangle_mesh &paged_tri_mesh);
+
+/**
+ * @brief Page loader which memory maps a file written by
+ * `write_paged_triangle_mesh_mapped`. Since the data of a submesh is already
+ * laid out in memory as it is used, loading a submesh only points the arrays
+ * of a `triangle_mesh` into the mapping, with no parsing nor copying, thus
+ * it's done synchronously. Loaded submeshes keep the mapping alive even after
+ * the loader is closed. Multiple processes which map the same file share the
+ * same physical pages.
+ */
+class paged_triangle_mesh_mapped_loader: public triangle_mesh_page_loader_base {
+public:
+    paged_triangle_mesh_mapped_loader() = default;
+
+    /**
+     * @brief Maps the file into memory and validates its header.
+     * @param path Path to file.
+     * @return Whether the file was mapped and has a compatible layout.
+     */
+    bool open(const std::string &path);
+
+    void close();
+
+    bool is_open() const {
+        return m_file && m_file->is_open();
+    }
+
+    /**
+     * @brief Start of the memory mapped file, where submesh data points into.
+     */
+    const uint8_t * mapped_data() const {
+        return is_open() ? m_file->data() : nullptr;
+    }
+
+    size_t mapped_size() const {
+        return is_open() ? m_file->size() : 0;
+    }
+
+    void load(size_t index) override;
+
+    virtual entt::sink<entt::sigh<loaded_mesh_func_t>> on_load_sink() override {
+        return {m_loaded_signal};
+    }
+
+    friend void serialize(paged_triangle_mesh_mapped_loader &loader,
+                          paged_triangle_mesh &paged_tri_mesh);
+
+    // Location of a submesh in the file.
+    struct submesh_entry {
+        uint64_t num_vertices;
+        uint64_t num_indices;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+private:
+    // Shared with the submeshes which reference it.
+    std::shared_ptr<mapped_file> m_file;
+    uint64_t m_tree_offset;
+    std::vector<submesh_entry> m_submeshes;
+    entt::sigh<loaded_mesh_func_t> m_loaded_signal;
+};
+
+/**
+ * @brief Reads the submesh tree and the number of submeshes of a paged triangle
+ * mesh from an open mapped file. Submeshes are loaded on demand afterwards.
+ * @param loader Loader with an open file.
+ * @param paged_tri_mesh Paged triangle mesh using the same loader.
+ */
+void serialize(paged_triangle_mesh_mapped_loader &loader,
+               paged_triangle_mesh &paged_tri_mesh);
+
+}
+
+#endif // EDYN_SERIALIZATION_PAGED_TRIANGLE_MESH_MAPPED_S11N_HPP
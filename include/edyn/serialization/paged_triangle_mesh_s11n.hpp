@@ -4,7 +4,9 @@
 #include <type_traits>
 #include "edyn/shapes/paged_triangle_mesh.hpp"
 #include "edyn/shapes/triangle_mesh_page_loader.hpp"
+#include "edyn/shapes/create_paged_triangle_mesh.hpp"
 #include "edyn/serialization/file_archive.hpp"
+#include "edyn/serialization/triangle_mesh_s11n.hpp"
 #include "edyn/parallel/job_queue_scheduler.hpp"
 #include "edyn/parallel/job.hpp"
 #include <entt/signal/sigh.hpp>
@@ -13,6 +15,7 @@ namespace edyn {
 
 class paged_triangle_mesh_file_output_archive;
 class paged_triangle_mesh_file_input_archive;
+class paged_triangle_mesh_batched_loader;
 class load_mesh_job;
 class finish_load_mesh_job;
 
@@ -66,6 +69,7 @@ public:
         : super(path)
         , m_path(path)
         , m_triangle_mesh_index(0)
+        , m_submesh_info_position(SIZE_MAX)
         , m_mode(mode)
     {}
 
@@ -87,13 +91,88 @@ public:
 
     friend void serialize(paged_triangle_mesh_file_output_archive &archive,
                           paged_triangle_mesh &paged_tri_mesh);
+    friend void begin_streamed_serialize(paged_triangle_mesh_file_output_archive &archive,
+                                         paged_triangle_mesh &paged_tri_mesh);
+    friend void end_streamed_serialize(paged_triangle_mesh_file_output_archive &archive,
+                                       paged_triangle_mesh &paged_tri_mesh,
+                                       const std::vector<size_t> &submesh_sizes);
 
 private:
     std::string m_path;
     size_t m_triangle_mesh_index;
+    // Position in file where the submesh info starts. Used when streaming.
+    size_t m_submesh_info_position;
     paged_triangle_mesh_serialization_mode m_mode;
 };
 
+/**
+ * Writes the submesh tree of a paged triangle mesh followed by placeholders
+ * for the information about the submeshes, which are then expected to be
+ * written in order via the archive, followed by a call to
+ * `end_streamed_serialize`.
+ */
+void begin_streamed_serialize(paged_triangle_mesh_file_output_archive &archive,
+                              paged_triangle_mesh &paged_tri_mesh);
+
+/**
+ * Overwrites the placeholders written in `begin_streamed_serialize` once
+ * all submeshes have been written.
+ * @param submesh_sizes Value of `serialization_sizeof` for each submesh.
+ */
+void end_streamed_serialize(paged_triangle_mesh_file_output_archive &archive,
+                            paged_triangle_mesh &paged_tri_mesh,
+                            const std::vector<size_t> &submesh_sizes);
+
+/**
+ * Creates a paged triangle mesh and writes it to file as submeshes are built,
+ * without holding all of them in memory. The file is the same as the one
+ * written by serializing a paged triangle mesh created by
+ * `create_paged_triangle_mesh` with a `paged_triangle_mesh_file_output_archive`.
+ * The paged triangle mesh is left without any loaded submesh.
+ * @param path Path of file to be written.
+ * @param mode Serialization mode.
+ * @param max_submeshes_in_memory Maximum number of submeshes built at once.
+ * @param compress Whether to compress each submesh before it's written.
+ * @see create_paged_triangle_mesh_streamed
+ */
+template<typename VertexIterator, typename IndexIterator>
+void create_paged_triangle_mesh_file(
+        const std::string &path, paged_triangle_mesh_serialization_mode mode,
+        paged_triangle_mesh &paged_tri_mesh,
+        VertexIterator vertex_begin, VertexIterator vertex_end,
+        IndexIterator index_begin, IndexIterator index_end,
+        size_t max_tri_per_submesh,
+        const std::vector<vector3> &vertex_colors,
+        size_t max_submeshes_in_memory = 256,
+        bool compress = false) {
+
+    auto archive = paged_triangle_mesh_file_output_archive(path, mode);
+    auto submesh_sizes = std::vector<size_t>{};
+    auto begun = false;
+
+    // The submesh tree is built before the first submesh, thus the file can
+    // only be started then.
+    create_paged_triangle_mesh_streamed(
+        paged_tri_mesh, vertex_begin, vertex_end, index_begin, index_end,
+        max_tri_per_submesh, vertex_colors, max_submeshes_in_memory,
+        [&] (size_t, triangle_mesh &submesh) {
+            if (!begun) {
+                begin_streamed_serialize(archive, paged_tri_mesh);
+                begun = true;
+            }
+
+            submesh_sizes.push_back(serialization_sizeof(submesh));
+            archive(submesh);
+        }, compress);
+
+    // A mesh without submeshes still gets a valid file.
+    if (!begun) {
+        begin_streamed_serialize(archive, paged_tri_mesh);
+    }
+
+    end_streamed_serialize(archive, paged_tri_mesh, submesh_sizes);
+}
+
 /**
  * Specialized archive to read a `paged_triangle_mesh` from file. It can also be
  * used as a page loader in the `paged_triangle_mesh`.
@@ -122,6 +201,8 @@ public:
 
     friend void serialize(paged_triangle_mesh_file_input_archive &archive,
                           paged_triangle_mesh &paged_tri_mesh);
+    friend void serialize(paged_triangle_mesh_batched_loader &loader,
+                          paged_triangle_mesh &paged_tri_mesh);
     friend void load_mesh_job_func(job::data_type &);
     friend void finish_load_mesh_job_func(job::data_type &);
 
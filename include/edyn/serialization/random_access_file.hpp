@@ -0,0 +1,51 @@
+#ifndef EDYN_SERIALIZATION_RANDOM_ACCESS_FILE_HPP
+#define EDYN_SERIALIZATION_RANDOM_ACCESS_FILE_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace edyn {
+
+/**
+ * @brief A read-only file which reads at explicit offsets without a shared
+ * file position, thus it can be read from multiple threads concurrently.
+ */
+class random_access_file {
+public:
+    random_access_file() = default;
+    random_access_file(const random_access_file &) = delete;
+    random_access_file & operator=(const random_access_file &) = delete;
+
+    ~random_access_file() {
+        close();
+    }
+
+    bool open(const std::string &path);
+
+    void close();
+
+    bool is_open() const {
+        return m_handle != invalid_handle;
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+    /**
+     * @brief Reads `size` bytes starting at `offset` into `buffer`.
+     * @return Whether all bytes were read.
+     */
+    bool read(void *buffer, size_t size, size_t offset) const;
+
+private:
+    static constexpr intptr_t invalid_handle = -1;
+    // Native file handle, i.e. a file descriptor or a `HANDLE`.
+    intptr_t m_handle {invalid_handle};
+    size_t m_size {0};
+};
+
+}
+
+#endif // EDYN_SERIALIZATION_RANDOM_ACCESS_FILE_HPP
@@ -3,6 +3,9 @@
 #include "edyn/serialization/static_tree_s11n.hpp"
 #include "edyn/serialization/triangle_mesh_s11n.hpp"
 #include "edyn/serialization/paged_triangle_mesh_s11n.hpp"
+#include "edyn/serialization/paged_triangle_mesh_mapped_s11n.hpp"
+#include "edyn/serialization/paged_triangle_mesh_batched_loader.hpp"
 #include "edyn/serialization/entt_s11n.hpp"
 #include "edyn/serialization/file_archive.hpp"
-#include "edyn/serialization/memory_archive.hpp"
\ No newline at end of file
+#include "edyn/serialization/memory_archive.hpp"
+#include "edyn/serialization/mapped_archive.hpp"
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define EDYN_SERIALIZATION_STATIC_TREE_S11N_HPP
 
 #include "edyn/collision/static_tree.hpp"
+#include "edyn/serialization/mappable_vector_s11n.hpp"
 
 namespace edyn {
 
@@ -73,9 +73,10 @@ void serialize(Archive &archive, std::vector<bool> &vector) {
     }
 }
 
+// The size of vectors is written as a `uint16_t` in `serialize` above.
 template<typename T>
 size_t serialization_sizeof(const std::vector<T> &vec) {
-    return sizeof(size_t) + vec.size() * sizeof(typename std::vector<T>::value_type);
+    return sizeof(uint16_t) + vec.size() * sizeof(typename std::vector<T>::value_type);
 }
 
 inline
@@ -83,7 +84,7 @@ size_t serialization_sizeof(const std::vector<bool> &vec) {
     using set_type = uint32_t;
     constexpr auto set_num_bits = sizeof(set_type) * 8;
     const auto num_sets = vec.size() / set_num_bits + (vec.size() % set_num_bits != 0);
-    return sizeof(size_t) + num_sets * sizeof(set_type);
+    return sizeof(uint16_t) + num_sets * sizeof(set_type);
 }
 
 template<typename Archive, typename T, size_t N>
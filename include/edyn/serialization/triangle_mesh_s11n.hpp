@@ -3,7 +3,9 @@
 
 #include "edyn/shapes/triangle_mesh.hpp"
 #include "edyn/serialization/std_s11n.hpp"
+#include "edyn/serialization/mappable_vector_s11n.hpp"
 #include "edyn/serialization/static_tree_s11n.hpp"
+#include "edyn/serialization/math_s11n.hpp"
 
 namespace edyn {
 
@@ -29,9 +31,45 @@ size_t serialization_sizeof(const flat_nested_array<T> &array) {
     return serialization_sizeof(array.m_data) + serialization_sizeof(array.m_range_starts);
 }
 
+namespace detail {
+    /**
+     * Serialized triangle meshes start with this marker followed by the
+     * format version. Meshes written before versioning was introduced start
+     * with the number of vertices instead, which is a `uint16_t` as well, and
+     * do not contain the compressed data. Legacy meshes with exactly this
+     * number of vertices cannot be told apart.
+     */
+    constexpr uint16_t triangle_mesh_s11n_marker = UINT16_MAX;
+    constexpr uint16_t triangle_mesh_s11n_version = 1;
+}
+
 template<typename Archive>
 void serialize(Archive &archive, triangle_mesh &tri_mesh) {
-    archive(tri_mesh.m_vertices);
+    auto version = detail::triangle_mesh_s11n_version;
+
+    if constexpr(Archive::is_output::value) {
+        auto marker = detail::triangle_mesh_s11n_marker;
+        archive(marker);
+        archive(version);
+        archive(tri_mesh.m_vertices);
+    } else {
+        uint16_t marker;
+        archive(marker);
+
+        if (marker == detail::triangle_mesh_s11n_marker) {
+            archive(version);
+            archive(tri_mesh.m_vertices);
+        } else {
+            // Legacy format. The marker is the number of vertices.
+            version = 0;
+            tri_mesh.m_vertices.resize(marker);
+
+            for (auto &vertex : tri_mesh.m_vertices) {
+                archive(vertex);
+            }
+        }
+    }
+
     archive(tri_mesh.m_indices);
     archive(tri_mesh.m_normals);
     archive(tri_mesh.m_edge_vertex_indices);
@@ -44,11 +82,28 @@ void serialize(Archive &archive, triangle_mesh &tri_mesh) {
     archive(tri_mesh.m_triangle_tree);
     archive(tri_mesh.m_friction);
     archive(tri_mesh.m_restitution);
+
+    if (version == 0) {
+        tri_mesh.m_compressed = false;
+        return;
+    }
+
+    archive(tri_mesh.m_compressed);
+
+    if (tri_mesh.m_compressed) {
+        archive(tri_mesh.m_quantization_origin);
+        archive(tri_mesh.m_quantization_scale);
+        archive(tri_mesh.m_quantized_vertices);
+        archive(tri_mesh.m_packed_normals);
+        archive(tri_mesh.m_packed_adjacent_normals);
+    }
 }
 
 inline
 size_t serialization_sizeof(const triangle_mesh &tri_mesh) {
     return
+        sizeof(detail::triangle_mesh_s11n_marker) +
+        sizeof(detail::triangle_mesh_s11n_version) +
         serialization_sizeof(tri_mesh.m_vertices) +
         serialization_sizeof(tri_mesh.m_indices) +
         serialization_sizeof(tri_mesh.m_normals) +
@@ -61,7 +116,14 @@ size_t serialization_sizeof(const triangle_mesh &tri_mesh) {
         serialization_sizeof(tri_mesh.m_is_convex_edge) +
         serialization_sizeof(tri_mesh.m_triangle_tree) +
         serialization_sizeof(tri_mesh.m_friction) +
-        serialization_sizeof(tri_mesh.m_restitution);
+        serialization_sizeof(tri_mesh.m_restitution) +
+        sizeof(tri_mesh.m_compressed) +
+        (tri_mesh.m_compressed ?
+            sizeof(tri_mesh.m_quantization_origin) +
+            sizeof(tri_mesh.m_quantization_scale) +
+            serialization_sizeof(tri_mesh.m_quantized_vertices) +
+            serialization_sizeof(tri_mesh.m_packed_normals) +
+            serialization_sizeof(tri_mesh.m_packed_adjacent_normals) : 0);
 }
 
 }
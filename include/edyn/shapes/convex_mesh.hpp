@@ -6,6 +6,7 @@
 #include <cstdint>
 #include "edyn/math/vector3.hpp"
 #include "edyn/math/quaternion.hpp"
+#include "edyn/comp/aabb.hpp"
 #include "edyn/config/config.h"
 
 namespace edyn {
@@ -130,6 +131,10 @@ struct rotated_mesh {
     std::vector<vector3> vertices;
     std::vector<vector3> relevant_normals;
     std::vector<vector3> relevant_edges;
+
+    // Bounds of the source mesh in object space. Transforming it gives a
+    // conservative bound of the rotated mesh without using its vertices.
+    AABB local_aabb;
 };
 
 /**
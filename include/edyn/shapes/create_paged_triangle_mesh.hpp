@@ -1,8 +1,10 @@
 #ifndef EDYN_SHAPES_CREATE_PAGED_TRIANGLE_MESH_HPP
 #define EDYN_SHAPES_CREATE_PAGED_TRIANGLE_MESH_HPP
 
+#include <vector>
 #include <cstdint>
 #include <memory>
+#include <algorithm>
 #include "edyn/shapes/paged_triangle_mesh.hpp"
 #include "edyn/parallel/parallel_for.hpp"
 
@@ -34,141 +36,255 @@ struct submesh_builder {
     }
 
     template<typename VertexIterator, typename IndexIterator>
-    void build(paged_triangle_mesh &paged_tri_mesh, const triangle_mesh &global_tri_mesh,
-               VertexIterator vertex_begin, IndexIterator index_begin,
-               const std::vector<vector3> &vertex_colors) {
-        // Allocate space in cache for all submeshes.
-        paged_tri_mesh.m_cache.resize(infos.size());
-
-        // Create submeshes using the triangle indices stored in the `build_info`s.
-        parallel_for(size_t{0}, infos.size(), [&] (size_t idx) {
-            auto &info = infos[idx];
-
-            // Transform triangle indices into vertex indices.
-            auto local_num_triangles = info.ids.size();
-            auto global_indices = std::vector<size_t>();
-            global_indices.reserve(local_num_triangles * 3);
-
-            for (auto it = info.ids.begin(); it != info.ids.end(); ++it) {
-                for (size_t i = 0; i < 3; ++i) {
-                    auto index = *(index_begin + ((*it) * 3 + i));
-                    global_indices.push_back(index);
-                }
+    std::unique_ptr<triangle_mesh> build_submesh(size_t idx, const triangle_mesh &global_tri_mesh,
+                                                 VertexIterator vertex_begin, IndexIterator index_begin,
+                                                 const std::vector<vector3> &vertex_colors,
+                                                 bool compress) const {
+        auto &info = infos[idx];
+
+        // Transform triangle indices into vertex indices.
+        auto local_num_triangles = info.ids.size();
+        auto global_indices = std::vector<size_t>();
+        global_indices.reserve(local_num_triangles * 3);
+
+        for (auto it = info.ids.begin(); it != info.ids.end(); ++it) {
+            for (size_t i = 0; i < 3; ++i) {
+                auto index = *(index_begin + ((*it) * 3 + i));
+                global_indices.push_back(index);
             }
+        }
 
-            // Transform global indices into local indices by removing duplicates.
-            // `local_indices` maps local indices to global indices, i.e. the index
-            // of the element is the vertex index in the submesh.
-            auto local_indices = global_indices;
-            std::sort(local_indices.begin(), local_indices.end());
-            auto local_indices_erase_begin = std::unique(local_indices.begin(), local_indices.end());
-            local_indices.erase(local_indices_erase_begin, local_indices.end());
+        // Transform global indices into local indices by removing duplicates.
+        // `local_indices` maps local indices to global indices, i.e. the index
+        // of the element is the vertex index in the submesh.
+        auto local_indices = global_indices;
+        std::sort(local_indices.begin(), local_indices.end());
+        auto local_indices_erase_begin = std::unique(local_indices.begin(), local_indices.end());
+        local_indices.erase(local_indices_erase_begin, local_indices.end());
 
-            // Create triangle mesh for this leaf and allocate vertices and indices.
-            auto submesh = std::make_unique<triangle_mesh>();
-            submesh->m_vertices.reserve(local_indices.size());
+        // Create triangle mesh for this leaf and allocate vertices and indices.
+        auto submesh = std::make_unique<triangle_mesh>();
+        submesh->m_vertices.reserve(local_indices.size());
 
-            if (!vertex_colors.empty()) {
-                submesh->m_friction.reserve(local_indices.size());
-                submesh->m_restitution.reserve(local_indices.size());
-            }
+        if (!vertex_colors.empty()) {
+            submesh->m_friction.reserve(local_indices.size());
+            submesh->m_restitution.reserve(local_indices.size());
+        }
 
-            // Insert vertices into triangle mesh.
-            for (auto idx : local_indices) {
-                submesh->m_vertices.push_back(*(vertex_begin + idx));
+        // Insert vertices into triangle mesh.
+        for (auto idx : local_indices) {
+            submesh->m_vertices.push_back(*(vertex_begin + idx));
 
-                if (!vertex_colors.empty()) {
-                    submesh->m_friction.push_back(vertex_colors[idx].x);
-                    submesh->m_restitution.push_back(vertex_colors[idx].y);
-                }
+            if (!vertex_colors.empty()) {
+                submesh->m_friction.push_back(vertex_colors[idx].x);
+                submesh->m_restitution.push_back(vertex_colors[idx].y);
+            }
+        }
+
+        submesh->m_indices.resize(local_num_triangles);
+        submesh->m_normals.resize(local_num_triangles);
+        submesh->m_adjacent_normals.resize(local_num_triangles);
+
+        // Obtain local indices from global indices and add to triangle mesh.
+        for (size_t tri_idx = 0; tri_idx < local_num_triangles; ++tri_idx) {
+            auto global_tri_idx = info.ids[tri_idx];
+
+            for (size_t i = 0; i < 3; ++i) {
+                auto global_vertex_idx = global_indices[tri_idx * 3 + i];
+                // The local vertex index is the index of the element in
+                // `local_indices` which is equals to `global_vertex_idx`.
+                // `local_indices` is sorted thus a binary search can be used.
+                auto it = std::lower_bound(local_indices.begin(), local_indices.end(), global_vertex_idx);
+                EDYN_ASSERT(it != local_indices.end() && *it == global_vertex_idx);
+                auto local_vertex_idx = std::distance(local_indices.begin(), it);
+                submesh->m_indices[tri_idx][i] = local_vertex_idx;
+                // Assign adjacent normals as well.
+                submesh->m_adjacent_normals[tri_idx][i] = global_tri_mesh.m_adjacent_normals[global_tri_idx][i];
             }
 
-            submesh->m_indices.resize(local_num_triangles);
-            submesh->m_normals.resize(local_num_triangles);
-            submesh->m_adjacent_normals.resize(local_num_triangles);
-
-            // Obtain local indices from global indices and add to triangle mesh.
-            for (size_t tri_idx = 0; tri_idx < local_num_triangles; ++tri_idx) {
-                auto global_tri_idx = info.ids[tri_idx];
-
-                for (size_t i = 0; i < 3; ++i) {
-                    auto global_vertex_idx = global_indices[tri_idx * 3 + i];
-                    // The local vertex index is the index of the element in
-                    // `local_indices` which is equals to `global_vertex_idx`.
-                    auto it = std::find(local_indices.begin(), local_indices.end(), global_vertex_idx);
-                    EDYN_ASSERT(it != local_indices.end());
-                    auto local_vertex_idx = std::distance(local_indices.begin(), it);
-                    submesh->m_indices[tri_idx][i] = local_vertex_idx;
-                    // Assign adjacent normals as well.
-                    submesh->m_adjacent_normals[tri_idx][i] = global_tri_mesh.m_adjacent_normals[global_tri_idx][i];
+            // Assign normals as well.
+            submesh->m_normals[tri_idx] = global_tri_mesh.m_normals[global_tri_idx];
+        }
+
+        // `initialize()` should not be called on the submesh. Initialize
+        // submesh selectively, copying already calculated data from the
+        // full triangle mesh, which includes adjacency information related
+        // to the neighboring submeshes.
+        submesh->init_edge_indices();
+        submesh->build_triangle_tree();
+
+        auto local_num_edges = submesh->m_edge_vertex_indices.size();
+        submesh->m_is_convex_edge.resize(local_num_edges);
+
+        // Assign edge normals.
+        for (size_t edge_idx = 0; edge_idx < local_num_edges; ++edge_idx) {
+            // Find corresponding global edge index.
+            // Get indices of vertices of this edge in the submesh.
+            auto local_vertex_index0 = submesh->m_edge_vertex_indices[edge_idx].first;
+            auto local_vertex_index1 = submesh->m_edge_vertex_indices[edge_idx].second;
+            // Also get vertex indices in the global mesh.
+            auto global_vertex_index0 = local_indices[local_vertex_index0];
+            auto global_vertex_index1 = local_indices[local_vertex_index1];
+            // Get list of global edge indices which share the first vertex
+            // and find the edge that contains both global vertices.
+            auto global_edge_indices = global_tri_mesh.m_vertex_edge_indices[global_vertex_index0];
+
+        #if EDYN_DEBUG && !EDYN_DISABLE_ASSERT
+            auto edge_was_found = false;
+        #endif
+
+            for (size_t i = 0; i < global_edge_indices.size(); ++i) {
+                auto global_edge_idx = global_edge_indices[i];
+                auto global_edge_vertex_indices = global_tri_mesh.m_edge_vertex_indices[global_edge_idx];
+
+                // If one of the vertices is the second one then this must be it.
+                if (global_edge_vertex_indices[0] != global_vertex_index1 &&
+                    global_edge_vertex_indices[1] != global_vertex_index1) {
+                    continue;
                 }
 
-                // Assign normals as well.
-                submesh->m_normals[tri_idx] = global_tri_mesh.m_normals[global_tri_idx];
-            }
+                // Ensure the first vertex index matches expectation.
+                EDYN_ASSERT(global_edge_vertex_indices[0] == global_vertex_index0 ||
+                            global_edge_vertex_indices[1] == global_vertex_index0);
 
-            // `initialize()` should not be called on the submesh. Initialize
-            // submesh selectively, copying already calculated data from the
-            // full triangle mesh, which includes adjacency information related
-            // to the neighboring submeshes.
-            submesh->init_edge_indices();
-            submesh->build_triangle_tree();
-
-            auto local_num_edges = submesh->m_edge_vertex_indices.size();
-            submesh->m_is_convex_edge.resize(local_num_edges);
-
-            // Assign edge normals.
-            for (size_t edge_idx = 0; edge_idx < local_num_edges; ++edge_idx) {
-                // Find corresponding global edge index.
-                // Get indices of vertices of this edge in the submesh.
-                auto local_vertex_index0 = submesh->m_edge_vertex_indices[edge_idx].first;
-                auto local_vertex_index1 = submesh->m_edge_vertex_indices[edge_idx].second;
-                // Also get vertex indices in the global mesh.
-                auto global_vertex_index0 = local_indices[local_vertex_index0];
-                auto global_vertex_index1 = local_indices[local_vertex_index1];
-                // Get list of global edge indices which share the first vertex
-                // and find the edge that contains both global vertices.
-                auto global_edge_indices = global_tri_mesh.m_vertex_edge_indices[global_vertex_index0];
+                auto is_convex = global_tri_mesh.m_is_convex_edge[global_edge_idx];
+                submesh->m_is_convex_edge[edge_idx] = is_convex;
 
             #if EDYN_DEBUG && !EDYN_DISABLE_ASSERT
-                auto edge_was_found = false;
+                edge_was_found = true;
             #endif
 
-                for (size_t i = 0; i < global_edge_indices.size(); ++i) {
-                    auto global_edge_idx = global_edge_indices[i];
-                    auto global_edge_vertex_indices = global_tri_mesh.m_edge_vertex_indices[global_edge_idx];
-
-                    // If one of the vertices is the second one then this must be it.
-                    if (global_edge_vertex_indices[0] != global_vertex_index1 &&
-                        global_edge_vertex_indices[1] != global_vertex_index1) {
-                        continue;
-                    }
+                break;
+            }
 
-                    // Ensure the first vertex index matches expectation.
-                    EDYN_ASSERT(global_edge_vertex_indices[0] == global_vertex_index0 ||
-                                global_edge_vertex_indices[1] == global_vertex_index0);
+        #if EDYN_DEBUG && !EDYN_DISABLE_ASSERT
+            EDYN_ASSERT(edge_was_found);
+        #endif
+        }
 
-                    auto is_convex = global_tri_mesh.m_is_convex_edge[global_edge_idx];
-                    submesh->m_is_convex_edge[edge_idx] = is_convex;
+        if (compress) {
+            // Quantize relative to the AABB of this submesh.
+            submesh->compress();
+        }
 
-                #if EDYN_DEBUG && !EDYN_DISABLE_ASSERT
-                    edge_was_found = true;
-                #endif
+        return submesh;
+    }
 
-                    break;
-                }
+    template<typename Function>
+    static void for_each_index(size_t first, size_t last, Function func) {
+        // `parallel_for` expects more than one element.
+        if (last - first > 1) {
+            parallel_for(first, last, func);
+        } else if (last > first) {
+            func(first);
+        }
+    }
 
-            #if EDYN_DEBUG && !EDYN_DISABLE_ASSERT
-                EDYN_ASSERT(edge_was_found);
-            #endif
-            }
+    template<typename VertexIterator, typename IndexIterator>
+    void build(paged_triangle_mesh &paged_tri_mesh, const triangle_mesh &global_tri_mesh,
+               VertexIterator vertex_begin, IndexIterator index_begin,
+               const std::vector<vector3> &vertex_colors, bool compress) {
+        // Allocate space in cache for all submeshes.
+        paged_tri_mesh.m_cache.resize(infos.size());
 
-            // Create node.
+        // Create submeshes using the triangle indices stored in the `build_info`s.
+        for_each_index(0, infos.size(), [&] (size_t idx) {
+            auto submesh = build_submesh(idx, global_tri_mesh, vertex_begin, index_begin, vertex_colors, compress);
             auto &paged_node = paged_tri_mesh.m_cache[idx];
-            paged_node.num_vertices = submesh->m_vertices.size();
+            paged_node.num_vertices = submesh->num_vertices();
             paged_node.num_indices = submesh->m_indices.size();
             paged_node.trimesh = std::move(submesh);
         });
+
+        // Setup LRU list with all submeshes, which are loaded at this point.
+        paged_tri_mesh.init_cache();
+    }
+
+    /**
+     * Builds submeshes in parallel in batches of at most `batch_size` and
+     * invokes `on_submesh` for each submesh of a batch in order, which is
+     * then discarded before the next batch is built. No submesh is loaded
+     * in the paged triangle mesh afterwards.
+     */
+    template<typename VertexIterator, typename IndexIterator, typename Function>
+    void build_streamed(paged_triangle_mesh &paged_tri_mesh, const triangle_mesh &global_tri_mesh,
+                        VertexIterator vertex_begin, IndexIterator index_begin,
+                        const std::vector<vector3> &vertex_colors, bool compress,
+                        size_t batch_size, Function on_submesh) {
+        EDYN_ASSERT(batch_size > 0);
+        paged_tri_mesh.m_cache.resize(infos.size());
+        auto batch = std::vector<std::unique_ptr<triangle_mesh>>();
+
+        for (size_t first = 0; first < infos.size(); first += batch_size) {
+            auto last = std::min(first + batch_size, infos.size());
+            batch.resize(last - first);
+
+            for_each_index(first, last, [&] (size_t idx) {
+                batch[idx - first] = build_submesh(idx, global_tri_mesh, vertex_begin, index_begin,
+                                                   vertex_colors, compress);
+            });
+
+            for (size_t idx = first; idx < last; ++idx) {
+                auto &submesh = batch[idx - first];
+                auto &paged_node = paged_tri_mesh.m_cache[idx];
+                paged_node.num_vertices = submesh->num_vertices();
+                paged_node.num_indices = submesh->m_indices.size();
+                on_submesh(idx, *submesh);
+                submesh.reset();
+            }
+
+            // The build info is not needed anymore.
+            for (size_t idx = first; idx < last; ++idx) {
+                infos[idx].ids = {};
+            }
+        }
+
+        // Setup LRU list. No submesh is loaded.
+        paged_tri_mesh.init_cache();
+    }
+
+    template<typename VertexIterator, typename IndexIterator>
+    void build_tree(paged_triangle_mesh &paged_tri_mesh, triangle_mesh &global_tri_mesh,
+                    VertexIterator vertex_begin, VertexIterator vertex_end,
+                    IndexIterator index_begin, IndexIterator index_end,
+                    size_t max_tri_per_submesh) {
+        // Only allowed to create a mesh if this instance is empty.
+        EDYN_ASSERT(paged_tri_mesh.m_tree.empty() && paged_tri_mesh.m_cache.empty());
+
+        auto num_indices = static_cast<size_t>(std::distance(index_begin, index_end));
+        auto num_triangles = num_indices / 3;
+
+        // Create a `triangle_mesh` containing the full list of vertices and indices
+        // and then break it up into smaller meshes.
+        global_tri_mesh.insert_vertices(vertex_begin, vertex_end);
+        global_tri_mesh.insert_indices(index_begin, index_end);
+
+        // Calculate AABB of each triangle.
+        std::vector<AABB> aabbs(num_triangles);
+
+        for_each_index(0, num_triangles, [&] (size_t i) {
+            auto verts = triangle_vertices{
+                *(vertex_begin + *(index_begin + (i * 3 + 0))),
+                *(vertex_begin + *(index_begin + (i * 3 + 1))),
+                *(vertex_begin + *(index_begin + (i * 3 + 2)))
+            };
+            aabbs[i] = get_triangle_aabb(verts);
+        });
+
+        // The global mesh is only used as a source of normals and adjacency
+        // information for the submeshes thus its triangle tree is not needed.
+        // Its initialization does not depend on the tree of submeshes, so
+        // both are built at the same time.
+        for_each_index(0, 2, [&] (size_t i) {
+            if (i == 0) {
+                global_tri_mesh.calculate_face_normals();
+                global_tri_mesh.init_edge_indices();
+                global_tri_mesh.calculate_adjacent_normals();
+            } else if (num_triangles > 0) {
+                // An empty mesh has an empty tree and no submeshes.
+                paged_tri_mesh.m_tree.build(aabbs.begin(), aabbs.end(), *this, max_tri_per_submesh);
+            }
+        });
     }
 };
 } // namespace detail
@@ -182,6 +298,8 @@ struct submesh_builder {
  * @param index_begin Begin iterator for the index list.
  * @param index_end End iterator for the index list.
  * @param max_tri_per_submesh Maximum number of triangles for submeshes.
+ * @param compress Whether to compress each submesh, quantizing its vertex
+ * positions relative to the submesh AABB. See `triangle_mesh::compress`.
  */
 template<typename VertexIterator, typename IndexIterator>
 void create_paged_triangle_mesh(
@@ -189,44 +307,56 @@ void create_paged_triangle_mesh(
         VertexIterator vertex_begin, VertexIterator vertex_end,
         IndexIterator index_begin, IndexIterator index_end,
         size_t max_tri_per_submesh,
-        const std::vector<vector3> &vertex_colors) {
-
-    // Only allowed to create a mesh if this instance is empty.
-    EDYN_ASSERT(paged_tri_mesh.m_tree.empty() && paged_tri_mesh.m_cache.empty());
-
-    auto num_indices = static_cast<size_t>(std::distance(index_begin, index_end));
-    auto num_triangles = num_indices / 3;
-
-    // Create a `triangle_mesh` containing the full list of vertices and indices
-    // and then break it up into smaller meshes.
-    auto global_tri_mesh = triangle_mesh{};
-    global_tri_mesh.insert_vertices(vertex_begin, vertex_end);
-    global_tri_mesh.insert_indices(index_begin, index_end);
-    global_tri_mesh.initialize();
-
-    // Calculate AABB of each triangle.
-    std::vector<AABB> aabbs(num_triangles);
-
-    parallel_for(size_t{0}, num_triangles, [&] (size_t i) {
-        auto verts = triangle_vertices{
-            *(vertex_begin + *(index_begin + (i * 3 + 0))),
-            *(vertex_begin + *(index_begin + (i * 3 + 1))),
-            *(vertex_begin + *(index_begin + (i * 3 + 2)))
-        };
-        aabbs[i] = get_triangle_aabb(verts);
-    });
+        const std::vector<vector3> &vertex_colors,
+        bool compress = false) {
 
     // Build tree and submeshes.
+    auto global_tri_mesh = triangle_mesh{};
     auto builder = detail::submesh_builder{};
-    paged_tri_mesh.m_tree.build(aabbs.begin(), aabbs.end(), builder, max_tri_per_submesh);
-    builder.build(paged_tri_mesh, global_tri_mesh, vertex_begin, index_begin, vertex_colors);
+    builder.build_tree(paged_tri_mesh, global_tri_mesh, vertex_begin, vertex_end,
+                       index_begin, index_end, max_tri_per_submesh);
+    builder.build(paged_tri_mesh, global_tri_mesh, vertex_begin, index_begin,
+                  vertex_colors, compress);
+}
 
-    // Resize LRU queue to have the number of leaves.
-    paged_tri_mesh.m_lru_indices.resize(paged_tri_mesh.m_cache.size());
-    std::iota(paged_tri_mesh.m_lru_indices.begin(),
-              paged_tri_mesh.m_lru_indices.end(), 0);
+/**
+ * Creates a paged triangle mesh from a list of vertices and indices without
+ * keeping the submeshes in memory. Submeshes are built in parallel in batches
+ * and handed over to `on_submesh` in order, e.g. to be written to a file,
+ * thus peak memory usage is bounded by the size of a batch besides the full
+ * mesh itself. The submeshes are equal to the ones created by
+ * `create_paged_triangle_mesh`. When done, no submesh is loaded in the paged
+ * triangle mesh.
+ * @tparam VertexIterator Vertex iterator type.
+ * @tparam IndexIterator Index iterator type.
+ * @tparam Function Type of submesh callback.
+ * @param vertex_begin Begin iterator for the vertex list.
+ * @param vertex_end End iterator for the vertex list.
+ * @param index_begin Begin iterator for the index list.
+ * @param index_end End iterator for the index list.
+ * @param max_tri_per_submesh Maximum number of triangles for submeshes.
+ * @param max_submeshes_in_memory Maximum number of submeshes built at once.
+ * @param on_submesh Function called for each submesh in order. Expected
+ * signature `void(size_t index, triangle_mesh &)`.
+ * @param compress Whether to compress each submesh before it's handed over.
+ */
+template<typename VertexIterator, typename IndexIterator, typename Function>
+void create_paged_triangle_mesh_streamed(
+        paged_triangle_mesh &paged_tri_mesh,
+        VertexIterator vertex_begin, VertexIterator vertex_end,
+        IndexIterator index_begin, IndexIterator index_end,
+        size_t max_tri_per_submesh,
+        const std::vector<vector3> &vertex_colors,
+        size_t max_submeshes_in_memory,
+        Function on_submesh,
+        bool compress = false) {
 
-    paged_tri_mesh.m_is_loading_submesh = std::make_unique<std::atomic<bool>[]>(paged_tri_mesh.m_cache.size());
+    auto global_tri_mesh = triangle_mesh{};
+    auto builder = detail::submesh_builder{};
+    builder.build_tree(paged_tri_mesh, global_tri_mesh, vertex_begin, vertex_end,
+                       index_begin, index_end, max_tri_per_submesh);
+    builder.build_streamed(paged_tri_mesh, global_tri_mesh, vertex_begin, index_begin,
+                           vertex_colors, compress, max_submeshes_in_memory, on_submesh);
 }
 
 }
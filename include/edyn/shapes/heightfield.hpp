@@ -0,0 +1,340 @@
+#ifndef EDYN_SHAPES_HEIGHTFIELD_HPP
+#define EDYN_SHAPES_HEIGHTFIELD_HPP
+
+#include <array>
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "edyn/config/config.h"
+#include "edyn/math/math.hpp"
+#include "edyn/math/vector2.hpp"
+#include "edyn/math/vector3.hpp"
+#include "edyn/comp/aabb.hpp"
+#include "edyn/util/triangle_util.hpp"
+
+namespace edyn {
+
+/**
+ * @brief A regular grid of height samples laid out on the xz plane with
+ * heights along the y axis. Each cell between four samples is split into two
+ * triangles along the diagonal that goes from the first sample to the
+ * opposite one. Triangles, edges and their adjacency are implicit in the
+ * grid, thus only the heights are stored and the triangles near a region
+ * are found by indexing cells directly, without a tree.
+ *
+ * Sample indices are `row * num_columns + column`, where columns are along
+ * the x axis and rows are along the z axis. Triangle indices are
+ * `2 * (row * (num_columns - 1) + column) + k` where `k` is zero for the
+ * triangle which contains the cell edge parallel to the z axis at `column`
+ * and one for the triangle which contains the cell edge parallel to the x
+ * axis at `row`.
+ */
+class heightfield {
+public:
+    using index_type = uint32_t;
+
+    heightfield() = default;
+
+    /**
+     * @brief Creates a height field.
+     * @param num_columns Number of samples along the x axis. At least 2.
+     * @param num_rows Number of samples along the z axis. At least 2.
+     * @param cell_size Distance between samples along the x and z axes.
+     * @param origin Position of the first sample at zero height.
+     * @param heights Height of each sample, with `num_columns * num_rows`
+     * elements in row-major order.
+     */
+    heightfield(size_t num_columns, size_t num_rows, const vector2 &cell_size,
+                const vector3 &origin, std::vector<scalar> heights);
+
+    size_t num_columns() const {
+        return m_num_columns;
+    }
+
+    size_t num_rows() const {
+        return m_num_rows;
+    }
+
+    vector2 get_cell_size() const {
+        return m_cell_size;
+    }
+
+    vector3 get_origin() const {
+        return m_origin;
+    }
+
+    size_t num_vertices() const {
+        return m_heights.size();
+    }
+
+    size_t num_edges() const {
+        return m_diagonal_edges_offset + num_cells();
+    }
+
+    size_t num_cells() const {
+        return (m_num_columns - 1) * (m_num_rows - 1);
+    }
+
+    size_t num_triangles() const {
+        return num_cells() * 2;
+    }
+
+    AABB get_aabb() const {
+        return m_aabb;
+    }
+
+    scalar get_height(size_t column, size_t row) const {
+        EDYN_ASSERT(column < m_num_columns && row < m_num_rows);
+        return m_heights[row * m_num_columns + column];
+    }
+
+    vector3 get_vertex_position(size_t vertex_idx) const {
+        EDYN_ASSERT(vertex_idx < m_heights.size());
+        auto column = vertex_idx % m_num_columns;
+        auto row = vertex_idx / m_num_columns;
+        return m_origin + vector3{scalar(column) * m_cell_size.x,
+                                  m_heights[vertex_idx],
+                                  scalar(row) * m_cell_size.y};
+    }
+
+    index_type get_face_vertex_index(size_t tri_idx, size_t vertex_idx) const {
+        EDYN_ASSERT(vertex_idx < 3);
+        return get_triangle_vertex_indices(tri_idx)[vertex_idx];
+    }
+
+    std::array<index_type, 3> get_triangle_vertex_indices(size_t tri_idx) const;
+
+    triangle_vertices get_triangle_vertices(size_t tri_idx) const {
+        auto indices = get_triangle_vertex_indices(tri_idx);
+        return {
+            get_vertex_position(indices[0]),
+            get_vertex_position(indices[1]),
+            get_vertex_position(indices[2])
+        };
+    }
+
+    vector3 get_triangle_normal(size_t tri_idx) const {
+        auto vertices = get_triangle_vertices(tri_idx);
+        return normalize(cross(vertices[1] - vertices[0], vertices[2] - vertices[0]));
+    }
+
+    index_type get_face_edge_index(size_t tri_idx, size_t edge_idx) const;
+
+    std::array<index_type, 2> get_edge_vertex_indices(size_t edge_idx) const;
+
+    std::array<vector3, 2> get_edge_vertices(size_t edge_idx) const {
+        auto indices = get_edge_vertex_indices(edge_idx);
+        return {get_vertex_position(indices[0]), get_vertex_position(indices[1])};
+    }
+
+    /**
+     * @brief Indices of the two triangles that share an edge. Edges on the
+     * border of the grid have the same value for both triangles.
+     */
+    std::array<index_type, 2> get_edge_face_indices(size_t edge_idx) const;
+
+    bool is_boundary_edge(size_t edge_idx) const {
+        auto face_indices = get_edge_face_indices(edge_idx);
+        return face_indices[0] == face_indices[1];
+    }
+
+    bool is_convex_edge(size_t edge_idx) const;
+
+    vector3 get_adjacent_face_normal(size_t tri_idx, size_t edge_idx) const;
+
+    /**
+     * @brief Visits all triangles in the cells that overlap the given AABB
+     * along the xz plane and whose AABB intersects it.
+     * @param aabb The query AABB.
+     * @param func Function with signature `void(index_type tri_idx)`.
+     */
+    template<typename Func>
+    void visit_triangles(const AABB &aabb, Func func) const {
+        size_t col_begin, col_end, row_begin, row_end;
+
+        if (!get_cell_range(aabb, col_begin, col_end, row_begin, row_end)) {
+            return;
+        }
+
+        for (auto row = row_begin; row < row_end; ++row) {
+            for (auto col = col_begin; col < col_end; ++col) {
+                auto cell_idx = row * (m_num_columns - 1) + col;
+
+                for (index_type k = 0; k < 2; ++k) {
+                    auto tri_idx = static_cast<index_type>(cell_idx * 2 + k);
+                    auto tri_aabb = get_triangle_aabb(get_triangle_vertices(tri_idx));
+
+                    if (intersect(tri_aabb, aabb)) {
+                        func(tri_idx);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Visits triangles that intersect `query_aabb` skipping those that
+     * are separated by more than `threshold` along their normal from a shape
+     * bounded by `shape_aabb`. Same as `triangle_mesh::visit_triangles_culled`.
+     * @param func Function with signature
+     * `void(index_type tri_idx, const triangle_vertices &, const vector3 &normal)`.
+     */
+    template<typename Func>
+    void visit_triangles_culled(const AABB &query_aabb, const AABB &shape_aabb,
+                                scalar threshold, Func func) const {
+        size_t col_begin, col_end, row_begin, row_end;
+
+        if (!get_cell_range(query_aabb, col_begin, col_end, row_begin, row_end)) {
+            return;
+        }
+
+        const auto center = shape_aabb.center();
+        const auto half_extents = (shape_aabb.max - shape_aabb.min) * scalar(0.5);
+
+        for (auto row = row_begin; row < row_end; ++row) {
+            for (auto col = col_begin; col < col_end; ++col) {
+                auto cell_idx = row * (m_num_columns - 1) + col;
+
+                for (index_type k = 0; k < 2; ++k) {
+                    auto tri_idx = static_cast<index_type>(cell_idx * 2 + k);
+                    auto vertices = get_triangle_vertices(tri_idx);
+
+                    if (!intersect(get_triangle_aabb(vertices), query_aabb)) {
+                        continue;
+                    }
+
+                    auto normal = normalize(cross(vertices[1] - vertices[0], vertices[2] - vertices[0]));
+                    auto radius = dot(abs(normal), half_extents);
+                    auto dist = dot(center - vertices[0], normal) - radius;
+
+                    if (dist <= threshold) {
+                        func(tri_idx, vertices, normal);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Visits the triangles in all cells crossed by the segment
+     * `p0`-`p1` along the xz plane, in order of distance from `p0`.
+     * @param func Function with signature `void(index_type tri_idx)`.
+     */
+    template<typename Func>
+    void raycast(const vector3 &p0, const vector3 &p1, Func func) const {
+        // Clip segment against the AABB of the height field and walk
+        // through the cells it crosses in the xz plane.
+        scalar t_min = 0, t_max = 1;
+        auto dir = p1 - p0;
+
+        for (auto i = 0; i < 3; ++i) {
+            if (std::abs(dir[i]) < EDYN_EPSILON) {
+                if (p0[i] < m_aabb.min[i] || p0[i] > m_aabb.max[i]) {
+                    return;
+                }
+            } else {
+                auto inv_dir = scalar(1) / dir[i];
+                auto t0 = (m_aabb.min[i] - p0[i]) * inv_dir;
+                auto t1 = (m_aabb.max[i] - p0[i]) * inv_dir;
+
+                if (t0 > t1) {
+                    std::swap(t0, t1);
+                }
+
+                t_min = std::max(t_min, t0);
+                t_max = std::min(t_max, t1);
+
+                if (t_min > t_max) {
+                    return;
+                }
+            }
+        }
+
+        // Coordinates in cell units.
+        auto start = p0 + dir * t_min - m_origin;
+        auto start_x = start.x / m_cell_size.x;
+        auto start_z = start.z / m_cell_size.y;
+        auto max_col = static_cast<int64_t>(m_num_columns) - 2;
+        auto max_row = static_cast<int64_t>(m_num_rows) - 2;
+        auto col = std::clamp(static_cast<int64_t>(std::floor(start_x)), int64_t{0}, max_col);
+        auto row = std::clamp(static_cast<int64_t>(std::floor(start_z)), int64_t{0}, max_row);
+
+        auto dir_x = dir.x / m_cell_size.x;
+        auto dir_z = dir.z / m_cell_size.y;
+        int64_t step_col = dir_x > 0 ? 1 : -1;
+        int64_t step_row = dir_z > 0 ? 1 : -1;
+
+        // Value of `t` at which the next column or row boundary is crossed
+        // and the increment in `t` to cross one cell.
+        auto t_next_col = EDYN_SCALAR_MAX, t_delta_col = EDYN_SCALAR_MAX;
+        auto t_next_row = EDYN_SCALAR_MAX, t_delta_row = EDYN_SCALAR_MAX;
+
+        if (std::abs(dir_x) > EDYN_EPSILON) {
+            auto boundary = scalar(col + (step_col > 0 ? 1 : 0));
+            t_next_col = t_min + (boundary - start_x) / dir_x;
+            t_delta_col = std::abs(scalar(1) / dir_x);
+        }
+
+        if (std::abs(dir_z) > EDYN_EPSILON) {
+            auto boundary = scalar(row + (step_row > 0 ? 1 : 0));
+            t_next_row = t_min + (boundary - start_z) / dir_z;
+            t_delta_row = std::abs(scalar(1) / dir_z);
+        }
+
+        while (true) {
+            auto cell_idx = static_cast<size_t>(row) * (m_num_columns - 1) + static_cast<size_t>(col);
+            func(static_cast<index_type>(cell_idx * 2));
+            func(static_cast<index_type>(cell_idx * 2 + 1));
+
+            if (t_next_col < t_next_row) {
+                if (t_next_col > t_max) {
+                    break;
+                }
+
+                col += step_col;
+                t_next_col += t_delta_col;
+
+                if (col < 0 || col > max_col) {
+                    break;
+                }
+            } else {
+                if (t_next_row > t_max) {
+                    break;
+                }
+
+                row += step_row;
+                t_next_row += t_delta_row;
+
+                if (row < 0 || row > max_row) {
+                    break;
+                }
+            }
+        }
+    }
+
+private:
+    // Calculates the range of cells that overlap the given AABB in the xz
+    // plane. Returns false if there's no overlap.
+    bool get_cell_range(const AABB &aabb, size_t &col_begin, size_t &col_end,
+                        size_t &row_begin, size_t &row_end) const;
+
+    size_t m_num_columns {0};
+    size_t m_num_rows {0};
+    vector2 m_cell_size {vector2_one};
+    vector3 m_origin {vector3_zero};
+
+    // Height of each sample in row-major order.
+    std::vector<scalar> m_heights;
+
+    AABB m_aabb;
+
+    // Edges are numbered starting with the edges parallel to the x axis,
+    // followed by the edges parallel to the z axis, and then the diagonals.
+    size_t m_z_edges_offset {0};
+    size_t m_diagonal_edges_offset {0};
+};
+
+}
+
+#endif // EDYN_SHAPES_HEIGHTFIELD_HPP
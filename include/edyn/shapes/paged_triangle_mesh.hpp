@@ -2,9 +2,11 @@
 #define EDYN_SHAPES_PAGED_TRIANGLE_MESH_HPP
 
 #include <mutex>
+#include <string>
 #include <vector>
 #include <atomic>
 #include <memory>
+#include <cstdint>
 #include "edyn/math/constants.hpp"
 #include "edyn/shapes/triangle_mesh.hpp"
 #include "edyn/shapes/triangle_mesh_page_loader.hpp"
@@ -13,6 +15,7 @@ namespace edyn {
 
 class paged_triangle_mesh_file_input_archive;
 class paged_triangle_mesh_file_output_archive;
+class paged_triangle_mesh_mapped_loader;
 class finish_load_mesh_job;
 
 // Forward declaration of `detail::submesh_builder` needed by `friend`
@@ -31,6 +34,8 @@ public:
         size_t num_indices;
         // Triangle mesh pointer. Will be nullptr if mesh is not loaded.
         std::shared_ptr<triangle_mesh> trimesh;
+        // Memory used by the triangle mesh when it was assigned.
+        size_t num_bytes {0};
     };
 
     paged_triangle_mesh(std::shared_ptr<triangle_mesh_page_loader_base> loader);
@@ -52,6 +57,9 @@ public:
             if (m_cache[mesh_idx].trimesh) {
                 func(mesh_idx);
                 mark_recent_visit(mesh_idx);
+                m_num_hits.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                m_num_misses.fetch_add(1, std::memory_order_relaxed);
             }
         });
     }
@@ -96,6 +104,9 @@ public:
                     func(mesh_idx, tri_idx);
                 });
                 mark_recent_visit(mesh_idx);
+                m_num_hits.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                m_num_misses.fetch_add(1, std::memory_order_relaxed);
             }
         });
     }
@@ -168,6 +179,9 @@ public:
                     func(mesh_idx, tri_idx);
                 });
                 mark_recent_visit(mesh_idx);
+                m_num_hits.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                m_num_misses.fetch_add(1, std::memory_order_relaxed);
             }
         });
     }
@@ -194,6 +208,42 @@ public:
         });
     }
 
+    /**
+     * @brief Starts loading submeshes which intersect the given AABB without
+     * visiting them, so they're likely in the cache by the time a query
+     * touches them. Submeshes that are already in the cache are marked as
+     * recently visited to prevent them from being unloaded in the meantime.
+     * @param aabb Query AABB.
+     */
+    void prefetch(const AABB &aabb);
+
+    /**
+     * @brief Prefetches submeshes in the region swept by an AABB moving with
+     * constant velocity for the given amount of time.
+     * @param aabb Current AABB.
+     * @param velocity Linear velocity of the AABB.
+     * @param time Look-ahead time, usually a few fixed steps.
+     */
+    void prefetch(const AABB &aabb, const vector3 &velocity, scalar time);
+
+    /**
+     * @brief Cache statistics accumulated since the last call to `reset_stats`.
+     */
+    struct cache_stats {
+        // Number of submeshes visited in a query which were in the cache.
+        size_t hits;
+        // Number of submeshes visited in a query which were not in the cache,
+        // thus had to be skipped while they're loaded.
+        size_t misses;
+        // Number of submeshes whose loading was started by a prefetch.
+        size_t prefetches;
+        // Number of submeshes unloaded to keep the cache within budget.
+        size_t evictions;
+    };
+
+    cache_stats get_stats() const;
+    void reset_stats();
+
     /**
      * @brief Get AABB of entire mesh.
      * @return AABB of mesh.
@@ -208,6 +258,14 @@ public:
      */
     size_t cache_num_vertices() const;
 
+    /**
+     * @brief Returns the memory used by the submeshes currently in the cache.
+     * @return The size of the cache in bytes.
+     */
+    size_t cache_num_bytes() const {
+        return m_cache_num_bytes.load(std::memory_order_relaxed);
+    }
+
     size_t num_submeshes() const {
         return m_cache.size();
     }
@@ -230,20 +288,13 @@ public:
     bool has_per_vertex_restitution() const;
 
     /**
-     * @brief Maximum number of vertices in the cache. Before a new triangle mesh
-     * is loaded, if the number of vertices would exceed this number, the
-     * least recently visited nodes will be unloaded until the new total
-     * number of vertices stays below this value.
+     * @brief Maximum memory used by the submeshes in the cache, in bytes, as
+     * given by `triangle_mesh::memory_usage`, which includes the triangle
+     * tree and adjacency information. When a submesh finishes loading, if
+     * the cache would exceed this size, the least recently visited submeshes
+     * will be unloaded until it stays below this value.
      */
-    size_t m_max_cache_num_vertices = 1 << 13;
-
-    template<typename VertexIterator, typename IndexIterator>
-    friend void create_paged_triangle_mesh(
-            paged_triangle_mesh &paged_tri_mesh,
-            VertexIterator vertex_begin, VertexIterator vertex_end,
-            IndexIterator index_begin, IndexIterator index_end,
-            size_t max_tri_per_submesh,
-            const std::vector<vector3> &vertex_colors);
+    size_t m_max_cache_num_bytes = size_t(1) << 22;
 
     friend struct detail::submesh_builder;
 
@@ -253,20 +304,64 @@ public:
     friend void serialize(paged_triangle_mesh_file_output_archive &archive,
                           paged_triangle_mesh &paged_tri_mesh);
 
+    friend void begin_streamed_serialize(paged_triangle_mesh_file_output_archive &archive,
+                                         paged_triangle_mesh &paged_tri_mesh);
+
+    friend void end_streamed_serialize(paged_triangle_mesh_file_output_archive &archive,
+                                       paged_triangle_mesh &paged_tri_mesh,
+                                       const std::vector<size_t> &submesh_sizes);
+
     friend void serialize(paged_triangle_mesh_file_input_archive &archive,
                           paged_triangle_mesh &paged_tri_mesh);
 
+    friend bool write_paged_triangle_mesh_mapped(const std::string &path,
+                                                 paged_triangle_mesh &paged_tri_mesh);
+
+    friend void serialize(paged_triangle_mesh_mapped_loader &loader,
+                          paged_triangle_mesh &paged_tri_mesh);
+
 private:
-    void load_node_if_needed(size_t trimesh_idx);
+    // Allocates the LRU list and per-submesh state once the submeshes are
+    // known and inserts the submeshes that are already loaded into the list.
+    void init_cache();
+    // Returns true if the node started loading in this call.
+    bool load_node_if_needed(size_t trimesh_idx);
     void mark_recent_visit(size_t trimesh_idx);
-    void unload_least_recently_visited_node();
+    // These must be called with `m_lru_mutex` locked.
+    void lru_push_front(size_t trimesh_idx);
+    void lru_unlink(size_t trimesh_idx);
+    bool unload_least_recently_visited_node(size_t keep_idx);
+
+    constexpr static size_t null_lru_index = SIZE_MAX;
+
+    // Links of the intrusive doubly linked list of loaded submeshes, ordered
+    // from most to least recently visited.
+    struct lru_entry {
+        size_t prev {null_lru_index};
+        size_t next {null_lru_index};
+        // Value of the visit stamp when this entry was moved to the front.
+        uint64_t stamp {0};
+    };
 
     static_tree m_tree;
     std::vector<triangle_mesh_node> m_cache;
-    std::vector<size_t> m_lru_indices;
+    std::vector<lru_entry> m_lru_entries;
+    size_t m_lru_head {null_lru_index};
+    size_t m_lru_tail {null_lru_index};
     std::mutex m_lru_mutex;
+    // Visits only store a new stamp for the submesh, without locking. The
+    // LRU list is brought up to date lazily during eviction, where entries
+    // stamped after they were moved to the front get another chance.
+    std::unique_ptr<std::atomic<uint64_t>[]> m_visit_stamps;
+    std::atomic<uint64_t> m_visit_clock {0};
+    std::atomic<size_t> m_cache_num_bytes {0};
     std::unique_ptr<std::atomic<bool>[]> m_is_loading_submesh;
     std::shared_ptr<triangle_mesh_page_loader_base> m_page_loader;
+
+    std::atomic<size_t> m_num_hits {0};
+    std::atomic<size_t> m_num_misses {0};
+    std::atomic<size_t> m_num_prefetches {0};
+    std::atomic<size_t> m_num_evictions {0};
 };
 
 }
@@ -22,7 +22,9 @@ struct polyhedron_shape {
 
     /**
      * A rotated mesh which serves as a cache where the rotated vertex positions
-     * and face normals are stored after each step of the simulation. This has
+     * and face normals are stored. It is updated at most once per step of the
+     * simulation, when the polyhedron is first needed in the narrowphase (see
+     * `update_rotated_mesh_if_outdated`). This has
      * to be unique for each entity, unlike the `mesh` which can be shared,
      * since this reflects the unique orientation of the rigid body.
      * Since this is modified by the island worker, it's not safe to access it
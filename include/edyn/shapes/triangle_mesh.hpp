@@ -2,16 +2,20 @@
 #define EDYN_SHAPES_TRIANGLE_MESH_HPP
 
 #include <vector>
+#include <memory>
 #include <cstdint>
 #include "edyn/config/config.h"
 #include "edyn/math/math.hpp"
 #include "edyn/math/vector3.hpp"
 #include "edyn/math/geom.hpp"
+#include "edyn/math/quantization.hpp"
 #include "edyn/comp/aabb.hpp"
 #include "edyn/util/triangle_util.hpp"
 #include "edyn/collision/static_tree.hpp"
+#include "edyn/shapes/triangle_mesh_soa.hpp"
 #include "edyn/util/unordered_pair.hpp"
 #include "edyn/util/flat_nested_array.hpp"
+#include "edyn/util/mappable_vector.hpp"
 
 namespace edyn {
 
@@ -19,6 +23,8 @@ namespace detail {
     struct submesh_builder;
 }
 
+class paged_triangle_mesh_mapped_loader;
+
 /**
  * @brief A triangle mesh. Includes adjacency information and a tree to
  * accelerate closest point queries.
@@ -31,6 +37,46 @@ public:
     void calculate_adjacent_normals();
     void build_triangle_tree();
 
+    /**
+     * @brief Builds the optional structure-of-arrays layout which accelerates
+     * `visit_triangles_culled`. Must be called after the mesh is initialized.
+     */
+    void build_soa_layout();
+
+    bool has_soa_layout() const {
+        return m_soa != nullptr;
+    }
+
+    /**
+     * @brief Replaces vertex positions and normals by a compressed
+     * representation which is decoded on access. Vertex positions are stored
+     * as 16-bit integers relative to the mesh AABB and normals are packed
+     * into 32 bits using an octahedral mapping. The triangle tree is rebuilt
+     * using the decoded positions. Must be called after the mesh is
+     * initialized.
+     */
+    void compress();
+
+    bool is_compressed() const {
+        return m_compressed;
+    }
+
+    /**
+     * @brief Whether the data of this mesh is stored elsewhere, such as in a
+     * memory mapped file, and only referenced by this mesh. Mapped meshes
+     * cannot be modified.
+     */
+    bool is_mapped() const {
+        return m_indices.is_mapped();
+    }
+
+    /**
+     * @brief Number of bytes allocated for the data of this mesh, including
+     * adjacency information, the triangle tree and the structure-of-arrays
+     * layout if present. Mapped data is not included.
+     */
+    size_t memory_usage() const;
+
 public:
     using index_type = uint32_t;
 
@@ -63,7 +109,7 @@ public:
     }
 
     size_t num_vertices() const {
-        return m_vertices.size();
+        return m_compressed ? m_quantized_vertices.size() : m_vertices.size();
     }
 
     size_t num_edges() const {
@@ -78,23 +124,48 @@ public:
         return m_triangle_tree.root_aabb();
     }
 
+    /**
+     * @brief Contiguous vertex positions. Null if compressed.
+     */
+    const vector3 * get_vertex_data() const {
+        return m_vertices.data();
+    }
+
+    /**
+     * @brief Contiguous vertex indices of all triangles.
+     */
+    const std::array<index_type, 3> * get_index_data() const {
+        return m_indices.data();
+    }
+
     vector3 get_vertex_position(size_t vertex_idx) const {
-        EDYN_ASSERT(vertex_idx < m_vertices.size());
+        EDYN_ASSERT(vertex_idx < num_vertices());
+
+        if (m_compressed) {
+            return dequantize_position(m_quantized_vertices[vertex_idx],
+                                       m_quantization_origin, m_quantization_scale);
+        }
+
         return m_vertices[vertex_idx];
     }
 
     triangle_vertices get_triangle_vertices(size_t tri_idx) const;
 
     vector3 get_triangle_normal(size_t tri_idx) const {
-        EDYN_ASSERT(tri_idx < m_normals.size());
+        EDYN_ASSERT(tri_idx < m_indices.size());
+
+        if (m_compressed) {
+            return unpack_unit_vector_octahedral(m_packed_normals[tri_idx]);
+        }
+
         return m_normals[tri_idx];
     }
 
     std::array<vector3, 2> get_edge_vertices(size_t edge_idx) const {
         EDYN_ASSERT(edge_idx < m_edge_vertex_indices.size());
         return {
-            m_vertices[m_edge_vertex_indices[edge_idx][0]],
-            m_vertices[m_edge_vertex_indices[edge_idx][1]]
+            get_vertex_position(m_edge_vertex_indices[edge_idx][0]),
+            get_vertex_position(m_edge_vertex_indices[edge_idx][1])
         };
     }
 
@@ -119,15 +190,41 @@ public:
         });
     }
 
+    /**
+     * @brief Visits triangles that intersect `query_aabb` skipping those that
+     * are separated by more than `threshold` along their normal from a shape
+     * bounded by `shape_aabb`. If the structure-of-arrays layout has been
+     * built, the test is performed for all triangles of a tree leaf at once.
+     * @param func Function with signature
+     * `void(uint32_t tri_idx, const triangle_vertices &, const vector3 &normal)`.
+     */
+    template<typename Func>
+    void visit_triangles_culled(const AABB &query_aabb, const AABB &shape_aabb,
+                                scalar threshold, Func func) const {
+        if (m_soa) {
+            m_soa->visit_triangles(query_aabb, shape_aabb, threshold, func);
+            return;
+        }
+
+        const auto center = shape_aabb.center();
+        const auto half_extents = (shape_aabb.max - shape_aabb.min) * scalar(0.5);
+
+        visit_triangles(query_aabb, [&] (uint32_t tri_idx) {
+            auto vertices = get_triangle_vertices(tri_idx);
+            auto normal = get_triangle_normal(tri_idx);
+            auto radius = dot(abs(normal), half_extents);
+            auto dist = dot(center - vertices[0], normal) - radius;
+
+            if (dist <= threshold) {
+                func(tri_idx, vertices, normal);
+            }
+        });
+    }
+
     template<typename Func>
     void visit_all(Func func) const {
         for (size_t i = 0; i < num_triangles(); ++i) {
-            auto verts = triangle_vertices{
-                m_vertices[m_indices[i][0]],
-                m_vertices[m_indices[i][1]],
-                m_vertices[m_indices[i][2]]
-            };
-
+            auto verts = get_triangle_vertices(i);
             func(i, verts);
         }
     }
@@ -163,8 +260,13 @@ public:
     }
 
     vector3 get_adjacent_face_normal(size_t tri_idx, size_t edge_idx) const {
-        EDYN_ASSERT(tri_idx < m_adjacent_normals.size());
+        EDYN_ASSERT(tri_idx < m_indices.size());
         EDYN_ASSERT(edge_idx < 3);
+
+        if (m_compressed) {
+            return unpack_unit_vector_octahedral(m_packed_adjacent_normals[tri_idx][edge_idx]);
+        }
+
         return m_adjacent_normals[tri_idx][edge_idx];
     }
 
@@ -186,48 +288,65 @@ public:
     friend void serialize(Archive &, triangle_mesh &);
     friend size_t serialization_sizeof(const triangle_mesh &);
     friend struct detail::submesh_builder;
+    friend class paged_triangle_mesh_mapped_loader;
 
 private:
     // Vertex positions.
-    std::vector<vector3> m_vertices;
+    mappable_vector<vector3> m_vertices;
 
     // Vertex indices for each triangular face. Each element represents the
     // vertex indices of one triangle.
-    std::vector<std::array<index_type, 3>> m_indices;
+    mappable_vector<std::array<index_type, 3>> m_indices;
 
     // Face normals.
-    std::vector<vector3> m_normals;
+    mappable_vector<vector3> m_normals;
 
     // Normal vector of adjacent faces which share an edge with the i-th face.
-    std::vector<std::array<vector3, 3>> m_adjacent_normals;
+    mappable_vector<std::array<vector3, 3>> m_adjacent_normals;
 
     // Vertex indices for each unique edge. Each pair of values represent the
     // vertex indices for one edge.
-    std::vector<unordered_pair<index_type>> m_edge_vertex_indices;
+    mappable_vector<unordered_pair<index_type>> m_edge_vertex_indices;
 
     // Indices of edges for each vertex. Each element is a list of indices of
     // edges that share the vertex.
     flat_nested_array<index_type> m_vertex_edge_indices;
 
     // Each element represents the indices of the three edges of a face.
-    std::vector<std::array<index_type, 3>> m_face_edge_indices;
+    mappable_vector<std::array<index_type, 3>> m_face_edge_indices;
 
     // Indices of the two faces that share the i-th edge. Perimetral edges will
     // have the same value for both faces.
-    std::vector<std::array<index_type, 2>> m_edge_face_indices;
+    mappable_vector<std::array<index_type, 2>> m_edge_face_indices;
 
     // Indicates whether an edge is at the boundary. These edges are associated
     // with a single triangle.
-    std::vector<bool> m_is_boundary_edge;
+    mappable_vector<bool> m_is_boundary_edge;
 
     // Whether an edge is convex.
-    std::vector<bool> m_is_convex_edge;
+    mappable_vector<bool> m_is_convex_edge;
 
     // Per-vertex friction and restitution coefficients.
-    std::vector<scalar> m_friction;
-    std::vector<scalar> m_restitution;
+    mappable_vector<scalar> m_friction;
+    mappable_vector<scalar> m_restitution;
 
     static_tree m_triangle_tree;
+
+    // Compressed storage which replaces `m_vertices`, `m_normals` and
+    // `m_adjacent_normals` after `compress()` is called. Positions are
+    // decoded as `origin + quantized * scale`.
+    bool m_compressed {false};
+    vector3 m_quantization_origin {vector3_zero};
+    vector3 m_quantization_scale {vector3_zero};
+    mappable_vector<std::array<uint16_t, 3>> m_quantized_vertices;
+    mappable_vector<uint32_t> m_packed_normals;
+    mappable_vector<std::array<uint32_t, 3>> m_packed_adjacent_normals;
+
+    // Optional compiled layout. Shared between copies since it's immutable.
+    std::shared_ptr<const triangle_mesh_soa> m_soa;
+
+    // Keeps the memory referenced by mapped arrays alive, if any.
+    std::shared_ptr<const void> m_mapped_storage;
 };
 
 }
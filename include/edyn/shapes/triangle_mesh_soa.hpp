@@ -0,0 +1,151 @@
+#ifndef EDYN_SHAPES_TRIANGLE_MESH_SOA_HPP
+#define EDYN_SHAPES_TRIANGLE_MESH_SOA_HPP
+
+#include <array>
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include "edyn/math/vector3.hpp"
+#include "edyn/comp/aabb.hpp"
+#include "edyn/util/triangle_util.hpp"
+#include "edyn/collision/static_tree.hpp"
+
+namespace edyn {
+
+class triangle_mesh;
+
+/**
+ * @brief Compiled structure-of-arrays layout of a `triangle_mesh`. Triangles
+ * are grouped in blocks of `lane_width` elements, one block per leaf of a
+ * dedicated tree, with each attribute stored contiguously per block. This
+ * allows the candidate triangles of a leaf to be culled in a single pass
+ * over the block which compilers can turn into SIMD instructions.
+ */
+class triangle_mesh_soa {
+public:
+    static constexpr size_t lane_width = 8;
+
+    /**
+     * @brief Bits of `triangle_block::edge_flags`. The convex and boundary
+     * flags of the i-th edge of a triangle are shifted left by `i`.
+     */
+    enum edge_flag : uint8_t {
+        edge_flag_convex = 1 << 0,
+        edge_flag_boundary = 1 << 3
+    };
+
+    struct alignas(32) triangle_block {
+        // Vertex positions indexed by vertex, axis and lane.
+        scalar vertices[3][3][lane_width];
+        // Face normals indexed by axis and lane.
+        scalar normals[3][lane_width];
+        // Projection of the first vertex onto the face normal.
+        scalar plane_distance[lane_width];
+        // Minimum and maximum of the triangle AABB indexed by axis and lane.
+        scalar aabb_min[3][lane_width];
+        scalar aabb_max[3][lane_width];
+        // Index of the triangle in the source mesh.
+        uint32_t tri_idx[lane_width];
+        uint8_t edge_flags[lane_width];
+        uint32_t count;
+
+        triangle_vertices get_vertices(size_t lane) const {
+            return {
+                vector3{vertices[0][0][lane], vertices[0][1][lane], vertices[0][2][lane]},
+                vector3{vertices[1][0][lane], vertices[1][1][lane], vertices[1][2][lane]},
+                vector3{vertices[2][0][lane], vertices[2][1][lane], vertices[2][2][lane]}
+            };
+        }
+
+        vector3 get_normal(size_t lane) const {
+            return {normals[0][lane], normals[1][lane], normals[2][lane]};
+        }
+
+        bool is_convex_edge(size_t lane, size_t edge_idx) const {
+            return edge_flags[lane] & (edge_flag_convex << edge_idx);
+        }
+
+        bool is_boundary_edge(size_t lane, size_t edge_idx) const {
+            return edge_flags[lane] & (edge_flag_boundary << edge_idx);
+        }
+    };
+
+    void build(const triangle_mesh &mesh);
+
+    bool empty() const {
+        return m_blocks.empty();
+    }
+
+    size_t num_blocks() const {
+        return m_blocks.size();
+    }
+
+    size_t memory_usage() const {
+        return m_tree.memory_usage() + m_blocks.capacity() * sizeof(triangle_block);
+    }
+
+    /**
+     * @brief Visits all triangles whose AABB intersects `query_aabb` and
+     * which are not rejected by the plane distance test, i.e. the shape
+     * bounded by `shape_aabb` is not further than `threshold` in front of
+     * the triangle plane.
+     * @param query_aabb The AABB to visit.
+     * @param shape_aabb Bounds of the shape colliding with the mesh.
+     * @param threshold Maximum separation along the triangle normal.
+     * @param func Function with signature
+     * `void(uint32_t tri_idx, const triangle_vertices &, const vector3 &normal)`.
+     */
+    template<typename Func>
+    void visit_triangles(const AABB &query_aabb, const AABB &shape_aabb,
+                         scalar threshold, Func func) const {
+        const auto center = shape_aabb.center();
+        const auto half_extents = (shape_aabb.max - shape_aabb.min) * scalar(0.5);
+
+        m_tree.query(query_aabb, [&] (auto tree_node_idx) {
+            auto &block = m_blocks[m_tree.get_node(tree_node_idx).id];
+            uint8_t keep[lane_width];
+            cull_block(block, query_aabb, center, half_extents, threshold, keep);
+
+            for (size_t lane = 0; lane < block.count; ++lane) {
+                if (keep[lane]) {
+                    func(block.tri_idx[lane], block.get_vertices(lane), block.get_normal(lane));
+                }
+            }
+        });
+    }
+
+private:
+    // Evaluates all lanes of a block without branches. Padding lanes always
+    // fail the plane test.
+    static void cull_block(const triangle_block &block, const AABB &query_aabb,
+                           const vector3 &center, const vector3 &half_extents,
+                           scalar threshold, uint8_t *keep) {
+        for (size_t i = 0; i < lane_width; ++i) {
+            auto nx = block.normals[0][i];
+            auto ny = block.normals[1][i];
+            auto nz = block.normals[2][i];
+
+            // Minimum projection of the shape AABB onto the triangle normal
+            // minus the projection of the triangle plane.
+            auto proj_center = nx * center.x + ny * center.y + nz * center.z;
+            auto radius = std::abs(nx) * half_extents.x +
+                          std::abs(ny) * half_extents.y +
+                          std::abs(nz) * half_extents.z;
+            auto dist = proj_center - radius - block.plane_distance[i];
+
+            auto overlap =
+                (block.aabb_min[0][i] <= query_aabb.max.x) & (block.aabb_max[0][i] >= query_aabb.min.x) &
+                (block.aabb_min[1][i] <= query_aabb.max.y) & (block.aabb_max[1][i] >= query_aabb.min.y) &
+                (block.aabb_min[2][i] <= query_aabb.max.z) & (block.aabb_max[2][i] >= query_aabb.min.z);
+
+            keep[i] = overlap & (dist <= threshold);
+        }
+    }
+
+    static_tree m_tree;
+    std::vector<triangle_block> m_blocks;
+};
+
+}
+
+#endif // EDYN_SHAPES_TRIANGLE_MESH_SOA_HPP
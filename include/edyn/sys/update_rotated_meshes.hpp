@@ -16,6 +16,25 @@ struct quaternion;
  */
 void update_rotated_meshes(entt::registry &registry);
 
+/**
+ * @brief Marks the rotated meshes of all polyhedron shapes as outdated by
+ * incrementing the rotated mesh version. It does not touch the meshes, which
+ * are then updated on demand via `update_rotated_mesh_if_outdated`. Call this
+ * after orientations change, usually at the end of a step.
+ * @param registry Source of shapes.
+ */
+void invalidate_rotated_meshes(entt::registry &registry);
+
+/**
+ * @brief Updates the rotated mesh of a single entity if it has not been
+ * updated since the last call to `invalidate_rotated_meshes` and its
+ * orientation changed since it was last updated. Does nothing if the entity
+ * does not have a `rotated_mesh_list`.
+ * @param registry Data source.
+ * @param entity Entity to be updated.
+ */
+void update_rotated_mesh_if_outdated(entt::registry &registry, entt::entity entity);
+
 /**
  * @brief Updates the rotated mesh of a single entity, which is assumed to have
  * either a polyhedron or a compound shape.
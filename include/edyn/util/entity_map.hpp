@@ -1,16 +1,158 @@
 #ifndef EDYN_UTIL_ENTITY_MAP_HPP
 #define EDYN_UTIL_ENTITY_MAP_HPP
 
-#include <map>
+#include <limits>
+#include <vector>
+#include <utility>
+#include <stdexcept>
 #include <entt/entity/fwd.hpp>
+#include <entt/entity/entity.hpp>
 
 namespace edyn {
 
+/**
+ * @brief Bidirectional map between entities of two registries. Entries are
+ * kept in a packed array and located via a paged sparse array addressed by
+ * entity index, similarly to `entt::sparse_set`, thus lookups take constant
+ * time while memory is only allocated for the pages that contain mapped
+ * entities and pages are released once they become empty. Iteration and
+ * `erase_if` only visit the mapped entities. The entity version is checked
+ * on lookup, so a recycled entity does not match an entry of a previous
+ * incarnation. As with `std::map::at`, accessing or erasing an entity which
+ * is not mapped throws `std::out_of_range`.
+ */
 class entity_map {
+    // Maps entities in one direction. Entries are packed in `m_entries` and
+    // the position of the entry of an entity is stored in the sparse page
+    // which covers its index.
+    class sparse_map {
+        using entry_type = std::pair<entt::entity, entt::entity>;
+        using page_type = std::vector<size_t>;
+
+        static constexpr size_t page_size = 1024;
+        static constexpr auto null_position = std::numeric_limits<size_t>::max();
+
+        static size_t index_of(entt::entity entity) {
+            return static_cast<size_t>(entt::to_entity(entity));
+        }
+
+        // Returns the slot holding the position of the entry at `index` or
+        // null if its page hasn't been allocated. Pages are empty until an
+        // entity in their range is inserted.
+        const size_t * slot(size_t index) const {
+            auto page = index / page_size;
+
+            if (page < m_pages.size() && !m_pages[page].empty()) {
+                return &m_pages[page][index % page_size];
+            }
+
+            return nullptr;
+        }
+
+        size_t & assure_slot(size_t index) {
+            auto page = index / page_size;
+
+            if (page >= m_pages.size()) {
+                m_pages.resize(page + 1);
+                m_page_counts.resize(page + 1, 0);
+            }
+
+            if (m_pages[page].empty()) {
+                m_pages[page].resize(page_size, null_position);
+            }
+
+            return m_pages[page][index % page_size];
+        }
+
+        // Position of the entry of `key` in `m_entries` or `null_position`
+        // if not mapped.
+        size_t position_of(entt::entity key) const {
+            auto *pos = slot(index_of(key));
+
+            if (pos && *pos != null_position && m_entries[*pos].first == key) {
+                return *pos;
+            }
+
+            return null_position;
+        }
+
+    public:
+        void insert(entt::entity key, entt::entity value) {
+            auto &pos = assure_slot(index_of(key));
+
+            // Replace the entry of an entity with the same index, which might
+            // be a previous incarnation.
+            if (pos != null_position) {
+                m_entries[pos] = entry_type{key, value};
+            } else {
+                pos = m_entries.size();
+                m_entries.emplace_back(key, value);
+                ++m_page_counts[index_of(key) / page_size];
+            }
+        }
+
+        void erase(entt::entity key) {
+            auto pos = position_of(key);
+
+            if (pos == null_position) {
+                return;
+            }
+
+            // Move last entry into the place of the erased one.
+            auto &last = m_entries.back();
+            assure_slot(index_of(last.first)) = pos;
+            m_entries[pos] = last;
+            m_entries.pop_back();
+            assure_slot(index_of(key)) = null_position;
+
+            // Release pages which do not hold any entries anymore.
+            auto page = index_of(key) / page_size;
+
+            if (--m_page_counts[page] == 0) {
+                m_pages[page] = page_type{};
+            }
+        }
+
+        bool contains(entt::entity key) const {
+            return position_of(key) != null_position;
+        }
+
+        entt::entity find(entt::entity key) const {
+            auto pos = position_of(key);
+            return pos != null_position ? m_entries[pos].second : entt::entity{entt::null};
+        }
+
+        entt::entity at(entt::entity key) const {
+            auto pos = position_of(key);
+
+            if (pos == null_position) {
+                throw std::out_of_range("entity_map: entity not mapped");
+            }
+
+            return m_entries[pos].second;
+        }
+
+        size_t size() const {
+            return m_entries.size();
+        }
+
+        template<typename Func>
+        void each(Func func) const {
+            for (auto &entry : m_entries) {
+                func(entry.first, entry.second);
+            }
+        }
+
+    private:
+        std::vector<page_type> m_pages;
+        std::vector<size_t> m_page_counts;
+        std::vector<entry_type> m_entries;
+    };
+
 public:
     void insert(entt::entity entity, entt::entity other) {
-        map[entity] = other;
-        others[other] = entity;
+        map.insert(entity, other);
+        others.insert(other, entity);
     }
 
     void erase(entt::entity entity) {
@@ -26,11 +168,11 @@ public:
     }
 
     bool contains(entt::entity entity) const {
-        return map.count(entity) > 0;
+        return map.contains(entity);
     }
 
     bool contains_other(entt::entity other) const {
-        return others.count(other) > 0;
+        return others.contains(other);
     }
 
     entt::entity at(entt::entity entity) const {
@@ -41,23 +183,48 @@ public:
         return others.at(other);
     }
 
+    /**
+     * @brief Finds the entity mapped to the given entity with a single lookup.
+     * @return The mapped entity or `entt::null` if not mapped.
+     */
+    entt::entity find(entt::entity entity) const {
+        return map.find(entity);
+    }
+
+    /**
+     * @brief Finds the entity mapped to the given other entity with a single
+     * lookup.
+     * @return The mapped entity or `entt::null` if not mapped.
+     */
+    entt::entity find_other(entt::entity other) const {
+        return others.find(other);
+    }
+
     template<typename Predicate>
     void erase_if(Predicate predicate) {
-        for (auto it = map.begin(); it != map.end();) {
-            if (predicate(it->first, it->second)) {
-                others.erase(it->second);
-                it = map.erase(it);
-            } else {
-                ++it;
+        std::vector<entt::entity> erased;
+
+        map.each([&] (entt::entity entity, entt::entity other) {
+            if (predicate(entity, other)) {
+                erased.push_back(entity);
             }
+        });
+
+        for (auto entity : erased) {
+            erase(entity);
         }
     }
 
+    /**
+     * @brief Number of mapped entities.
+     */
+    size_t size() const {
+        return map.size();
+    }
+
     template<typename Func>
     void each(Func func) const {
-        for (auto it = map.begin(); it != map.end(); ++it) {
-            func(it->first, it->second);
-        }
+        map.each(func);
     }
 
     void swap() {
@@ -65,8 +232,8 @@ public:
     }
 
 private:
-    std::map<entt::entity, entt::entity> map;
-    std::map<entt::entity, entt::entity> others;
+    sparse_map map;
+    sparse_map others;
 };
 
 }
@@ -3,12 +3,14 @@
 
 #include <vector>
 #include "edyn/config/config.h"
+#include "edyn/util/mappable_vector.hpp"
 
 namespace edyn {
 
 /**
  * Stores an array of arrays in a single vector along with a list containing
- * the index where each subrange starts.
+ * the index where each subrange starts. Both can be mapped onto external
+ * memory when deserialized, see `mappable_vector`.
  */
 template<typename T>
 class flat_nested_array {
@@ -83,6 +85,13 @@ public:
         return inner_array(this, range_start, range_size);
     }
 
+    /**
+     * Number of bytes allocated for the data and the nested subranges.
+     */
+    size_t memory_usage() const {
+        return m_data.capacity() * sizeof(T) + m_range_starts.capacity() * sizeof(size_t);
+    }
+
     template<typename Archive, typename U>
     friend void serialize(Archive &, flat_nested_array<U> &);
 
@@ -90,8 +99,8 @@ public:
     friend size_t serialization_sizeof(const flat_nested_array<U> &);
 
 private:
-    std::vector<T> m_data;
-    std::vector<size_t> m_range_starts;
+    mappable_vector<T> m_data;
+    mappable_vector<size_t> m_range_starts;
 };
 
 }
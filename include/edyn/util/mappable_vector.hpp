@@ -0,0 +1,336 @@
+#ifndef EDYN_UTIL_MAPPABLE_VECTOR_HPP
+#define EDYN_UTIL_MAPPABLE_VECTOR_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include "edyn/config/config.h"
+
+namespace edyn {
+
+/**
+ * A vector which either owns its elements or references a read-only array of
+ * elements stored elsewhere, such as in a memory mapped file. In the latter
+ * case, the referenced memory must outlive the vector and the vector cannot be
+ * modified. Assigning an empty vector makes it own its elements again.
+ */
+template<typename T>
+class mappable_vector {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    mappable_vector() = default;
+
+    mappable_vector(const mappable_vector &other)
+        : m_vector(other.m_vector)
+        , m_mapped(other.m_mapped)
+    {
+        if (m_mapped) {
+            m_data = other.m_data;
+            m_size = other.m_size;
+        } else {
+            sync();
+        }
+    }
+
+    mappable_vector(mappable_vector &&other) noexcept
+        : m_vector(std::move(other.m_vector))
+        , m_mapped(other.m_mapped)
+    {
+        if (m_mapped) {
+            m_data = other.m_data;
+            m_size = other.m_size;
+        } else {
+            sync();
+        }
+
+        other.reset();
+    }
+
+    mappable_vector & operator=(const mappable_vector &other) {
+        if (this != &other) {
+            m_vector = other.m_vector;
+            m_mapped = other.m_mapped;
+
+            if (m_mapped) {
+                m_data = other.m_data;
+                m_size = other.m_size;
+            } else {
+                sync();
+            }
+        }
+
+        return *this;
+    }
+
+    mappable_vector & operator=(mappable_vector &&other) noexcept {
+        if (this != &other) {
+            m_vector = std::move(other.m_vector);
+            m_mapped = other.m_mapped;
+
+            if (m_mapped) {
+                m_data = other.m_data;
+                m_size = other.m_size;
+            } else {
+                sync();
+            }
+
+            other.reset();
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief References external elements instead of owning them. Releases
+     * owned elements.
+     * @param data Pointer to first element, which must be suitably aligned.
+     * @param size Number of elements.
+     */
+    void map(const T *data, size_t size) {
+        m_vector = {};
+        m_data = const_cast<T *>(data);
+        m_size = size;
+        m_mapped = true;
+    }
+
+    bool is_mapped() const {
+        return m_mapped;
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    /**
+     * @brief Number of owned elements allocated. Zero if mapped.
+     */
+    size_t capacity() const {
+        return m_vector.capacity();
+    }
+
+    const T * data() const {
+        return m_data;
+    }
+
+    const T & operator[](size_t idx) const {
+        EDYN_ASSERT(idx < m_size);
+        return m_data[idx];
+    }
+
+    const T & front() const {
+        EDYN_ASSERT(m_size > 0);
+        return m_data[0];
+    }
+
+    const T & back() const {
+        EDYN_ASSERT(m_size > 0);
+        return m_data[m_size - 1];
+    }
+
+    const_iterator begin() const {
+        return m_data;
+    }
+
+    const_iterator end() const {
+        return m_data + m_size;
+    }
+
+    // Non-const access is only allowed for owned elements.
+
+    T * data() {
+        EDYN_ASSERT(!m_mapped);
+        return m_data;
+    }
+
+    T & operator[](size_t idx) {
+        EDYN_ASSERT(!m_mapped && idx < m_size);
+        return m_data[idx];
+    }
+
+    T & front() {
+        EDYN_ASSERT(!m_mapped && m_size > 0);
+        return m_data[0];
+    }
+
+    T & back() {
+        EDYN_ASSERT(!m_mapped && m_size > 0);
+        return m_data[m_size - 1];
+    }
+
+    iterator begin() {
+        EDYN_ASSERT(!m_mapped);
+        return m_data;
+    }
+
+    iterator end() {
+        EDYN_ASSERT(!m_mapped);
+        return m_data + m_size;
+    }
+
+    void reserve(size_t count) {
+        EDYN_ASSERT(!m_mapped);
+        m_vector.reserve(count);
+        sync();
+    }
+
+    void resize(size_t count) {
+        EDYN_ASSERT(!m_mapped);
+        m_vector.resize(count);
+        sync();
+    }
+
+    void resize(size_t count, const T &value) {
+        EDYN_ASSERT(!m_mapped);
+        m_vector.resize(count, value);
+        sync();
+    }
+
+    void push_back(const T &value) {
+        EDYN_ASSERT(!m_mapped);
+        m_vector.push_back(value);
+        sync();
+    }
+
+    template<typename... Args>
+    T & emplace_back(Args &&... args) {
+        EDYN_ASSERT(!m_mapped);
+        auto &value = m_vector.emplace_back(std::forward<Args>(args)...);
+        sync();
+        return value;
+    }
+
+    template<typename It>
+    void insert(const_iterator pos, It first, It last) {
+        EDYN_ASSERT(!m_mapped);
+        auto offset = pos - m_data;
+        m_vector.insert(m_vector.begin() + offset, first, last);
+        sync();
+    }
+
+    template<typename It>
+    void assign(It first, It last) {
+        EDYN_ASSERT(!m_mapped);
+        m_vector.assign(first, last);
+        sync();
+    }
+
+    void clear() {
+        EDYN_ASSERT(!m_mapped);
+        m_vector.clear();
+        sync();
+    }
+
+    template<typename Archive, typename U>
+    friend void serialize(Archive &, mappable_vector<U> &);
+
+    template<typename U>
+    friend size_t serialization_sizeof(const mappable_vector<U> &);
+
+private:
+    void sync() {
+        m_data = m_vector.data();
+        m_size = m_vector.size();
+    }
+
+    void reset() {
+        m_vector = {};
+        m_mapped = false;
+        sync();
+    }
+
+    std::vector<T> m_vector;
+    // Points into `m_vector` or to the mapped elements.
+    T *m_data {nullptr};
+    size_t m_size {0};
+    bool m_mapped {false};
+};
+
+/**
+ * Specialization for booleans, which are packed into bits when owned and
+ * stored as one byte per element when mapped.
+ */
+template<>
+class mappable_vector<bool> {
+public:
+    using value_type = bool;
+    using size_type = size_t;
+
+    void map(const uint8_t *data, size_t size) {
+        m_vector = {};
+        m_mapped_data = data;
+        m_mapped_size = size;
+        m_mapped = true;
+    }
+
+    bool is_mapped() const {
+        return m_mapped;
+    }
+
+    size_t size() const {
+        return m_mapped ? m_mapped_size : m_vector.size();
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Number of owned bits allocated. Zero if mapped.
+     */
+    size_t capacity() const {
+        return m_vector.capacity();
+    }
+
+    bool operator[](size_t idx) const {
+        EDYN_ASSERT(idx < size());
+        return m_mapped ? m_mapped_data[idx] != 0 : m_vector[idx];
+    }
+
+    std::vector<bool>::reference operator[](size_t idx) {
+        EDYN_ASSERT(!m_mapped && idx < size());
+        return m_vector[idx];
+    }
+
+    void resize(size_t count) {
+        EDYN_ASSERT(!m_mapped);
+        m_vector.resize(count);
+    }
+
+    void push_back(bool value) {
+        EDYN_ASSERT(!m_mapped);
+        m_vector.push_back(value);
+    }
+
+    void clear() {
+        EDYN_ASSERT(!m_mapped);
+        m_vector.clear();
+    }
+
+    template<typename Archive, typename U>
+    friend void serialize(Archive &, mappable_vector<U> &);
+
+    template<typename U>
+    friend size_t serialization_sizeof(const mappable_vector<U> &);
+
+private:
+    // Size is not cached, thus there's nothing to update.
+    void sync() {}
+
+    std::vector<bool> m_vector;
+    const uint8_t *m_mapped_data {nullptr};
+    size_t m_mapped_size {0};
+    bool m_mapped {false};
+};
+
+}
+
+#endif // EDYN_UTIL_MAPPABLE_VECTOR_HPP
@@ -53,6 +53,8 @@ matrix3x3 moment_of_inertia(const polyhedron_shape &sh, scalar mass);
 matrix3x3 moment_of_inertia(const compound_shape &sh, scalar mass);
 matrix3x3 moment_of_inertia(const paged_mesh_shape &sh, scalar mass);
 
+matrix3x3 moment_of_inertia(const heightfield_shape &sh, scalar mass);
+
 /**
  * @brief Visits the shape variant and calculates the moment of inertia of the
  * shape it holds.
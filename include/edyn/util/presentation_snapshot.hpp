@@ -0,0 +1,45 @@
+#ifndef EDYN_UTIL_PRESENTATION_SNAPSHOT_HPP
+#define EDYN_UTIL_PRESENTATION_SNAPSHOT_HPP
+
+#include <vector>
+#include <algorithm>
+#include <entt/entity/fwd.hpp>
+#include "edyn/math/vector3.hpp"
+#include "edyn/math/quaternion.hpp"
+
+namespace edyn {
+
+/**
+ * @brief Copy of the presentation position and orientation of all entities
+ * which have them, taken at the end of an asynchronous update. Entries are
+ * sorted by entity.
+ */
+struct presentation_snapshot {
+    struct entry {
+        entt::entity entity;
+        vector3 position;
+        quaternion orientation;
+    };
+
+    std::vector<entry> entries;
+
+    /**
+     * @brief Finds the entry of an entity.
+     * @param entity The entity.
+     * @return Pointer to the entry or null if the entity is not in the snapshot.
+     */
+    const entry * find(entt::entity entity) const {
+        auto it = std::lower_bound(entries.begin(), entries.end(), entity,
+                                   [] (const entry &e, entt::entity ent) { return e.entity < ent; });
+
+        if (it == entries.end() || it->entity != entity) {
+            return nullptr;
+        }
+
+        return &*it;
+    }
+};
+
+}
+
+#endif // EDYN_UTIL_PRESENTATION_SNAPSHOT_HPP
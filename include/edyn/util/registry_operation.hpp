@@ -3,10 +3,13 @@
 
 #include <memory>
 #include <vector>
+#include <type_traits>
 #include <entt/entity/registry.hpp>
+#include <entt/meta/resolve.hpp>
 #include "edyn/comp/dirty.hpp"
 #include "edyn/config/config.h"
 #include "edyn/parallel/map_child_entity.hpp"
+#include "edyn/parallel/spsc_queue.hpp"
 #include "edyn/util/entity_map.hpp"
 
 namespace edyn {
@@ -31,9 +34,10 @@ public:
     virtual ~component_operation() = default;
     virtual void execute(entt::registry &, registry_op_type,
                          const std::vector<entt::entity> &,
-                         entity_map &, bool mark_dirty) const = 0;
+                         entity_map &, bool mark_dirty, bool emit_signals) const = 0;
     virtual entt::id_type get_type_id() const = 0;
     virtual void remap(const entity_map &emap) = 0;
+    virtual void clear() = 0;
 };
 
 template<typename Component>
@@ -77,9 +81,19 @@ class component_operation_impl : public component_operation {
     typename std::enable_if_t<!std::is_empty_v<T>>
     execute_replace(entt::registry &registry,
                     const std::vector<entt::entity> &entities,
-                    const entity_map &entity_map, bool mark_dirty) const {
+                    const entity_map &entity_map, bool mark_dirty,
+                    bool emit_signals) const {
         EDYN_ASSERT(entities.size() == components.size());
 
+        if constexpr(std::is_trivially_copyable_v<Component>) {
+            // Components registered in `entt::meta` might have child entities
+            // which have to be mapped.
+            if (!emit_signals && !entt::resolve<Component>()) {
+                execute_replace_bulk(registry, entities, entity_map, mark_dirty);
+                return;
+            }
+        }
+
         for (size_t i = 0; i < entities.size(); ++i) {
             auto remote_entity = entities[i];
 
@@ -95,7 +109,50 @@ class component_operation_impl : public component_operation {
 
             auto comp = components[i];
             internal::map_child_entity(registry, entity_map, comp);
-            registry.replace<Component>(local_entity, comp);
+
+            if (emit_signals) {
+                registry.replace<Component>(local_entity, comp);
+            } else {
+                registry.get<Component>(local_entity) = comp;
+            }
+
+            if (mark_dirty) {
+                registry.get_or_emplace<dirty>(local_entity).template updated<Component>();
+            }
+        }
+    }
+
+    // Fast path for components which can be copied straight into the pool.
+    // Resolves all entity mappings first and then copies the components
+    // without emitting signals.
+    void execute_replace_bulk(entt::registry &registry,
+                              const std::vector<entt::entity> &entities,
+                              const entity_map &entity_map, bool mark_dirty) const {
+        // Scratch buffer reused across calls. Thread local because shared
+        // operations can be executed by multiple islands concurrently.
+        thread_local std::vector<entt::entity> local_entities;
+        local_entities.resize(entities.size());
+
+        for (size_t i = 0; i < entities.size(); ++i) {
+            auto local_entity = entity_map.find(entities[i]);
+
+            if (local_entity != entt::null && !registry.valid(local_entity)) {
+                local_entity = entt::null;
+            }
+
+            local_entities[i] = local_entity;
+        }
+
+        auto &storage = registry.storage<Component>();
+
+        for (size_t i = 0; i < local_entities.size(); ++i) {
+            auto local_entity = local_entities[i];
+
+            if (local_entity == entt::null || !storage.contains(local_entity)) {
+                continue;
+            }
+
+            storage.get(local_entity) = components[i];
 
             if (mark_dirty) {
                 registry.get_or_emplace<dirty>(local_entity).template updated<Component>();
@@ -153,14 +210,15 @@ public:
 
     void execute(entt::registry &registry, registry_op_type op,
                  const std::vector<entt::entity> &entities,
-                 entity_map &entity_map, bool mark_dirty) const override {
+                 entity_map &entity_map, bool mark_dirty,
+                 bool emit_signals) const override {
         switch (op) {
         case registry_op_type::emplace:
             execute_emplace(registry, entities, entity_map, mark_dirty);
             break;
         case registry_op_type::replace:
             if constexpr(!is_empty_type) {
-                execute_replace(registry, entities, entity_map, mark_dirty);
+                execute_replace(registry, entities, entity_map, mark_dirty, emit_signals);
             }
             break;
         case registry_op_type::remove:
@@ -187,6 +245,10 @@ public:
             }
         }
     }
+
+    void clear() override {
+        components.clear();
+    }
 };
 
 /**
@@ -229,7 +291,17 @@ public:
     std::vector<entt::entity> entities;
     std::shared_ptr<component_operation> components;
 
-    void execute(entt::registry &registry, entity_map &entity_map, bool mark_dirty = false) const {
+    /**
+     * @brief Executes this operation in a registry.
+     * @param registry Target registry.
+     * @param entity_map Maps entities in this operation into local entities.
+     * @param mark_dirty Whether to mark changed components as dirty.
+     * @param emit_signals Whether to emit update signals when replacing
+     * components. If false, trivially copyable components which are not
+     * registered in `entt::meta` are copied into their pools in bulk.
+     */
+    void execute(entt::registry &registry, entity_map &entity_map,
+                 bool mark_dirty = false, bool emit_signals = false) const {
         switch (operation) {
         case registry_op_type::create:
             execute_create(registry, entity_map, mark_dirty);
@@ -238,7 +310,7 @@ public:
             execute_destroy(registry, entity_map);
             break;
         default:
-            components->execute(registry, operation, entities, entity_map, mark_dirty);
+            components->execute(registry, operation, entities, entity_map, mark_dirty, emit_signals);
         }
     }
 
@@ -251,6 +323,12 @@ public:
     }
 };
 
+/**
+ * @brief Queue through which consumed operations are handed back to the
+ * builder that created them, so their storage can be reused.
+ */
+using registry_operation_recycle_queue = spsc_queue<std::vector<registry_operation>>;
+
 class registry_operation_collection final {
 
     template<typename Component, typename Func>
@@ -295,12 +373,15 @@ class registry_operation_collection final {
 
 public:
     std::vector<registry_operation> operations;
+    std::shared_ptr<registry_operation_recycle_queue> recycle_queue;
 
+    /*! @copydoc registry_operation::execute */
     void execute(entt::registry &registry,
                  entity_map &entity_map,
-                 bool mark_dirty = false) const {
+                 bool mark_dirty = false,
+                 bool emit_signals = false) const {
         for (auto &op : operations) {
-            op.execute(registry, entity_map, mark_dirty);
+            op.execute(registry, entity_map, mark_dirty, emit_signals);
         }
     }
 
@@ -314,6 +395,21 @@ public:
         return true;
     }
 
+    /**
+     * @brief Hands the operations back to the builder that created them so
+     * their storage is reused in the operations it builds next. Must be
+     * called by the consumer once it is done with the operations, and by a
+     * single thread at a time. The collection is left empty.
+     */
+    void recycle() {
+        if (recycle_queue) {
+            recycle_queue->emplace(std::move(operations));
+            recycle_queue.reset();
+        }
+
+        operations.clear();
+    }
+
     template<typename Func>
     void create_for_each(Func func) const {
         for_each_entity(registry_op_type::create, func);
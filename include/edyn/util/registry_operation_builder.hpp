@@ -1,9 +1,12 @@
 #ifndef EDYN_UTIL_REGISTRY_OPERATION_BUILDER_HPP
 #define EDYN_UTIL_REGISTRY_OPERATION_BUILDER_HPP
 
+#include <array>
 #include <vector>
 #include <memory>
 #include <entt/entity/registry.hpp>
+#include "edyn/comp/dirty.hpp"
+#include "edyn/comp/shared_comp.hpp"
 #include "edyn/util/registry_operation.hpp"
 
 namespace edyn {
@@ -27,9 +30,12 @@ class registry_operation_builder {
             }
         }
 
-        auto &op = operations.emplace_back();
-        op.operation = op_type;
-        op.components = std::make_unique<component_operation_impl<Component>>();
+        auto &op = emplace_operation(op_type, true, type_id);
+
+        if (!op.components) {
+            op.components = std::make_unique<component_operation_impl<Component>>();
+        }
+
         return op;
     }
 
@@ -43,11 +49,70 @@ class registry_operation_builder {
             }
         }
 
+        return emplace_operation(op_type, false);
+    }
+
+    // Appends an operation, reusing a recycled one which holds components of
+    // the given type, or no components in case of entity operations, if
+    // available.
+    registry_operation & emplace_operation(registry_op_type op_type, bool has_components,
+                                           entt::id_type type_id = {}) {
+        if (operations.empty()) {
+            reclaim();
+        }
+
+        for (size_t i = 0; i < m_free_operations.size(); ++i) {
+            auto &free_op = m_free_operations[i];
+            auto matches = has_components ?
+                free_op.components && free_op.components->get_type_id() == type_id :
+                !free_op.components;
+
+            if (matches) {
+                auto &op = operations.emplace_back(std::move(free_op));
+                op.operation = op_type;
+
+                if (i + 1 < m_free_operations.size()) {
+                    free_op = std::move(m_free_operations.back());
+                }
+
+                m_free_operations.pop_back();
+                return op;
+            }
+        }
+
         auto &op = operations.emplace_back();
         op.operation = op_type;
         return op;
     }
 
+    // Takes the operations handed back by consumers and prepares them to
+    // be reused.
+    void reclaim() {
+        m_recycle_queue->consume_all([&] (std::vector<registry_operation> &ops) {
+            for (auto &op : ops) {
+                // Component storage that is still referenced elsewhere
+                // cannot be reused.
+                if (op.components && op.components.use_count() > 1) {
+                    continue;
+                }
+
+                op.entities.clear();
+
+                if (op.components) {
+                    op.components->clear();
+                }
+
+                m_free_operations.push_back(std::move(op));
+            }
+
+            ops.clear();
+
+            if (operations.capacity() < ops.capacity()) {
+                operations.swap(ops);
+            }
+        });
+    }
+
     template<typename Component, typename ViewType>
     void insert_components(const ViewType &view, registry_operation &op, entt::entity entity) {
         op.entities.push_back(entity);
@@ -61,6 +126,35 @@ class registry_operation_builder {
         }
     }
 
+    using component_func_t = void(*)(registry_operation_builder &, const entt::registry &, entt::entity);
+
+    template<typename Component>
+    static void emplace_component(registry_operation_builder &builder, const entt::registry &registry, entt::entity entity) {
+        builder.emplace<Component>(registry, entity);
+    }
+
+    template<typename Component>
+    static void replace_component(registry_operation_builder &builder, const entt::registry &registry, entt::entity entity) {
+        builder.replace<Component>(registry, entity);
+    }
+
+    template<typename Component>
+    static void remove_component(registry_operation_builder &builder, const entt::registry &registry, entt::entity entity) {
+        builder.remove<Component>(registry, entity);
+    }
+
+    // Functions that insert a shared component into an operation, indexed by
+    // the index of the component in `shared_components_t`.
+    template<typename Tuple>
+    struct shared_component_funcs;
+
+    template<typename... Ts>
+    struct shared_component_funcs<std::tuple<Ts...>> {
+        static constexpr std::array<component_func_t, sizeof...(Ts)> emplace {&emplace_component<Ts>...};
+        static constexpr std::array<component_func_t, sizeof...(Ts)> replace {&replace_component<Ts>...};
+        static constexpr std::array<component_func_t, sizeof...(Ts)> remove {&remove_component<Ts>...};
+    };
+
     template<typename Component, typename It>
     void insert_components(const entt::registry &registry, registry_op_type op_type, It first, It last, bool check = false) {
         EDYN_ASSERT(op_type == registry_op_type::emplace ||
@@ -87,6 +181,10 @@ class registry_operation_builder {
     }
 
 public:
+    registry_operation_builder()
+        : m_recycle_queue(std::make_shared<registry_operation_recycle_queue>())
+    {}
+
     virtual ~registry_operation_builder() = default;
 
     template<typename It>
@@ -213,6 +311,30 @@ public:
         }
     }
 
+    /**
+     * @brief Inserts the components marked as created, updated and destroyed
+     * in a `dirty` component into the respective operations. Shared
+     * components are looked up by index.
+     */
+    void insert_dirty(const entt::registry &registry, entt::entity entity, const dirty &dirty) {
+        using funcs = shared_component_funcs<shared_components_t>;
+
+        dirty::each_index(dirty.created_indexes, [&] (size_t index) {
+            funcs::emplace[index](*this, registry, entity);
+        });
+        emplace_type_ids(registry, entity, dirty.created_ids.begin(), dirty.created_ids.end());
+
+        dirty::each_index(dirty.updated_indexes, [&] (size_t index) {
+            funcs::replace[index](*this, registry, entity);
+        });
+        replace_type_ids(registry, entity, dirty.updated_ids.begin(), dirty.updated_ids.end());
+
+        dirty::each_index(dirty.destroyed_indexes, [&] (size_t index) {
+            funcs::remove[index](*this, registry, entity);
+        });
+        remove_type_ids(registry, entity, dirty.destroyed_ids.begin(), dirty.destroyed_ids.end());
+    }
+
     void add_entity_mapping(entt::entity local_entity, entt::entity remote_entity) {
         auto &op = find_or_create_component_operation<entt::entity>(registry_op_type::ent_map);
         op.entities.push_back(local_entity);
@@ -230,12 +352,21 @@ public:
         return true;
     }
 
+    /**
+     * @brief Moves the operations built so far into a collection. Calling
+     * `registry_operation_collection::recycle` once the collection is consumed
+     * lets this builder reuse its storage, thus avoiding allocations when
+     * building operations of similar size repeatedly.
+     */
     registry_operation_collection finish() {
-        return registry_operation_collection{std::move(operations)};
+        return registry_operation_collection{std::move(operations), m_recycle_queue};
     }
 
 private:
     std::vector<registry_operation> operations;
+    // Recycled operations which are ready to be reused.
+    std::vector<registry_operation> m_free_operations;
+    std::shared_ptr<registry_operation_recycle_queue> m_recycle_queue;
 };
 
 template<typename... Components>
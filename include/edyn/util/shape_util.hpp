@@ -108,6 +108,35 @@ bool load_tri_mesh_from_obj(const std::string &path,
                             quaternion orn = quaternion_identity,
                             vector3 scale = vector3_one);
 
+/**
+ * @brief Loads meshes from a *.obj file which is memory mapped and parsed
+ * without going through streams. The result is the same as
+ * `load_meshes_from_obj`.
+ * @see load_meshes_from_obj
+ */
+bool load_meshes_from_obj_mapped(const std::string &path,
+                                 std::vector<obj_mesh> &meshes,
+                                 vector3 pos = vector3_zero,
+                                 quaternion orn = quaternion_identity,
+                                 vector3 scale = vector3_one);
+
+/**
+ * @brief Loads a triangle mesh from a *.obj file which is memory mapped and
+ * parsed without going through streams. Files larger than `min_chunk_size`
+ * are split up in chunks which are parsed in parallel using the global job
+ * dispatcher. The result is the same as `load_tri_mesh_from_obj`.
+ * @param min_chunk_size Minimum number of bytes parsed by each job.
+ * @see load_tri_mesh_from_obj
+ */
+bool load_tri_mesh_from_obj_mapped(const std::string &path,
+                                   std::vector<vector3> &vertices,
+                                   std::vector<uint32_t> &indices,
+                                   std::vector<vector3> *colors = nullptr,
+                                   vector3 pos = vector3_zero,
+                                   quaternion orn = quaternion_identity,
+                                   vector3 scale = vector3_one,
+                                   size_t min_chunk_size = size_t(1) << 20);
+
 /**
  * @brief Calculates a point on a axis-aligned box that's furthest along
  * a given direction, i.e. support point.
@@ -408,6 +437,18 @@ struct collision_feature;
 size_t get_triangle_mesh_feature_index(const triangle_mesh &mesh, size_t tri_idx,
                                        triangle_feature tri_feature, size_t tri_feature_idx);
 
+/**
+ * @brief Get a height field feature index from the local index of a triangle
+ * feature.
+ * @param field The height field indices should be obtained from.
+ * @param tri_idx Triangle index in the height field.
+ * @param tri_feature Triangle feature.
+ * @param tri_feature_index Index of triangle feature.
+ * @return Index of feature in the height field.
+ */
+size_t get_triangle_mesh_feature_index(const heightfield &field, size_t tri_idx,
+                                       triangle_feature tri_feature, size_t tri_feature_idx);
+
 }
 
 #endif // EDYN_UTIL_SHAPE_UTIL_HPP
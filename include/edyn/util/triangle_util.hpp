@@ -21,6 +21,7 @@ enum class triangle_feature : uint8_t {
 using triangle_vertices = std::array<vector3, 3>;
 using triangle_edges = std::array<vector3, 3>;
 class triangle_mesh;
+class heightfield;
 
 /**
  * Checks whether point `p` is contained within the infinite prism with
@@ -60,6 +61,11 @@ vector3 clip_triangle_separating_axis(vector3 sep_axis, const triangle_mesh &mes
                                       const vector3 &tri_normal, triangle_feature tri_feature,
                                       size_t tri_feature_index);
 
+vector3 clip_triangle_separating_axis(vector3 sep_axis, const heightfield &field,
+                                      size_t tri_idx, const std::array<vector3, 3> &tri_vertices,
+                                      const vector3 &tri_normal, triangle_feature tri_feature,
+                                      size_t tri_feature_index);
+
 }
 
 #endif // EDYN_SHAPES_TRIANGLE_UTIL_HPP
@@ -100,6 +100,13 @@ void broadphase_main::update() {
         });
 
         auto &manifold_map = m_registry->ctx<contact_manifold_map>();
+        auto num_pairs = size_t{0};
+
+        for (auto &results : m_pair_results) {
+            num_pairs += results.size();
+        }
+
+        manifold_map.reserve(manifold_map.size() + num_pairs);
 
         for (auto &results : m_pair_results) {
             for (auto &pair : results) {
@@ -6,6 +6,8 @@
 #include "edyn/collision/contact_manifold_map.hpp"
 #include "edyn/collision/tree_view.hpp"
 #include "edyn/comp/tag.hpp"
+#include "edyn/comp/linvel.hpp"
+#include "edyn/shapes/paged_mesh_shape.hpp"
 #include "edyn/util/constraint_util.hpp"
 #include "edyn/parallel/parallel_for_async.hpp"
 #include "edyn/context/settings.hpp"
@@ -131,6 +133,43 @@ void broadphase_worker::common_update() {
     kinematic_aabb_node_view.each([&] (tree_resident &node, AABB &aabb) {
         m_np_tree.move(node.id, aabb);
     });
+
+    prefetch_paged_meshes();
+}
+
+void broadphase_worker::prefetch_paged_meshes() {
+    auto &settings = m_registry->ctx<edyn::settings>();
+    auto paged_mesh_view = m_registry->view<paged_mesh_shape>();
+
+    if (settings.num_paged_mesh_prefetch_steps == 0 || paged_mesh_view.empty()) {
+        return;
+    }
+
+    // Start loading submeshes that intersect the region each body is
+    // predicted to sweep over the next few steps, so they're likely in the
+    // cache by the time the narrow-phase needs them.
+    auto aabb_view = m_registry->view<AABB>();
+    auto lookahead = settings.fixed_dt * settings.num_paged_mesh_prefetch_steps;
+    auto body_view = m_registry->view<AABB, linvel, procedural_tag>();
+
+    body_view.each([&] (entt::entity entity, AABB &aabb, linvel &v) {
+        // Sweep the same inflated AABB used to search for new pairs.
+        auto offset_aabb = aabb.inset(m_aabb_offset);
+        auto query_aabb = swept_aabb(offset_aabb, v, lookahead);
+
+        m_np_tree.query(query_aabb, [&] (tree_node_id_t id) {
+            auto other = m_np_tree.get_node(id).entity;
+
+            if (!paged_mesh_view.contains(other) ||
+                !intersect(query_aabb, aabb_view.get<AABB>(other)) ||
+                !(*settings.should_collide_func)(*m_registry, entity, other)) {
+                return;
+            }
+
+            auto [paged_mesh] = paged_mesh_view.get(other);
+            paged_mesh.trimesh->prefetch(offset_aabb, v, lookahead);
+        });
+    });
 }
 
 void broadphase_worker::update() {
@@ -168,6 +207,13 @@ void broadphase_worker::update_async(job &completion_job) {
 
 void broadphase_worker::finish_async_update() {
     auto &manifold_map = m_registry->ctx<contact_manifold_map>();
+    auto num_pairs = size_t{0};
+
+    for (auto &pairs : m_pair_results) {
+        num_pairs += pairs.size();
+    }
+
+    manifold_map.reserve(manifold_map.size() + num_pairs);
 
     for (auto &pairs : m_pair_results) {
         for (auto &pair : pairs) {
@@ -11,15 +11,15 @@
 
 namespace edyn {
 
+template<typename MeshType>
 static void collide_box_triangle(
-    const box_shape &box, const triangle_mesh &mesh, size_t tri_idx,
+    const box_shape &box, const MeshType &mesh, size_t tri_idx,
+    const triangle_vertices &tri_vertices, const vector3 &tri_normal,
     const std::array<vector3, 3> &box_axes,
     const collision_context &ctx, collision_result &result) {
 
     const auto &posA = ctx.posA;
     const auto &ornA = ctx.ornA;
-    const auto tri_vertices = mesh.get_triangle_vertices(tri_idx);
-    const auto tri_normal = mesh.get_triangle_normal(tri_idx);
     const auto tri_center = average(tri_vertices);
 
     auto distance = -EDYN_SCALAR_MAX;
@@ -389,8 +389,9 @@ static void collide_box_triangle(
     }
 }
 
-void collide(const box_shape &box, const triangle_mesh &mesh,
-             const collision_context &ctx, collision_result &result) {
+template<typename MeshType>
+static void collide_box_mesh(const box_shape &box, const MeshType &mesh,
+                             const collision_context &ctx, collision_result &result) {
     const auto box_axes = std::array<vector3, 3> {
         quaternion_x(ctx.ornA),
         quaternion_y(ctx.ornA),
@@ -400,9 +401,20 @@ void collide(const box_shape &box, const triangle_mesh &mesh,
     const auto inset = vector3_one * -contact_breaking_threshold;
     const auto visit_aabb = ctx.aabbA.inset(inset);
 
-    mesh.visit_triangles(visit_aabb, [&] (auto tri_idx) {
-        collide_box_triangle(box, mesh, tri_idx, box_axes, ctx, result);
+    mesh.visit_triangles_culled(visit_aabb, ctx.aabbA, ctx.threshold,
+                                [&] (auto tri_idx, const auto &tri_vertices, const auto &tri_normal) {
+        collide_box_triangle(box, mesh, tri_idx, tri_vertices, tri_normal, box_axes, ctx, result);
     });
 }
 
+void collide(const box_shape &box, const triangle_mesh &mesh,
+             const collision_context &ctx, collision_result &result) {
+    collide_box_mesh(box, mesh, ctx, result);
+}
+
+void collide(const box_shape &box, const heightfield &field,
+             const collision_context &ctx, collision_result &result) {
+    collide_box_mesh(box, field, ctx, result);
+}
+
 }
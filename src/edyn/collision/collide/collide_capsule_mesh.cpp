@@ -7,15 +7,15 @@
 
 namespace edyn {
 
+template<typename MeshType>
 static void collide_capsule_triangle(
-    const capsule_shape &capsule, const triangle_mesh &mesh, size_t tri_idx,
+    const capsule_shape &capsule, const MeshType &mesh, size_t tri_idx,
+    const triangle_vertices &tri_vertices, const vector3 &tri_normal,
     const std::array<vector3, 2> &capsule_vertices,
     const collision_context &ctx, collision_result &result) {
 
     const auto &posA = ctx.posA;
     const auto &ornA = ctx.ornA;
-    const auto tri_vertices = mesh.get_triangle_vertices(tri_idx);
-    const auto tri_normal = mesh.get_triangle_normal(tri_idx);
     const auto tri_center = average(tri_vertices);
 
     auto sep_axis = vector3_zero;
@@ -246,8 +246,9 @@ static void collide_capsule_triangle(
     }
 }
 
-void collide(const capsule_shape &capsule, const triangle_mesh &mesh,
-             const collision_context &ctx, collision_result &result) {
+template<typename MeshType>
+static void collide_capsule_mesh(const capsule_shape &capsule, const MeshType &mesh,
+                                 const collision_context &ctx, collision_result &result) {
     const auto &posA = ctx.posA;
     const auto &ornA = ctx.ornA;
     const auto capsule_vertices = capsule.get_vertices(posA, ornA);
@@ -255,9 +256,21 @@ void collide(const capsule_shape &capsule, const triangle_mesh &mesh,
     const auto inset = vector3_one * -contact_breaking_threshold;
     const auto visit_aabb = ctx.aabbA.inset(inset);
 
-    mesh.visit_triangles(visit_aabb, [&] (auto tri_idx) {
-        collide_capsule_triangle(capsule, mesh, tri_idx, capsule_vertices, ctx, result);
+    mesh.visit_triangles_culled(visit_aabb, ctx.aabbA, ctx.threshold,
+                                [&] (auto tri_idx, const auto &tri_vertices, const auto &tri_normal) {
+        collide_capsule_triangle(capsule, mesh, tri_idx, tri_vertices, tri_normal,
+                                 capsule_vertices, ctx, result);
     });
 }
 
+void collide(const capsule_shape &capsule, const triangle_mesh &mesh,
+             const collision_context &ctx, collision_result &result) {
+    collide_capsule_mesh(capsule, mesh, ctx, result);
+}
+
+void collide(const capsule_shape &capsule, const heightfield &field,
+             const collision_context &ctx, collision_result &result) {
+    collide_capsule_mesh(capsule, field, ctx, result);
+}
+
 }
@@ -5,8 +5,9 @@
 
 namespace edyn {
 
-void collide(const compound_shape &compound, const triangle_mesh &mesh,
-             const collision_context &ctx, collision_result &result) {
+template<typename MeshType>
+static void collide_compound_mesh(const compound_shape &compound, const MeshType &mesh,
+                                  const collision_context &ctx, collision_result &result) {
     // TODO Possible optimization: find the triangle mesh node which encompasses
     // the compound's AABB and start the tree queries from that node in the
     // child collision tests.
@@ -44,4 +45,14 @@ void collide(const compound_shape &compound, const triangle_mesh &mesh,
     }
 }
 
+void collide(const compound_shape &compound, const triangle_mesh &mesh,
+             const collision_context &ctx, collision_result &result) {
+    collide_compound_mesh(compound, mesh, ctx, result);
+}
+
+void collide(const compound_shape &compound, const heightfield &field,
+             const collision_context &ctx, collision_result &result) {
+    collide_compound_mesh(compound, field, ctx, result);
+}
+
 }
@@ -11,15 +11,15 @@
 
 namespace edyn {
 
+template<typename MeshType>
 void collide_cylinder_triangle(
-    const cylinder_shape &cylinder, const triangle_mesh &mesh, size_t tri_idx,
+    const cylinder_shape &cylinder, const MeshType &mesh, size_t tri_idx,
+    const triangle_vertices &tri_vertices, const vector3 &tri_normal,
     const vector3 &cylinder_axis, const std::array<vector3, 2> &cylinder_vertices,
     const collision_context &ctx, collision_result &result) {
 
     const auto &posA = ctx.posA;
     const auto &ornA = ctx.ornA;
-    const auto tri_vertices = mesh.get_triangle_vertices(tri_idx);
-    const auto tri_normal = mesh.get_triangle_normal(tri_idx);
     const auto tri_center = average(tri_vertices);
 
     auto distance = -EDYN_SCALAR_MAX;
@@ -404,8 +404,9 @@ void collide_cylinder_triangle(
     }
 }
 
-void collide(const cylinder_shape &cylinder, const triangle_mesh &mesh,
-             const collision_context &ctx, collision_result &result) {
+template<typename MeshType>
+static void collide_cylinder_mesh(const cylinder_shape &cylinder, const MeshType &mesh,
+                                  const collision_context &ctx, collision_result &result) {
     const auto cylinder_axis = quaternion_x(ctx.ornA);
     const auto cylinder_vertices = std::array<vector3, 2>{
         ctx.posA + cylinder_axis * cylinder.half_length,
@@ -415,10 +416,21 @@ void collide(const cylinder_shape &cylinder, const triangle_mesh &mesh,
     const auto inset = vector3_one * -contact_breaking_threshold;
     const auto visit_aabb = ctx.aabbA.inset(inset);
 
-    mesh.visit_triangles(visit_aabb, [&] (auto tri_idx) {
-        collide_cylinder_triangle(cylinder, mesh, tri_idx,
+    mesh.visit_triangles_culled(visit_aabb, ctx.aabbA, ctx.threshold,
+                                [&] (auto tri_idx, const auto &tri_vertices, const auto &tri_normal) {
+        collide_cylinder_triangle(cylinder, mesh, tri_idx, tri_vertices, tri_normal,
                                   cylinder_axis, cylinder_vertices, ctx, result);
     });
 }
 
+void collide(const cylinder_shape &cylinder, const triangle_mesh &mesh,
+             const collision_context &ctx, collision_result &result) {
+    collide_cylinder_mesh(cylinder, mesh, ctx, result);
+}
+
+void collide(const cylinder_shape &cylinder, const heightfield &field,
+             const collision_context &ctx, collision_result &result) {
+    collide_cylinder_mesh(cylinder, field, ctx, result);
+}
+
 }
@@ -10,8 +10,10 @@
 
 namespace edyn {
 
+template<typename MeshType>
 static void collide_polyhedron_triangle(
-    const polyhedron_shape &poly, const triangle_mesh &mesh, size_t tri_idx,
+    const polyhedron_shape &poly, const MeshType &mesh, size_t tri_idx,
+    const triangle_vertices &tri_vertices_original, const vector3 &tri_normal,
     const collision_context &ctx, collision_result &result) {
 
     // The triangle vertices are shifted by the polyhedron's position so all
@@ -21,9 +23,6 @@ static void collide_polyhedron_triangle(
     const auto &orn_poly = ctx.ornA;
     const auto &rmesh = *poly.rotated;
 
-    auto tri_vertices_original = mesh.get_triangle_vertices(tri_idx);
-    auto tri_normal = mesh.get_triangle_normal(tri_idx);
-
     // Shift vertices into A's positional object space.
     auto tri_vertices = tri_vertices_original;
     for (auto &v : tri_vertices) {
@@ -233,14 +232,26 @@ static void collide_polyhedron_triangle(
     }
 }
 
-void collide(const polyhedron_shape &poly, const triangle_mesh &mesh,
-             const collision_context &ctx, collision_result &result) {
+template<typename MeshType>
+static void collide_polyhedron_mesh(const polyhedron_shape &poly, const MeshType &mesh,
+                                    const collision_context &ctx, collision_result &result) {
     const auto inset = vector3_one * -contact_breaking_threshold;
     const auto visit_aabb = ctx.aabbA.inset(inset);
 
-    mesh.visit_triangles(visit_aabb, [&] (auto tri_idx) {
-        collide_polyhedron_triangle(poly, mesh, tri_idx, ctx, result);
+    mesh.visit_triangles_culled(visit_aabb, ctx.aabbA, ctx.threshold,
+                                [&] (auto tri_idx, const auto &tri_vertices, const auto &tri_normal) {
+        collide_polyhedron_triangle(poly, mesh, tri_idx, tri_vertices, tri_normal, ctx, result);
     });
 }
 
+void collide(const polyhedron_shape &poly, const triangle_mesh &mesh,
+             const collision_context &ctx, collision_result &result) {
+    collide_polyhedron_mesh(poly, mesh, ctx, result);
+}
+
+void collide(const polyhedron_shape &poly, const heightfield &field,
+             const collision_context &ctx, collision_result &result) {
+    collide_polyhedron_mesh(poly, field, ctx, result);
+}
+
 }
@@ -9,14 +9,14 @@
 
 namespace edyn {
 
+template<typename MeshType>
 static void collide_sphere_triangle(
-    const sphere_shape &sphere, const triangle_mesh &mesh, size_t tri_idx,
+    const sphere_shape &sphere, const MeshType &mesh, size_t tri_idx,
+    const triangle_vertices &tri_vertices, const vector3 &tri_normal,
     const collision_context &ctx, collision_result &result) {
 
     const auto &sphere_pos = ctx.posA;
     const auto &sphere_orn = ctx.ornA;
-    const auto tri_vertices = mesh.get_triangle_vertices(tri_idx);
-    const auto tri_normal = mesh.get_triangle_normal(tri_idx);
 
     // Triangle normal.
     auto distance = dot(sphere_pos - tri_vertices[0], tri_normal) - sphere.radius;
@@ -110,14 +110,26 @@ static void collide_sphere_triangle(
     }
 }
 
-void collide(const sphere_shape &sphere, const triangle_mesh &mesh,
-             const collision_context &ctx, collision_result &result) {
+template<typename MeshType>
+static void collide_sphere_mesh(const sphere_shape &sphere, const MeshType &mesh,
+                                const collision_context &ctx, collision_result &result) {
     const auto inset = vector3_one * -contact_breaking_threshold;
     const auto visit_aabb = ctx.aabbA.inset(inset);
 
-    mesh.visit_triangles(visit_aabb, [&] (auto tri_idx) {
-        collide_sphere_triangle(sphere, mesh, tri_idx, ctx, result);
+    mesh.visit_triangles_culled(visit_aabb, ctx.aabbA, ctx.threshold,
+                                [&] (auto tri_idx, const auto &tri_vertices, const auto &tri_normal) {
+        collide_sphere_triangle(sphere, mesh, tri_idx, tri_vertices, tri_normal, ctx, result);
     });
 }
 
+void collide(const sphere_shape &sphere, const triangle_mesh &mesh,
+             const collision_context &ctx, collision_result &result) {
+    collide_sphere_mesh(sphere, mesh, ctx, result);
+}
+
+void collide(const sphere_shape &sphere, const heightfield &field,
+             const collision_context &ctx, collision_result &result) {
+    collide_sphere_mesh(sphere, field, ctx, result);
+}
+
 }
@@ -4,45 +4,148 @@
 
 namespace edyn {
 
-contact_manifold_map::contact_manifold_map(entt::registry &registry) {
+static constexpr size_t manifold_map_min_capacity = 64;
+
+static size_t hash_key(uint64_t key) {
+    // Finalizer of MurmurHash3.
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ull;
+    key ^= key >> 33;
+    return static_cast<size_t>(key);
+}
+
+contact_manifold_map::contact_manifold_map(entt::registry &registry)
+    : m_slots(manifold_map_min_capacity)
+{
     registry.on_construct<contact_manifold>().connect<&contact_manifold_map::on_construct_contact_manifold>(*this);
     registry.on_destroy<contact_manifold>().connect<&contact_manifold_map::on_destroy_contact_manifold>(*this);
 }
 
+uint64_t contact_manifold_map::make_key(entt::entity first, entt::entity second) {
+    uint64_t a = entt::to_integral(first);
+    uint64_t b = entt::to_integral(second);
+    return a < b ? (a << 32) | b : (b << 32) | a;
+}
+
+size_t contact_manifold_map::find_slot(uint64_t key) const {
+    auto mask = m_slots.size() - 1;
+    auto index = hash_key(key) & mask;
+
+    // Stop at the matching slot or at the first empty slot.
+    while (m_slots[index].manifold_entity != entt::null && m_slots[index].key != key) {
+        index = (index + 1) & mask;
+    }
+
+    return index;
+}
+
 bool contact_manifold_map::contains(entity_pair pair) const {
-    return m_pair_map.count(pair) > 0;
+    return find(pair) != entt::null;
 }
 
 bool contact_manifold_map::contains(entt::entity first, entt::entity second) const {
-    return contains(std::make_pair(first, second));
+    return find(first, second) != entt::null;
 }
 
 entt::entity contact_manifold_map::get(entity_pair pair) const {
     EDYN_ASSERT(contains(pair));
-    return m_pair_map.at(pair);
+    return find(pair);
 }
 
 entt::entity contact_manifold_map::get(entt::entity first, entt::entity second) const {
     return get(std::make_pair(first, second));
 }
 
+entt::entity contact_manifold_map::find(entity_pair pair) const {
+    return find(pair.first, pair.second);
+}
+
+entt::entity contact_manifold_map::find(entt::entity first, entt::entity second) const {
+    return m_slots[find_slot(make_key(first, second))].manifold_entity;
+}
+
+size_t contact_manifold_map::size() const {
+    return m_size;
+}
+
+void contact_manifold_map::reserve(size_t count) {
+    // Keep the table at most half full so probe sequences stay short.
+    auto capacity = m_slots.size();
+
+    while (count * 2 > capacity) {
+        capacity *= 2;
+    }
+
+    if (capacity != m_slots.size()) {
+        rehash(capacity);
+    }
+}
+
+void contact_manifold_map::rehash(size_t capacity) {
+    auto slots = std::move(m_slots);
+    m_slots.clear();
+    m_slots.resize(capacity);
+
+    for (auto &s : slots) {
+        if (s.manifold_entity != entt::null) {
+            m_slots[find_slot(s.key)] = s;
+        }
+    }
+}
+
+void contact_manifold_map::insert(uint64_t key, entt::entity manifold_entity) {
+    reserve(m_size + 1);
+
+    auto index = find_slot(key);
+    EDYN_ASSERT(m_slots[index].manifold_entity == entt::null);
+    m_slots[index] = slot{key, manifold_entity};
+    ++m_size;
+}
+
+void contact_manifold_map::erase(uint64_t key) {
+    auto mask = m_slots.size() - 1;
+    auto index = find_slot(key);
+
+    if (m_slots[index].manifold_entity == entt::null) {
+        return;
+    }
+
+    // Backward shift deletion: move subsequent entries of the probe sequence
+    // into the vacated slot so no tombstones are needed.
+    auto next = index;
+
+    while (true) {
+        next = (next + 1) & mask;
+
+        if (m_slots[next].manifold_entity == entt::null) {
+            break;
+        }
+
+        // Move the entry back if its ideal slot is not cyclically in
+        // (index, next].
+        auto ideal = hash_key(m_slots[next].key) & mask;
+
+        if (((next - ideal) & mask) >= ((next - index) & mask)) {
+            m_slots[index] = m_slots[next];
+            index = next;
+        }
+    }
+
+    m_slots[index] = slot{};
+    --m_size;
+}
+
 void contact_manifold_map::on_construct_contact_manifold(entt::registry &registry, entt::entity entity) {
     auto &manifold = registry.get<contact_manifold>(entity);
-    // Insert all permutations.
-    auto p = std::make_pair(manifold.body[0], manifold.body[1]);
-    auto q = std::make_pair(manifold.body[1], manifold.body[0]);
-    EDYN_ASSERT(m_pair_map.count(p) == 0 && m_pair_map.count(q) == 0);
-    m_pair_map[p] = entity;
-    m_pair_map[q] = entity;
+    insert(make_key(manifold.body[0], manifold.body[1]), entity);
 }
 
 void contact_manifold_map::on_destroy_contact_manifold(entt::registry &registry, entt::entity entity) {
     auto &manifold = registry.get<contact_manifold>(entity);
     // Cleanup cached info.
-    auto p = std::make_pair(manifold.body[0], manifold.body[1]);
-    auto q = std::make_pair(manifold.body[1], manifold.body[0]);
-    m_pair_map.erase(p);
-    m_pair_map.erase(q);
+    erase(make_key(manifold.body[0], manifold.body[1]));
 }
 
 }
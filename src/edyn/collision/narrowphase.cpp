@@ -4,6 +4,7 @@
 #include "edyn/config/constants.hpp"
 #include "edyn/parallel/parallel_for_async.hpp"
 #include "edyn/comp/material.hpp"
+#include "edyn/sys/update_rotated_meshes.hpp"
 
 namespace edyn {
 
@@ -21,9 +22,22 @@ void narrowphase::clear_contact_manifold_events() {
     });
 }
 
+void narrowphase::update_rotated_meshes() {
+    // Update the rotated meshes of polyhedrons that are involved in a contact
+    // manifold before collision detection, since they're shared by multiple
+    // manifolds which might be processed in parallel.
+    auto manifold_view = m_registry->view<contact_manifold>();
+
+    for (auto [entity, manifold] : manifold_view.each()) {
+        update_rotated_mesh_if_outdated(*m_registry, manifold.body[0]);
+        update_rotated_mesh_if_outdated(*m_registry, manifold.body[1]);
+    }
+}
+
 void narrowphase::update() {
     clear_contact_manifold_events();
     update_contact_distances(*m_registry);
+    update_rotated_meshes();
 
     auto manifold_view = m_registry->view<contact_manifold>();
     update_contact_manifolds(manifold_view.begin(), manifold_view.end(), manifold_view);
@@ -32,6 +46,7 @@ void narrowphase::update() {
 void narrowphase::update_async(job &completion_job) {
     clear_contact_manifold_events();
     update_contact_distances(*m_registry);
+    update_rotated_meshes();
 
     EDYN_ASSERT(parallelizable());
 
@@ -429,4 +429,27 @@ shape_raycast_result shape_raycast(const paged_mesh_shape &paged_mesh, const ray
     return result;
 }
 
+shape_raycast_result shape_raycast(const heightfield_shape &heightfield, const raycast_context &ctx) {
+    auto &field = heightfield.field;
+    shape_raycast_result result;
+
+    field->raycast(ctx.p0, ctx.p1, [&] (auto tri_idx) {
+        auto vertices = field->get_triangle_vertices(tri_idx);
+        auto normal = field->get_triangle_normal(tri_idx);
+        auto t = scalar(0);
+
+        if (!intersect_segment_triangle(ctx.p0, ctx.p1, vertices, normal, t)) {
+            return;
+        }
+
+        if (t < result.fraction) {
+            result.fraction = t;
+            result.normal = normal;
+            result.info_var = heightfield_raycast_info{tri_idx};
+        }
+    });
+
+    return result;
+}
+
 }
@@ -194,10 +194,10 @@ void solver::update(scalar dt) {
 
     update_origins(registry);
 
-    // Update rotated vertices of convex meshes after rotations change. It is
-    // important to do this before `update_aabbs` because the rotated meshes
-    // will be used to calculate AABBs of polyhedrons.
-    update_rotated_meshes(registry);
+    // Rotated vertices of convex meshes are outdated after rotations change.
+    // They'll be updated on demand in the narrowphase of the next step, only
+    // for the polyhedrons that are involved in a contact manifold.
+    invalidate_rotated_meshes(registry);
 
     // Update AABBs after transforms change.
     update_aabbs(registry);
@@ -7,11 +7,112 @@
 #include "edyn/sys/update_presentation.hpp"
 #include "edyn/dynamics/material_mixing.hpp"
 #include "edyn/collision/tree_view.hpp"
+#include "edyn/serialization/memory_archive.hpp"
 #include <entt/meta/factory.hpp>
 #include <entt/core/hashed_string.hpp>
+#include <condition_variable>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace edyn {
 
+// Keeps track of an update started by `edyn::update_async`.
+struct async_update_context {
+    struct state {
+        entt::registry *registry;
+        // Set by `edyn::update_async` and cleared by `edyn::wait_update`. Only
+        // accessed in the main thread.
+        bool pending {false};
+        // Whether the background job is still running.
+        bool running {false};
+        std::mutex mutex;
+        std::condition_variable cv;
+        job update_job;
+        // Presentation data of the last completed update, which is swapped
+        // with `back_snapshot` in `edyn::wait_update` after the job fills it.
+        presentation_snapshot snapshot;
+        presentation_snapshot back_snapshot;
+    };
+
+    // Allocated separately since it's referenced by the job and must not move.
+    std::unique_ptr<state> m_state;
+
+    async_update_context(entt::registry &registry);
+};
+
+// Set while the update job runs so signal handlers invoked from the job can
+// still call functions that are not allowed while an update is pending.
+static thread_local bool in_update_job = false;
+
+static void refresh_presentation(entt::registry &registry) {
+    if (is_paused(registry)) {
+        snap_presentation(registry);
+    } else {
+        auto time = performance_time();
+        update_presentation(registry, time);
+    }
+}
+
+static void take_presentation_snapshot(entt::registry &registry, presentation_snapshot &snapshot) {
+    auto &entries = snapshot.entries;
+    entries.clear();
+
+    registry.view<present_position, present_orientation>().each(
+        [&] (entt::entity entity, present_position &pos, present_orientation &orn) {
+        entries.push_back({entity, pos, orn});
+    });
+
+    std::sort(entries.begin(), entries.end(), [] (auto &lhs, auto &rhs) {
+        return lhs.entity < rhs.entity;
+    });
+}
+
+static void async_update_job_func(job::data_type &data) {
+    auto archive = memory_input_archive(data.data(), data.size());
+    intptr_t state_intptr;
+    archive(state_intptr);
+    auto *state = reinterpret_cast<async_update_context::state *>(state_intptr);
+    auto &registry = *state->registry;
+
+    in_update_job = true;
+    registry.ctx<island_coordinator>().update();
+    registry.ctx<broadphase_main>().update();
+    in_update_job = false;
+
+    refresh_presentation(registry);
+    take_presentation_snapshot(registry, state->back_snapshot);
+
+    // Notify under the lock since the state could be destroyed right after
+    // the waiting thread observes the job is not running anymore.
+    auto lock = std::lock_guard(state->mutex);
+    state->running = false;
+    state->cv.notify_one();
+}
+
+async_update_context::async_update_context(entt::registry &registry)
+    : m_state(std::make_unique<state>())
+{
+    m_state->registry = &registry;
+    m_state->update_job.func = &async_update_job_func;
+    auto archive = fixed_memory_output_archive(m_state->update_job.data.data(),
+                                               m_state->update_job.data.size());
+    auto state_intptr = reinterpret_cast<intptr_t>(m_state.get());
+    archive(state_intptr);
+}
+
+namespace detail {
+    void throw_if_update_pending(const entt::registry &registry, const char *caller) {
+        if (!in_update_job && is_update_pending(registry)) {
+            throw std::logic_error(std::string(caller) +
+                " called while an asynchronous update is pending. Call edyn::wait_update first.");
+        }
+    }
+}
+
 static void init_meta() {
     using namespace entt::literals;
 
@@ -40,10 +141,16 @@ void init(const init_config &config) {
     auto &dispatcher = job_dispatcher::global();
 
     if (!dispatcher.running()) {
-        if (config.num_worker_threads == 0) {
+        auto num_worker_threads = config.num_worker_threads;
+
+        if (num_worker_threads == 0) {
+            num_worker_threads = std::thread::hardware_concurrency();
+        }
+
+        if (num_worker_threads == 0) {
             dispatcher.start();
         } else {
-            dispatcher.start(config.num_worker_threads);
+            dispatcher.start(num_worker_threads, config.pin_worker_threads);
         }
 
         dispatcher.assure_current_queue();
@@ -61,15 +168,21 @@ void attach(entt::registry &registry) {
     registry.set<island_coordinator>(registry);
     registry.set<broadphase_main>(registry);
     registry.set<material_mix_table>();
+    registry.set<async_update_context>(registry);
 }
 
 void detach(entt::registry &registry) {
+    if (is_update_pending(registry)) {
+        wait_update(registry);
+    }
+
     registry.unset<settings>();
     registry.unset<entity_graph>();
     registry.unset<contact_manifold_map>();
     registry.unset<island_coordinator>();
     registry.unset<broadphase_main>();
     registry.unset<material_mix_table>();
+    registry.unset<async_update_context>();
 }
 
 scalar get_fixed_dt(const entt::registry &registry) {
@@ -77,6 +190,7 @@ scalar get_fixed_dt(const entt::registry &registry) {
 }
 
 void set_fixed_dt(entt::registry &registry, scalar dt) {
+    detail::throw_if_update_pending(registry, "edyn::set_fixed_dt");
     registry.ctx<settings>().fixed_dt = dt;
     registry.ctx<island_coordinator>().settings_changed();
 }
@@ -86,11 +200,14 @@ bool is_paused(const entt::registry &registry) {
 }
 
 void set_paused(entt::registry &registry, bool paused) {
+    detail::throw_if_update_pending(registry, "edyn::set_paused");
     registry.ctx<settings>().paused = paused;
     registry.ctx<island_coordinator>().set_paused(paused);
 }
 
 void update(entt::registry &registry) {
+    detail::throw_if_update_pending(registry, "edyn::update");
+
     // Run jobs scheduled in physics thread.
     job_dispatcher::global().once_current_queue();
 
@@ -101,20 +218,59 @@ void update(entt::registry &registry) {
     // between them which will later cause islands to be merged into one.
     registry.ctx<broadphase_main>().update();
 
-    if (is_paused(registry)) {
-        snap_presentation(registry);
-    } else {
-        auto time = performance_time();
-        update_presentation(registry, time);
+    refresh_presentation(registry);
+}
+
+void update_async(entt::registry &registry) {
+    detail::throw_if_update_pending(registry, "edyn::update_async");
+
+    auto &state = *registry.ctx<async_update_context>().m_state;
+    state.pending = true;
+
+    {
+        auto lock = std::lock_guard(state.mutex);
+        state.running = true;
+    }
+
+    // Run jobs scheduled in physics thread.
+    job_dispatcher::global().once_current_queue();
+
+    job_dispatcher::global().async(state.update_job);
+}
+
+void wait_update(entt::registry &registry) {
+    auto &state = *registry.ctx<async_update_context>().m_state;
+
+    if (!state.pending) {
+        throw std::logic_error("edyn::wait_update called without a pending asynchronous update.");
     }
+
+    {
+        auto lock = std::unique_lock(state.mutex);
+        state.cv.wait(lock, [&] { return !state.running; });
+    }
+
+    state.pending = false;
+    state.snapshot.entries.swap(state.back_snapshot.entries);
+}
+
+bool is_update_pending(const entt::registry &registry) {
+    auto *context = registry.try_ctx<async_update_context>();
+    return context && context->m_state->pending;
+}
+
+const presentation_snapshot & get_presentation_snapshot(const entt::registry &registry) {
+    return registry.ctx<async_update_context>().m_state->snapshot;
 }
 
 void step_simulation(entt::registry &registry) {
+    detail::throw_if_update_pending(registry, "edyn::step_simulation");
     EDYN_ASSERT(is_paused(registry));
     registry.ctx<island_coordinator>().step_simulation();
 }
 
 void remove_external_components(entt::registry &registry) {
+    detail::throw_if_update_pending(registry, "edyn::remove_external_components");
     auto &settings = registry.ctx<edyn::settings>();
     settings.make_reg_op_builder = &make_reg_op_builder_default;
     settings.index_source.reset(new component_index_source_impl(shared_components));
@@ -122,16 +278,19 @@ void remove_external_components(entt::registry &registry) {
 }
 
 void set_external_system_init(entt::registry &registry, external_system_func_t func) {
+    detail::throw_if_update_pending(registry, "edyn::set_external_system_init");
     registry.ctx<settings>().external_system_init = func;
     registry.ctx<island_coordinator>().settings_changed();
 }
 
 void set_external_system_pre_step(entt::registry &registry, external_system_func_t func) {
+    detail::throw_if_update_pending(registry, "edyn::set_external_system_pre_step");
     registry.ctx<settings>().external_system_pre_step = func;
     registry.ctx<island_coordinator>().settings_changed();
 }
 
 void set_external_system_post_step(entt::registry &registry, external_system_func_t func) {
+    detail::throw_if_update_pending(registry, "edyn::set_external_system_post_step");
     registry.ctx<settings>().external_system_post_step = func;
     registry.ctx<island_coordinator>().settings_changed();
 }
@@ -140,6 +299,7 @@ void set_external_system_functions(entt::registry &registry,
                                    external_system_func_t init_func,
                                    external_system_func_t pre_step_func,
                                    external_system_func_t post_step_func) {
+    detail::throw_if_update_pending(registry, "edyn::set_external_system_functions");
     auto &settings = registry.ctx<edyn::settings>();
     settings.external_system_init = init_func;
     settings.external_system_pre_step = pre_step_func;
@@ -148,6 +308,7 @@ void set_external_system_functions(entt::registry &registry,
 }
 
 void remove_external_systems(entt::registry &registry) {
+    detail::throw_if_update_pending(registry, "edyn::remove_external_systems");
     auto &settings = registry.ctx<edyn::settings>();
     settings.external_system_init = nullptr;
     settings.external_system_pre_step = nullptr;
@@ -156,6 +317,8 @@ void remove_external_systems(entt::registry &registry) {
 }
 
 void tag_external_entity(entt::registry &registry, entt::entity entity, bool procedural) {
+    detail::throw_if_update_pending(registry, "edyn::tag_external_entity");
+
     if (procedural) {
         registry.emplace<edyn::procedural_tag>(entity);
     }
@@ -167,6 +330,7 @@ void tag_external_entity(entt::registry &registry, entt::entity entity, bool pro
 }
 
 void set_should_collide(entt::registry &registry, should_collide_func_t func) {
+    detail::throw_if_update_pending(registry, "edyn::set_should_collide");
     registry.ctx<settings>().should_collide_func = func;
     registry.ctx<island_coordinator>().settings_changed();
 }
@@ -176,6 +340,7 @@ bool manifold_exists(entt::registry &registry, entt::entity first, entt::entity
 }
 
 bool manifold_exists(entt::registry &registry, entity_pair entities) {
+    detail::throw_if_update_pending(registry, "edyn::manifold_exists");
     auto &manifold_map = registry.ctx<contact_manifold_map>();
     return manifold_map.contains(entities);
 }
@@ -185,23 +350,28 @@ entt::entity get_manifold_entity(const entt::registry &registry, entt::entity fi
 }
 
 entt::entity get_manifold_entity(const entt::registry &registry, entity_pair entities) {
+    detail::throw_if_update_pending(registry, "edyn::get_manifold_entity");
     auto &manifold_map = registry.ctx<contact_manifold_map>();
     return manifold_map.get(entities);
 }
 
 entt::sink<entt::sigh<void(entt::entity)>> on_contact_started(entt::registry &registry) {
+    detail::throw_if_update_pending(registry, "edyn::on_contact_started");
     return registry.ctx<island_coordinator>().contact_started_sink();
 }
 
 entt::sink<entt::sigh<void(entt::entity)>> on_contact_ended(entt::registry &registry) {
+    detail::throw_if_update_pending(registry, "edyn::on_contact_ended");
     return registry.ctx<island_coordinator>().contact_ended_sink();
 }
 
 entt::sink<entt::sigh<void(entt::entity, contact_manifold::contact_id_type)>> on_contact_point_created(entt::registry &registry) {
+    detail::throw_if_update_pending(registry, "edyn::on_contact_point_created");
     return registry.ctx<island_coordinator>().contact_point_created_sink();
 }
 
 entt::sink<entt::sigh<void(entt::entity, contact_manifold::contact_id_type)>> on_contact_point_destroyed(entt::registry &registry) {
+    detail::throw_if_update_pending(registry, "edyn::on_contact_point_destroyed");
     return registry.ctx<island_coordinator>().contact_point_destroyed_sink();
 }
 
@@ -210,6 +380,7 @@ vector3 get_gravity(const entt::registry &registry) {
 }
 
 void set_gravity(entt::registry &registry, vector3 gravity) {
+    detail::throw_if_update_pending(registry, "edyn::set_gravity");
     registry.ctx<settings>().gravity = gravity;
 
     auto view = registry.view<edyn::gravity, procedural_tag, rigidbody_tag>();
@@ -225,6 +396,7 @@ unsigned get_solver_velocity_iterations(const entt::registry &registry) {
 }
 
 void set_solver_velocity_iterations(entt::registry &registry, unsigned iterations) {
+    detail::throw_if_update_pending(registry, "edyn::set_solver_velocity_iterations");
     auto &settings = registry.ctx<edyn::settings>();
     settings.num_solver_velocity_iterations = iterations;
     registry.ctx<island_coordinator>().settings_changed();
@@ -235,6 +407,7 @@ unsigned get_solver_position_iterations(const entt::registry &registry) {
 }
 
 void set_solver_position_iterations(entt::registry &registry, unsigned iterations) {
+    detail::throw_if_update_pending(registry, "edyn::set_solver_position_iterations");
     auto &settings = registry.ctx<edyn::settings>();
     settings.num_solver_position_iterations = iterations;
     registry.ctx<island_coordinator>().settings_changed();
@@ -245,6 +418,7 @@ unsigned get_solver_restitution_iterations(const entt::registry &registry) {
 }
 
 void set_solver_restitution_iterations(entt::registry &registry, unsigned iterations) {
+    detail::throw_if_update_pending(registry, "edyn::set_solver_restitution_iterations");
     auto &settings = registry.ctx<edyn::settings>();
     settings.num_restitution_iterations = iterations;
     registry.ctx<island_coordinator>().settings_changed();
@@ -255,13 +429,26 @@ unsigned get_solver_individual_restitution_iterations(const entt::registry &regi
 }
 
 void set_solver_individual_restitution_iterations(entt::registry &registry, unsigned iterations) {
+    detail::throw_if_update_pending(registry, "edyn::set_solver_individual_restitution_iterations");
     auto &settings = registry.ctx<edyn::settings>();
     settings.num_individual_restitution_iterations = iterations;
     registry.ctx<island_coordinator>().settings_changed();
 }
 
+unsigned get_paged_mesh_prefetch_steps(const entt::registry &registry) {
+    return registry.ctx<settings>().num_paged_mesh_prefetch_steps;
+}
+
+void set_paged_mesh_prefetch_steps(entt::registry &registry, unsigned steps) {
+    detail::throw_if_update_pending(registry, "edyn::set_paged_mesh_prefetch_steps");
+    auto &settings = registry.ctx<edyn::settings>();
+    settings.num_paged_mesh_prefetch_steps = steps;
+    registry.ctx<island_coordinator>().settings_changed();
+}
+
 void insert_material_mixing(entt::registry &registry, material::id_type material_id0,
                             material::id_type material_id1, const material_base &material) {
+    detail::throw_if_update_pending(registry, "edyn::insert_material_mixing");
     auto &material_table = registry.ctx<material_mix_table>();
     material_table.insert({material_id0, material_id1}, material);
     registry.ctx<island_coordinator>().material_table_changed();
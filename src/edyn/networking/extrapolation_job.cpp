@@ -223,11 +223,11 @@ void extrapolation_job::sync_and_finish() {
         if (auto *dirty = m_registry.try_get<edyn::dirty>(local_entity)) {
             // Only consider updated indices. Entities and components shouldn't be
             // created during extrapolation.
-            for (auto id : dirty->updated_indexes) {
+            dirty->each_updated_id([&] (entt::id_type id) {
                 if (!is_owned_entity || !(*m_input.is_input_component_func)(id)) {
                     builder->replace_type_id(m_registry, local_entity, id);
                 }
-            }
+            });
         }
 
         m_result.entities.push_back(local_entity);
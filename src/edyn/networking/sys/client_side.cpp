@@ -265,11 +265,14 @@ static void publish_dirty_components(entt::registry &registry, double time) {
     // as dirty must be ignored, since they're updated regularly via the
     // transient snapshots.
     for (auto [entity, dirty] : dirty_view.each()) {
-        for (auto id : dirty.updated_indexes) {
-            if (!ctx.snapshot_exporter->is_transient(id)) {
-                packet.entities.push_back(entity);
-                break;
-            }
+        auto has_steady = false;
+
+        dirty.each_updated_id([&] (entt::id_type id) {
+            has_steady |= !ctx.snapshot_exporter->is_transient(id);
+        });
+
+        if (has_steady) {
+            packet.entities.push_back(entity);
         }
     }
 
@@ -277,11 +280,11 @@ static void publish_dirty_components(entt::registry &registry, double time) {
     // point so entity indices can be assigned in the registry snapshot of the
     // packet.
     for (auto [entity, dirty] : dirty_view.each()) {
-        for (auto id : dirty.updated_indexes) {
+        dirty.each_updated_id([&] (entt::id_type id) {
             if (!ctx.snapshot_exporter->is_transient(id)) {
                 ctx.snapshot_exporter->export_by_type_id(registry, entity, id, packet);
             }
-        }
+        });
     }
 
     if (!packet.entities.empty() && !packet.pools.empty()) {
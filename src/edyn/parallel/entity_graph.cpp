@@ -1,13 +1,23 @@
 #include "edyn/parallel/entity_graph.hpp"
+#include "edyn/parallel/job_dispatcher.hpp"
+#include "edyn/parallel/parallel_for.hpp"
 #include "edyn/config/config.h"
+#include <atomic>
+#include <algorithm>
 
 namespace edyn {
 
 static constexpr size_t allocation_size = 16;
 
+// Minimum number of nodes for connected components to be calculated in
+// parallel.
+static constexpr size_t parallel_connected_components_min_nodes = 16384;
+
 entity_graph::index_type entity_graph::insert_node(entt::entity entity, bool non_connecting) {
     EDYN_ASSERT(entity != entt::null);
 
+    m_compact = false;
+
     if (m_nodes_free_list == null_index) {
         m_nodes_free_list = m_nodes.size();
         m_nodes.resize(m_nodes.size() + allocation_size);
@@ -17,6 +27,7 @@ entity_graph::index_type entity_graph::insert_node(entt::entity entity, bool non
             node.next = i + 1;
             node.adjacency_index = null_index;
             node.entity = entt::null;
+            node.generation = 0;
         }
 
         m_nodes.back().next = null_index;
@@ -39,8 +50,11 @@ void entity_graph::remove_node(index_type node_index) {
     // Node must not have any edges.
     EDYN_ASSERT(m_nodes[node_index].adjacency_index == null_index);
 
+    m_compact = false;
+
     m_nodes[node_index].entity = entt::null;
     m_nodes[node_index].next = m_nodes_free_list;
+    ++m_nodes[node_index].generation;
     m_nodes_free_list = node_index;
     --m_node_count;
 }
@@ -57,6 +71,8 @@ entity_graph::index_type entity_graph::insert_edge(entt::entity entity, index_ty
     EDYN_ASSERT(m_nodes[node_index0].entity != entt::null);
     EDYN_ASSERT(m_nodes[node_index1].entity != entt::null);
 
+    m_compact = false;
+
     if (m_edges_free_list == null_index) {
         m_edges_free_list = m_edges.size();
         m_edges.resize(m_edges.size() + allocation_size);
@@ -131,6 +147,8 @@ void entity_graph::remove_edge(index_type edge_index) {
     EDYN_ASSERT(edge_index < m_edges.size());
     EDYN_ASSERT(m_edges[edge_index].entity != entt::null);
 
+    m_compact = false;
+
     auto &edge = m_edges[edge_index];
     auto &node0 = m_nodes[edge.node_index0];
     auto &node1 = m_nodes[edge.node_index1];
@@ -150,6 +168,15 @@ void entity_graph::remove_edge(index_type edge_index) {
     EDYN_ASSERT(m_adjacencies[adj_index0].edge_index == m_adjacencies[adj_index1].edge_index);
     auto first_edge_index = m_adjacencies[adj_index0].edge_index;
 
+    // The nodes could become disconnected if this is the only edge between
+    // them. Non-connecting nodes do not join connected components.
+    if (m_track_disconnections &&
+        edge_index == first_edge_index && edge.next == null_index &&
+        !node0.non_connecting && !node1.non_connecting) {
+        m_disconnection_candidates.push_back({edge.node_index0, edge.node_index1,
+                                              node0.generation, node1.generation});
+    }
+
     remove_adjacency_edge(edge.node_index0, adj_index0, edge_index);
     remove_adjacency_edge(edge.node_index1, adj_index1, edge_index);
 
@@ -172,7 +199,32 @@ void entity_graph::remove_edge(index_type edge_index) {
 }
 
 void entity_graph::remove_all_edges(index_type node_index) {
+    m_compact = false;
+
     auto &node = m_nodes[node_index];
+
+    // The connecting neighbors of a connecting node could become disconnected
+    // from one another.
+    if (m_track_disconnections && !node.non_connecting) {
+        auto first_neighbor_index = null_index;
+
+        for (auto idx = node.adjacency_index; idx != null_index; idx = m_adjacencies[idx].next) {
+            auto neighbor_index = m_adjacencies[idx].node_index;
+
+            if (m_nodes[neighbor_index].non_connecting) {
+                continue;
+            }
+
+            if (first_neighbor_index == null_index) {
+                first_neighbor_index = neighbor_index;
+            } else {
+                m_disconnection_candidates.push_back({first_neighbor_index, neighbor_index,
+                                                      m_nodes[first_neighbor_index].generation,
+                                                      m_nodes[neighbor_index].generation});
+            }
+        }
+    }
+
     auto adj_index = node.adjacency_index;
     node.adjacency_index = null_index;
 
@@ -363,18 +415,12 @@ bool entity_graph::is_single_connected_component() {
             continue;
         }
 
-        auto adj_index = node.adjacency_index;
-
-        while (adj_index != null_index) {
-            auto neighbor_index = m_adjacencies[adj_index].node_index;
-
+        each_adjacency(node_index, [&] (index_type neighbor_index, index_type) {
             if (!m_visited[neighbor_index]) {
                 to_visit.push_back(neighbor_index);
                 m_visited[neighbor_index] = true;
             }
-
-            adj_index = m_adjacencies[adj_index].next;
-        }
+        });
     }
 
     // Check if there's any one connecting node that has not been visited.
@@ -390,6 +436,11 @@ bool entity_graph::is_single_connected_component() {
 }
 
 entity_graph::connected_components_t entity_graph::connected_components() {
+    if (m_node_count >= parallel_connected_components_min_nodes &&
+        job_dispatcher::global().running()) {
+        return connected_components_parallel();
+    }
+
     auto components = entity_graph::connected_components_t{};
     m_visited.assign(m_nodes.size(), false);
     m_visited_edges.assign(m_edges.size(), false);
@@ -424,12 +475,7 @@ entity_graph::connected_components_t entity_graph::connected_components() {
                 continue;
             }
 
-            auto adj_index = node.adjacency_index;
-
-            while (adj_index != null_index) {
-                auto &adj = m_adjacencies[adj_index];
-                auto edge_index = adj.edge_index;
-
+            each_adjacency(node_index, [&] (index_type neighbor_index, index_type edge_index) {
                 while (edge_index != null_index) {
                     auto &edge = m_edges[edge_index];
 
@@ -442,17 +488,13 @@ entity_graph::connected_components_t entity_graph::connected_components() {
                     edge_index = edge.next;
                 }
 
-                auto neighbor_index = adj.node_index;
-
                 if (!m_visited[neighbor_index]) {
                     to_visit.push_back(neighbor_index);
                     // Mark as visited in advance to prevent inserting the same node index
                     // in the `to_visit` array more than once.
                     m_visited[neighbor_index] = true;
                 }
-
-                adj_index = adj.next;
-            }
+            });
         }
 
         // Mark non-connecting nodes as unvisited so they'll be visited again
@@ -481,6 +523,286 @@ entity_graph::connected_components_t entity_graph::connected_components() {
     return components;
 }
 
+void entity_graph::find_roots_parallel(const std::vector<uint8_t> *reachable,
+                                       std::vector<index_type> &roots) const {
+    // Concurrent union-find over all edges which join two connecting nodes.
+    auto parent = std::vector<std::atomic<index_type>>(m_nodes.size());
+
+    for (size_t i = 0; i < parent.size(); ++i) {
+        parent[i].store(i, std::memory_order_relaxed);
+    }
+
+    auto find = [&] (index_type index) {
+        while (true) {
+            auto p = parent[index].load(std::memory_order_relaxed);
+            auto gp = parent[p].load(std::memory_order_relaxed);
+
+            if (p == gp) {
+                return p;
+            }
+
+            // Path halving.
+            parent[index].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+            index = gp;
+        }
+    };
+
+    auto unite = [&] (index_type a, index_type b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+
+            if (a == b) {
+                return;
+            }
+
+            // Always link the larger root to the smaller one so that no
+            // cycles can form and the root of a component ends up being its
+            // lowest node index.
+            if (a < b) {
+                std::swap(a, b);
+            }
+
+            if (parent[a].compare_exchange_strong(a, b, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    };
+
+    auto unite_edge = [&] (size_t edge_index) {
+        auto &edge = m_edges[edge_index];
+
+        if (edge.entity == entt::null ||
+            m_nodes[edge.node_index0].non_connecting ||
+            m_nodes[edge.node_index1].non_connecting) {
+            return;
+        }
+
+        if (reachable && (!(*reachable)[edge.node_index0] || !(*reachable)[edge.node_index1])) {
+            return;
+        }
+
+        unite(edge.node_index0, edge.node_index1);
+    };
+
+    if (m_edges.size() > 1) {
+        parallel_for(size_t{0}, m_edges.size(), unite_edge);
+    } else if (!m_edges.empty()) {
+        unite_edge(0);
+    }
+
+    roots.resize(m_nodes.size());
+
+    if (m_nodes.size() > 1) {
+        parallel_for(size_t{0}, m_nodes.size(), [&] (size_t node_index) {
+            roots[node_index] = find(node_index);
+        });
+    } else if (!m_nodes.empty()) {
+        roots[0] = 0;
+    }
+}
+
+entity_graph::connected_components_t entity_graph::connected_components_parallel() {
+    auto roots = std::vector<index_type>{};
+    find_roots_parallel(nullptr, roots);
+
+    // Assign a component to each root in order of node index.
+    auto component_index = std::vector<index_type>(m_nodes.size(), null_index);
+    auto components = connected_components_t{};
+
+    for (size_t node_index = 0; node_index < m_nodes.size(); ++node_index) {
+        auto &node = m_nodes[node_index];
+
+        if (node.entity == entt::null || node.non_connecting) {
+            continue;
+        }
+
+        auto root = roots[node_index];
+
+        if (component_index[root] == null_index) {
+            component_index[root] = components.size();
+            components.emplace_back();
+        }
+
+        component_index[node_index] = component_index[root];
+        components[component_index[node_index]].nodes.push_back(node.entity);
+    }
+
+    // Non-connecting nodes are added to the components of all of their
+    // connecting neighbors.
+    auto last_component_stamp = std::vector<index_type>(components.size(), null_index);
+
+    for (size_t node_index = 0; node_index < m_nodes.size(); ++node_index) {
+        auto &node = m_nodes[node_index];
+
+        if (node.entity == entt::null || !node.non_connecting) {
+            continue;
+        }
+
+        each_adjacency(node_index, [&] (index_type neighbor_index, index_type) {
+            auto index = component_index[neighbor_index];
+
+            if (index != null_index && last_component_stamp[index] != node_index) {
+                last_component_stamp[index] = node_index;
+                components[index].nodes.push_back(node.entity);
+            }
+        });
+    }
+
+    // Edges belong to the component of their connecting nodes. Edges between
+    // two non-connecting nodes do not belong to any component.
+    for (auto &edge : m_edges) {
+        if (edge.entity == entt::null) {
+            continue;
+        }
+
+        auto index = component_index[edge.node_index0];
+
+        if (index == null_index) {
+            index = component_index[edge.node_index1];
+        }
+
+        if (index != null_index) {
+            components[index].edges.push_back(edge.entity);
+        }
+    }
+
+    return components;
+}
+
+void entity_graph::compact() {
+    m_compact_offsets.resize(m_nodes.size() + 1);
+    m_compact_adjacencies.clear();
+
+    for (size_t node_index = 0; node_index < m_nodes.size(); ++node_index) {
+        m_compact_offsets[node_index] = m_compact_adjacencies.size();
+        // Free nodes have no adjacencies.
+        auto adj_index = m_nodes[node_index].adjacency_index;
+
+        while (adj_index != null_index) {
+            auto &adj = m_adjacencies[adj_index];
+            m_compact_adjacencies.push_back({adj.node_index, adj.edge_index});
+            adj_index = adj.next;
+        }
+    }
+
+    m_compact_offsets[m_nodes.size()] = m_compact_adjacencies.size();
+    m_compact = true;
+}
+
+entity_graph::disconnection_result
+entity_graph::is_connected(index_type node_index0, index_type node_index1, size_t &budget) {
+    if (node_index0 == node_index1) {
+        return disconnection_result::connected;
+    }
+
+    m_search_side.resize(m_nodes.size(), 0);
+
+    // Breadth-first search from both nodes, one level at a time, always
+    // expanding the smaller frontier. If the searches meet, the nodes are
+    // connected. If one of them runs out of nodes to visit, it has explored an
+    // entire connected component which does not contain the other node.
+    for (auto &frontier : m_search_frontier) {
+        frontier.clear();
+    }
+
+    m_search_frontier[0].push_back(node_index0);
+    m_search_frontier[1].push_back(node_index1);
+    m_search_touched.clear();
+    m_search_touched.push_back(node_index0);
+    m_search_touched.push_back(node_index1);
+    m_search_side[node_index0] = 1;
+    m_search_side[node_index1] = 2;
+    auto result = disconnection_result::undetermined;
+
+    while (result == disconnection_result::undetermined) {
+        if (m_search_frontier[0].empty() || m_search_frontier[1].empty()) {
+            result = disconnection_result::disconnected;
+            break;
+        }
+
+        if (budget == 0) {
+            break;
+        }
+
+        size_t i = m_search_frontier[0].size() <= m_search_frontier[1].size() ? 0 : 1;
+        auto side = static_cast<uint8_t>(i + 1);
+        m_search_next_frontier.clear();
+
+        for (auto node_index : m_search_frontier[i]) {
+            each_adjacency(node_index, [&] (index_type neighbor_index, index_type) {
+                if (result != disconnection_result::undetermined ||
+                    m_nodes[neighbor_index].non_connecting) {
+                    return;
+                }
+
+                auto neighbor_side = m_search_side[neighbor_index];
+
+                if (neighbor_side == 0) {
+                    m_search_side[neighbor_index] = side;
+                    m_search_next_frontier.push_back(neighbor_index);
+                    m_search_touched.push_back(neighbor_index);
+                } else if (neighbor_side != side) {
+                    result = disconnection_result::connected;
+                }
+            });
+
+            if (result != disconnection_result::undetermined) {
+                break;
+            }
+        }
+
+        budget -= std::min(budget, m_search_next_frontier.size());
+        std::swap(m_search_frontier[i], m_search_next_frontier);
+    }
+
+    // Only reset the nodes that were reached to keep the cost proportional
+    // to the size of the search.
+    for (auto node_index : m_search_touched) {
+        m_search_side[node_index] = 0;
+    }
+
+    return result;
+}
+
+void entity_graph::set_track_disconnections(bool track) {
+    m_track_disconnections = track;
+
+    if (!track) {
+        m_disconnection_candidates.clear();
+    }
+}
+
+entity_graph::disconnection_result entity_graph::check_disconnection(size_t max_visits) {
+    auto result = disconnection_result::connected;
+    auto budget = max_visits;
+
+    for (auto &candidate : m_disconnection_candidates) {
+        auto &node0 = m_nodes[candidate.node_index0];
+        auto &node1 = m_nodes[candidate.node_index1];
+
+        // Nodes might have been removed in the meantime and their indices
+        // could have been taken by new nodes.
+        if (node0.entity == entt::null || node1.entity == entt::null ||
+            node0.generation != candidate.generation0 ||
+            node1.generation != candidate.generation1 ||
+            node0.non_connecting || node1.non_connecting) {
+            continue;
+        }
+
+        auto candidate_result = is_connected(candidate.node_index0, candidate.node_index1, budget);
+
+        if (candidate_result != disconnection_result::connected) {
+            result = candidate_result;
+            break;
+        }
+    }
+
+    m_disconnection_candidates.clear();
+
+    return result;
+}
+
 double entity_graph::efficiency() const {
     if (m_nodes.empty()) {
         return 0;
@@ -26,6 +26,13 @@
 
 namespace edyn {
 
+// Minimum number of new nodes and edges in one update for the entity graph to
+// be compacted before being traversed.
+static constexpr size_t compact_graph_min_new_elements = 1024;
+// Maximum ratio between the size of the entity graph and the number of new
+// nodes and edges for the graph to be compacted.
+static constexpr size_t compact_graph_max_size_ratio = 4;
+
 island_coordinator::island_coordinator(entt::registry &registry)
     : m_registry(&registry)
 {
@@ -205,11 +212,21 @@ void island_coordinator::init_new_nodes_and_edges() {
         }
     }
 
+    auto num_new_elements = m_new_graph_nodes.size() + m_new_graph_edges.size();
     m_new_graph_nodes.clear();
     m_new_graph_edges.clear();
 
     if (procedural_node_indices.empty()) return;
 
+    // Traversing the linked adjacency lists after a bulk insertion is slow
+    // since they're scattered in memory. Compacting goes over the entire
+    // graph though, thus only do it if the new elements, which is roughly
+    // what will be traversed next, make up a significant part of it.
+    if (num_new_elements >= compact_graph_min_new_elements &&
+        num_new_elements * compact_graph_max_size_ratio >= graph.num_nodes() + graph.num_edges()) {
+        graph.compact();
+    }
+
     std::vector<entt::entity> connected_nodes;
     std::vector<entt::entity> connected_edges;
     std::vector<entt::entity> island_entities;
@@ -221,11 +238,18 @@ void island_coordinator::init_new_nodes_and_edges() {
         [&] (entt::entity entity) { // visitNodeFunc
             // Always add non-procedurals to the connected component.
             // Only add procedural if it's not in an island yet.
-            auto is_procedural = procedural_view.contains(entity);
+            if (!procedural_view.contains(entity)) {
+                connected_nodes.push_back(entity);
+                return;
+            }
 
-            if (!is_procedural ||
-                (is_procedural && resident_view.get<island_resident>(entity).island_entity == entt::null)) {
+            auto island_entity = resident_view.get<island_resident>(entity).island_entity;
+
+            if (island_entity == entt::null) {
                 connected_nodes.push_back(entity);
+            } else if (!vector_contains(island_entities, island_entity)) {
+                // Collect islands involved in this connected component.
+                island_entities.push_back(island_entity);
             }
         },
         [&] (entt::entity entity) { // visitEdgeFunc
@@ -242,9 +266,10 @@ void island_coordinator::init_new_nodes_and_edges() {
             }
         },
         [&] (entity_graph::index_type node_index) { // shouldVisitFunc
+            // This might be called from multiple threads for large updates
+            // thus it must only read from the registry.
             auto other_entity = graph.node_entity(node_index);
 
-            // Collect islands involved in this connected component.
             // Always visit the non-procedural nodes. Their edges won't be
             // visited later because in the graph they're non-connecting nodes.
             if (!procedural_view.contains(other_entity)) {
@@ -258,12 +283,10 @@ void island_coordinator::init_new_nodes_and_edges() {
                 return true;
             }
 
-            auto contains_island = vector_contains(island_entities, other_resident.island_entity);
-
-            if (!contains_island) {
-                island_entities.push_back(other_resident.island_entity);
-            }
-
+            // Nodes already in an island are only visited if they have edges
+            // that are not in an island yet. Otherwise, they are reached via
+            // an edge of their island, which adds the island to the connected
+            // component in `visitEdgeFunc`.
             bool continue_visiting = false;
 
             // Visit neighbor if it contains an edge that is not in an island yet.
@@ -557,18 +580,13 @@ void island_coordinator::refresh_dirty_entities() {
             builder->create(entity);
         }
 
-        builder->emplace_type_ids(*m_registry, entity,
-            dirty.created_indexes.begin(), dirty.created_indexes.end());
-        builder->replace_type_ids(*m_registry, entity,
-            dirty.updated_indexes.begin(), dirty.updated_indexes.end());
-        builder->remove_type_ids(*m_registry, entity,
-            dirty.destroyed_indexes.begin(), dirty.destroyed_indexes.end());
+        builder->insert_dirty(*m_registry, entity, dirty);
     };
 
     dirty_view.each([&] (entt::entity entity, dirty &dirty) {
-        remove_unshared(dirty.created_indexes);
-        remove_unshared(dirty.updated_indexes);
-        remove_unshared(dirty.destroyed_indexes);
+        remove_unshared(dirty.created_ids);
+        remove_unshared(dirty.updated_ids);
+        remove_unshared(dirty.destroyed_ids);
 
         if (resident_view.contains(entity)) {
             refresh(entity, dirty, resident_view.get<island_resident>(entity).island_entity);
@@ -583,7 +601,7 @@ void island_coordinator::refresh_dirty_entities() {
     m_registry->clear<dirty>();
 }
 
-void island_coordinator::on_island_reg_ops(entt::entity source_island_entity, const msg::island_reg_ops &msg) {
+void island_coordinator::on_island_reg_ops(entt::entity source_island_entity, msg::island_reg_ops &msg) {
     m_importing = true;
     auto &source_ctx = m_island_ctx_map.at(source_island_entity);
 
@@ -662,6 +680,9 @@ void island_coordinator::on_island_reg_ops(entt::entity source_island_entity, co
             m_contact_ended_signal.publish(manifold_entity);
         }
     });
+
+    // Hand storage back to the island worker.
+    msg.ops.recycle();
 }
 
 void island_coordinator::on_split_island(entt::entity source_island_entity, const msg::split_island &) {
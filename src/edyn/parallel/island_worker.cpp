@@ -50,6 +50,21 @@
 
 namespace edyn {
 
+// Last AABB sent to the coordinator.
+struct synced_aabb {
+    AABB value;
+};
+
+// Number of contact points in the last manifold sent to the coordinator.
+struct synced_manifold {
+    uint8_t num_points;
+};
+
+template<typename Synced>
+static void remove_synced(entt::registry &registry, entt::entity entity) {
+    registry.remove<Synced>(entity);
+}
+
 void island_worker_func(job::data_type &data) {
     auto archive = memory_input_archive(data.data(), data.size());
     intptr_t worker_intptr;
@@ -84,7 +99,7 @@ island_worker::island_worker(entt::entity island_entity, const settings &setting
     m_registry.set<contact_manifold_map>(m_registry);
     m_registry.set<broadphase_worker>(m_registry);
     m_registry.set<narrowphase>(m_registry);
-    m_registry.set<entity_graph>();
+    m_registry.set<entity_graph>().set_track_disconnections(true);
     m_registry.set<edyn::settings>(settings);
     m_registry.set<material_mix_table>(material_table);
 
@@ -108,6 +123,9 @@ void island_worker::init() {
     m_registry.on_construct<graph_node>().connect<&island_worker::on_construct_graph_node>(*this);
     m_registry.on_destroy<graph_node>().connect<&island_worker::on_destroy_graph_node>(*this);
     m_registry.on_destroy<graph_edge>().connect<&island_worker::on_destroy_graph_edge>(*this);
+    // Components replaced by imported operations must be synced again.
+    m_registry.on_update<AABB>().connect<&remove_synced<synced_aabb>>();
+    m_registry.on_update<contact_manifold>().connect<&remove_synced<synced_manifold>>();
     m_registry.on_construct<polyhedron_shape>().connect<&island_worker::on_construct_polyhedron_shape>(*this);
     m_registry.on_construct<compound_shape>().connect<&island_worker::on_construct_compound_shape>(*this);
     m_registry.on_destroy<rotated_mesh_list>().connect<&island_worker::on_destroy_rotated_mesh_list>(*this);
@@ -202,8 +220,6 @@ void island_worker::on_destroy_graph_edge(entt::registry &registry, entt::entity
     if (m_entity_map.contains_other(entity)) {
         m_entity_map.erase_other(entity);
     }
-
-    m_topology_changed = true;
 }
 
 void island_worker::on_construct_polyhedron_shape(entt::registry &registry, entt::entity entity) {
@@ -222,11 +238,13 @@ void island_worker::on_destroy_rotated_mesh_list(entt::registry &registry, entt:
     }
 }
 
-void island_worker::on_island_reg_ops(const msg::island_reg_ops &msg) {
+void island_worker::on_island_reg_ops(msg::island_reg_ops &msg) {
     // Import components from main registry.
     m_importing = true;
 
-    msg.ops.execute(m_registry, m_entity_map);
+    // Emit update signals to reset the synced copies of replaced AABBs and
+    // manifolds.
+    msg.ops.execute(m_registry, m_entity_map, false, true);
 
     msg.ops.create_for_each([&] (entt::entity remote_entity) {
         auto local_entity = m_entity_map.at(remote_entity);
@@ -307,6 +325,9 @@ void island_worker::on_island_reg_ops(const msg::island_reg_ops &msg) {
     }
 
     m_importing = false;
+
+    // Hand storage back to the coordinator.
+    msg.ops.recycle();
 }
 
 void island_worker::on_wake_up_island(const msg::wake_up_island &) {
@@ -325,15 +346,69 @@ void island_worker::on_wake_up_island(const msg::wake_up_island &) {
     m_message_queue.send<msg::island_reg_ops>(std::move(op));
 }
 
-void island_worker::sync() {
-    // Always update AABBs since they're needed for broad-phase in the coordinator.
-    m_op_builder->replace<AABB>(m_registry);
+void island_worker::sync_aabbs() {
+    // AABBs are needed for broad-phase in the coordinator, which inflates
+    // them by a larger amount than the island worker. Only send an AABB if it
+    // has moved outside of the inflated box of the last one sent, which
+    // avoids sending anything for bodies which are resting. Thus, AABBs in the
+    // main registry can lag behind by up to `contact_breaking_threshold`.
+    constexpr auto aabb_offset = vector3_one * -contact_breaking_threshold;
+    auto aabb_view = m_registry.view<AABB>();
+    auto synced_view = m_registry.view<synced_aabb>();
+
+    for (auto entity : aabb_view) {
+        auto &aabb = aabb_view.get<AABB>(entity);
+
+        if (synced_view.contains(entity)) {
+            auto &synced = synced_view.get<synced_aabb>(entity);
+
+            if (synced.value.inset(aabb_offset).contains(aabb)) {
+                continue;
+            }
 
+            synced.value = aabb;
+        } else {
+            m_registry.emplace<synced_aabb>(entity, aabb);
+        }
+
+        m_op_builder->replace<AABB>(entity, aabb);
+    }
+}
+
+void island_worker::sync_manifolds() {
     // Updated contact points are needed when moving entities from one island to
-    // another when merging/splitting in the coordinator.
+    // another when merging/splitting in the coordinator and contact points are
+    // stored in the manifold. Contact points change in every step (lifetime,
+    // impulses, pivots), thus manifolds with contact points are always sent.
+    // Only manifolds which remain empty, i.e. bodies which are close but not
+    // touching, are skipped.
     // TODO: the island worker refactor would eliminate the need to share these
     // components continuously.
-    m_op_builder->replace<contact_manifold>(m_registry);
+    auto manifold_view = m_registry.view<contact_manifold>();
+    auto synced_view = m_registry.view<synced_manifold>();
+
+    for (auto entity : manifold_view) {
+        auto &manifold = manifold_view.get<contact_manifold>(entity);
+
+        if (synced_view.contains(entity)) {
+            auto &synced = synced_view.get<synced_manifold>(entity);
+
+            if (manifold.num_points == 0 && synced.num_points == 0) {
+                continue;
+            }
+
+            synced.num_points = manifold.num_points;
+        } else {
+            m_registry.emplace<synced_manifold>(entity, manifold.num_points);
+        }
+
+        m_op_builder->replace<contact_manifold>(entity, manifold);
+    }
+}
+
+void island_worker::sync() {
+    sync_aabbs();
+    sync_manifolds();
 
     // Always update discontinuities since they decay in every step.
     m_op_builder->replace<discontinuity>(m_registry);
@@ -361,18 +436,15 @@ void island_worker::sync_dirty() {
             m_op_builder->create(entity);
         }
 
-        m_op_builder->emplace_type_ids(m_registry, entity,
-            dirty.created_indexes.begin(), dirty.created_indexes.end());
-        m_op_builder->replace_type_ids(m_registry, entity,
-            dirty.updated_indexes.begin(), dirty.updated_indexes.end());
-        m_op_builder->remove_type_ids(m_registry, entity,
-            dirty.destroyed_indexes.begin(), dirty.destroyed_indexes.end());
+        m_op_builder->insert_dirty(m_registry, entity, dirty);
     });
 
     m_registry.clear<dirty>();
 }
 
 void island_worker::update() {
+    m_worker_index.store(job_dispatcher::global().current_worker_index(), std::memory_order_relaxed);
+
     switch (m_state) {
     case state::init:
         init();
@@ -576,6 +648,12 @@ void island_worker::finish_step() {
 
     m_op_builder->replace<island_timestamp>(m_registry, m_island_entity);
 
+    // Estimate cost of the next step by the number of rigid bodies and
+    // constraint rows in this step.
+    auto num_bodies = m_registry.view<procedural_tag>().size();
+    auto step_cost = std::min(num_bodies + m_solver.num_rows(), size_t(UINT32_MAX));
+    m_step_cost.store(static_cast<uint32_t>(step_cost), std::memory_order_relaxed);
+
     // Update tree view.
     auto &bphase = m_registry.ctx<broadphase_worker>();
     auto tview = bphase.view();
@@ -612,6 +690,21 @@ void island_worker::finish_step() {
 }
 
 bool island_worker::should_split() {
+    // The entity graph keeps track of edges and nodes that were removed and
+    // checks whether the nodes they joined are still connected right away.
+    // If that takes too long, fall back to checking the whole graph later.
+    switch (m_registry.ctx<entity_graph>().check_disconnection()) {
+    case entity_graph::disconnection_result::disconnected:
+        return true;
+    case entity_graph::disconnection_result::undetermined:
+        m_topology_changed = true;
+        break;
+    case entity_graph::disconnection_result::connected:
+        break;
+    }
+
+    // New nodes might not be connected to the rest of the graph yet. Give it
+    // a moment before checking the whole graph.
     if (!m_topology_changed) return false;
 
     auto time = performance_time();
@@ -636,7 +729,8 @@ bool island_worker::should_split() {
 }
 
 void island_worker::reschedule_now() {
-    job_dispatcher::global().async(m_this_job);
+    job_dispatcher::global().async_with_affinity(m_this_job, m_worker_index.load(std::memory_order_relaxed),
+                                                 m_step_cost.load(std::memory_order_relaxed));
 }
 
 void island_worker::maybe_reschedule() {
@@ -674,10 +768,13 @@ void island_worker::reschedule_later() {
     auto fixed_dt = m_registry.ctx<edyn::settings>().fixed_dt;
     auto delta_time = isle_time.value + fixed_dt - time;
 
+    auto worker_index = m_worker_index.load(std::memory_order_relaxed);
+    auto step_cost = m_step_cost.load(std::memory_order_relaxed);
+
     if (delta_time > 0) {
-        job_dispatcher::global().async_after(delta_time, m_this_job);
+        job_dispatcher::global().async_after(delta_time, m_this_job, worker_index, step_cost);
     } else {
-        job_dispatcher::global().async(m_this_job);
+        job_dispatcher::global().async_with_affinity(m_this_job, worker_index, step_cost);
     }
 }
 
@@ -691,7 +788,8 @@ void island_worker::reschedule() {
     auto reschedule_count = m_reschedule_counter.fetch_add(1, std::memory_order_acq_rel);
     if (reschedule_count > 0) return;
 
-    job_dispatcher::global().async(m_this_job);
+    job_dispatcher::global().async_with_affinity(m_this_job, m_worker_index.load(std::memory_order_relaxed),
+                                                 m_step_cost.load(std::memory_order_relaxed));
 }
 
 void island_worker::init_new_shapes() {
@@ -858,17 +956,17 @@ void island_worker::import_contact_manifolds(const std::vector<contact_manifold>
         manifold.body[1] = m_entity_map.at(manifold.body[1]);
 
         // Find a matching manifold and replace it...
-        if (manifold_map.contains(manifold.body[0], manifold.body[1])) {
-            auto manifold_entity = manifold_map.get(manifold.body[0], manifold.body[1]);
-            m_registry.get<contact_manifold>(manifold_entity) = manifold;
-        } else {
+        auto manifold_entity = manifold_map.find(manifold.body[0], manifold.body[1]);
+
+        if (manifold_entity == entt::null) {
             // ...or create a new one and assign a new value to it.
             auto separation_threshold = contact_breaking_threshold * scalar(1.3);
-            auto manifold_entity = make_contact_manifold(m_registry,
-                                                         manifold.body[0], manifold.body[1],
-                                                         separation_threshold);
-            m_registry.get<contact_manifold>(manifold_entity) = manifold;
+            manifold_entity = make_contact_manifold(m_registry,
+                                                    manifold.body[0], manifold.body[1],
+                                                    separation_threshold);
         }
+
+        m_registry.get<contact_manifold>(manifold_entity) = manifold;
     }
 }
 
@@ -897,7 +995,7 @@ void island_worker::on_extrapolation_result(const extrapolation_result &result)
     // Assign current transforms to previous before importing pools into registry.
     assign_previous_transforms(m_registry);
 
-    result.ops.execute(m_registry, m_entity_map);
+    result.ops.execute(m_registry, m_entity_map, false, true);
 
     accumulate_discontinuities(m_registry);
     import_contact_manifolds(result.manifolds);
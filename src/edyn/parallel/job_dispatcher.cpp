@@ -2,6 +2,7 @@
 #include "edyn/parallel/job_queue.hpp"
 #include "edyn/parallel/job_queue_scheduler.hpp"
 #include "edyn/parallel/worker.hpp"
+#include "edyn/parallel/thread_affinity.hpp"
 #include "edyn/config/config.h"
 #include <cstdint>
 
@@ -32,16 +33,23 @@ void job_dispatcher::start() {
     start(num_threads);
 }
 
-void job_dispatcher::start(size_t num_worker_threads) {
+void job_dispatcher::start(size_t num_worker_threads, bool pin_to_cores) {
     EDYN_ASSERT(m_workers.empty());
 
+    // Create all workers before starting threads since they steal from
+    // each other.
     for (size_t i = 0; i < num_worker_threads; ++i) {
-        auto w = std::make_unique<worker>();
-        auto t = std::make_unique<std::thread>(&worker::run, w.get());
-        auto id = t->get_id();
+        m_workers.push_back(std::make_unique<worker>(*this, i));
+    }
+
+    m_running.store(true, std::memory_order_relaxed);
+
+    for (auto &w : m_workers) {
+        m_threads.push_back(std::make_unique<std::thread>(&worker::run, w.get()));
 
-        m_threads.push_back(std::move(t));
-        m_workers[id] = std::move(w);
+        if (pin_to_cores) {
+            set_thread_affinity(*m_threads.back(), w->index());
+        }
     }
 
     m_scheduler.start();
@@ -50,10 +58,13 @@ void job_dispatcher::start(size_t num_worker_threads) {
 void job_dispatcher::stop() {
     m_scheduler.stop();
 
-    for (auto &pair : m_workers) {
-        pair.second->stop();
+    {
+        auto lock = std::lock_guard(m_park_mutex);
+        m_running.store(false, std::memory_order_relaxed);
     }
 
+    m_park_cv.notify_all();
+
     for (auto &t : m_threads) {
         t->join();
     }
@@ -66,43 +77,109 @@ bool job_dispatcher::running() const {
     return !m_threads.empty();
 }
 
-void job_dispatcher::async(const job &j) {
+void job_dispatcher::push_job(const job &j, size_t worker_index, uint32_t priority) {
     EDYN_ASSERT(!m_workers.empty());
+    auto current_index = current_worker_index();
+
+    // Keep it in the preferred worker unless it's overloaded, in which case
+    // it goes wherever it would go without a preference.
+    if (worker_index < m_workers.size() && worker_index != current_index &&
+        m_workers[worker_index]->num_pending_jobs() < max_affine_pending_jobs) {
+        m_workers[worker_index]->push_external(j, priority);
+    } else if (current_index != invalid_worker_index) {
+        // The local deque is LIFO. Prioritized jobs must be ordered in the
+        // inbox.
+        if (priority > 0) {
+            m_workers[current_index]->push_external(j, priority);
+        } else {
+            m_workers[current_index]->push_local(j);
+        }
+    } else {
+        auto index = m_start.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+        m_workers[index]->push_external(j, priority);
+    }
+}
+
+void job_dispatcher::async(const job &j) {
+    push_job(j, invalid_worker_index, 0);
+    notify_job_available();
+}
+
+void job_dispatcher::async(const job *jobs, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        push_job(jobs[i], invalid_worker_index, 0);
+    }
+
+    notify_job_available(count);
+}
+
+void job_dispatcher::async_with_affinity(const job &j, size_t worker_index, uint32_t priority) {
+    push_job(j, worker_index, priority);
+    notify_job_available();
+}
 
-    if (m_workers.size() == 1) {
-        m_workers.begin()->second->push_job(j);
+void job_dispatcher::async_with_affinity(const job *jobs, const size_t *worker_indices,
+                                         const uint32_t *priorities, size_t count) {
+    if (count == 0) {
         return;
     }
 
-    auto best_id = std::thread::id();
-    auto min_num_jobs = SIZE_MAX;
-    auto start = m_start.fetch_add(std::memory_order_relaxed) % m_workers.size();
-    auto end = start + m_workers.size();
-
-    for (size_t i = start; i < end; ++i) {
-        auto k = i % m_workers.size();
-        auto first = m_workers.begin();
-        std::advance(first, k);
-        auto &pair = *first;
-
-        auto s = pair.second->size();
-        if (s == 0) {
-            pair.second->push_job(j);
-            return;
+    for (size_t i = 0; i < count; ++i) {
+        push_job(jobs[i], worker_indices[i], priorities[i]);
+    }
+
+    notify_job_available(count);
+}
+
+void job_dispatcher::notify_job_available(size_t num_jobs) {
+    m_epoch.fetch_add(1, std::memory_order_seq_cst);
+
+    if (m_num_parked.load(std::memory_order_seq_cst) > 0) {
+        // Lock to prevent the notification from happening after a worker
+        // checks the epoch but before it starts waiting.
+        {
+            auto lock = std::lock_guard(m_park_mutex);
         }
-        if (s < min_num_jobs) {
-            min_num_jobs = s;
-            best_id = pair.first;
+
+        if (num_jobs > 1) {
+            m_park_cv.notify_all();
+        } else {
+            m_park_cv.notify_one();
         }
     }
+}
+
+void job_dispatcher::park() {
+    m_num_parked.fetch_add(1, std::memory_order_seq_cst);
+    auto epoch = m_epoch.load(std::memory_order_seq_cst);
+
+    // Check for jobs scheduled before the epoch was read.
+    auto has_jobs = false;
 
-    EDYN_ASSERT(m_workers.count(best_id));
+    for (auto &w : m_workers) {
+        if (w->has_jobs()) {
+            has_jobs = true;
+            break;
+        }
+    }
 
-    m_workers[best_id]->push_job(j);
+    if (!has_jobs) {
+        auto lock = std::unique_lock(m_park_mutex);
+        m_park_cv.wait(lock, [&] {
+            return m_epoch.load(std::memory_order_seq_cst) != epoch ||
+                   !m_running.load(std::memory_order_relaxed);
+        });
+    }
+
+    m_num_parked.fetch_sub(1, std::memory_order_seq_cst);
 }
 
-void job_dispatcher::async_after(double delta_time, const job &j) {
-    m_scheduler.schedule_after(j, delta_time);
+void job_dispatcher::async_after(double delta_time, const job &j, size_t worker_index, uint32_t priority) {
+    m_scheduler.schedule_after(j, delta_time, worker_index, priority);
 }
 
 void job_dispatcher::async(std::thread::id id, const job &j) {
@@ -129,7 +206,7 @@ job_queue_scheduler job_dispatcher::get_current_scheduler() {
 void job_dispatcher::assure_current_queue() {
     auto id = std::this_thread::get_id();
     // Must not be called from a worker thread.
-    EDYN_ASSERT(!m_workers.count(id));
+    EDYN_ASSERT(worker::current() == nullptr);
 
     auto lock = std::lock_guard(m_queues_mutex);
     if (!m_queues_map.count(id)) {
@@ -157,4 +234,23 @@ size_t job_dispatcher::num_workers() const {
     return m_workers.size();
 }
 
+bool job_dispatcher::is_current_thread_worker() const {
+    auto *current = worker::current();
+    return current != nullptr && &current->get_dispatcher() == this;
+}
+
+size_t job_dispatcher::current_worker_index() const {
+    return is_current_thread_worker() ? worker::current()->index() : invalid_worker_index;
+}
+
+int64_t job_dispatcher::local_job_mark() const {
+    EDYN_ASSERT(is_current_thread_worker());
+    return worker::current()->local_job_mark();
+}
+
+bool job_dispatcher::run_local_job_after(int64_t mark) {
+    EDYN_ASSERT(is_current_thread_worker());
+    return worker::current()->run_local_job_after(mark);
+}
+
 }
@@ -28,25 +28,24 @@ void job_scheduler::stop() {
     m_thread.reset();
 }
 
-void job_scheduler::schedule_after(const job &j, double delta_time) {
+void job_scheduler::schedule_after(const job &j, double delta_time, size_t worker_index, uint32_t priority) {
     EDYN_ASSERT(delta_time > 0);
 
     auto lock = std::unique_lock(m_mutex);
     auto current_time = performance_time();
     auto job_timestamp = current_time + delta_time;
 
-    auto found_it = std::find_if(m_jobs.begin(), m_jobs.end(), [job_timestamp] (const timed_job &j) {
-        return j.m_timestamp > job_timestamp;
-    });
+    auto sequence = m_sequence++;
+    m_jobs.push_back(timed_job{j, job_timestamp, sequence, worker_index, priority});
+    std::push_heap(m_jobs.begin(), m_jobs.end(), timed_job_later{});
 
-    auto did_replace_first = found_it == m_jobs.begin();
-    m_jobs.insert(found_it, timed_job{j, job_timestamp});
+    auto did_replace_first = m_jobs.front().m_sequence == sequence;
     lock.unlock();
 
     if (did_replace_first) {
-        // If this new job is going to be inserted at the beginning, it is
-        // necessary to wake up the timer thread so the condition variable
-        // can be readjusted to unblock at the earliest time again.
+        // If this new job is going to be the next to run, it is necessary
+        // to wake up the timer thread so the condition variable can be
+        // readjusted to unblock at the earliest time again.
         m_cv.notify_one();
     }
 }
@@ -71,17 +70,41 @@ void job_scheduler::update() {
 
         auto current_time = performance_time();
 
-        // Dispatch all jobs with a timestamp before the current time.
-        auto it = m_jobs.begin();
-        for (; it != m_jobs.end(); ++it) {
-            if (it->m_timestamp > current_time) {
-                break;
-            }
-            m_dispatcher->async(it->m_job);
+        // Collect all jobs with a timestamp before the current time.
+        while (!m_jobs.empty() && m_jobs.front().m_timestamp <= current_time) {
+            std::pop_heap(m_jobs.begin(), m_jobs.end(), timed_job_later{});
+            m_expired.push_back(m_jobs.back());
+            m_jobs.pop_back();
+        }
+
+        lock.unlock();
+
+        if (m_expired.empty()) {
+            continue;
+        }
+
+        // Dispatch higher priority jobs first so they're at the front of
+        // the worker queues.
+        std::stable_sort(m_expired.begin(), m_expired.end(), [] (const timed_job &lhs, const timed_job &rhs) {
+            return lhs.m_priority > rhs.m_priority;
+        });
+
+        for (auto &expired : m_expired) {
+            m_expired_jobs.push_back(expired.m_job);
+            m_expired_worker_indices.push_back(expired.m_worker_index);
+            m_expired_priorities.push_back(expired.m_priority);
         }
 
-        // Erase all jobs that were dispatched.
-        m_jobs.erase(m_jobs.begin(), it);
+        // Dispatch them all at once outside of the lock so new jobs can be
+        // scheduled in the meantime.
+        m_dispatcher->async_with_affinity(m_expired_jobs.data(),
+                                          m_expired_worker_indices.data(),
+                                          m_expired_priorities.data(),
+                                          m_expired_jobs.size());
+        m_expired.clear();
+        m_expired_jobs.clear();
+        m_expired_worker_indices.clear();
+        m_expired_priorities.clear();
     }
 }
 
@@ -0,0 +1,31 @@
+#include "edyn/parallel/thread_affinity.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace edyn {
+
+bool set_thread_affinity(std::thread &thread, size_t core_index) {
+#if defined(__linux__)
+    auto num_cores = std::thread::hardware_concurrency();
+
+    if (num_cores == 0) {
+        return false;
+    }
+
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core_index % num_cores, &cpuset);
+
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset) == 0;
+#else
+    // Thread affinity is not available on this platform.
+    static_cast<void>(thread);
+    static_cast<void>(core_index);
+    return false;
+#endif
+}
+
+}
@@ -0,0 +1,20 @@
+#include "edyn/parallel/thread_affinity.hpp"
+#include <windows.h>
+
+namespace edyn {
+
+bool set_thread_affinity(std::thread &thread, size_t core_index) {
+    auto num_cores = std::thread::hardware_concurrency();
+
+    if (num_cores == 0) {
+        return false;
+    }
+
+    // Affinity masks only address the cores in the current processor group.
+    auto max_cores = sizeof(DWORD_PTR) * 8;
+    auto mask = DWORD_PTR(1) << ((core_index % num_cores) % max_cores);
+
+    return SetThreadAffinityMask(thread.native_handle(), mask) != 0;
+}
+
+}
@@ -0,0 +1,108 @@
+#include "edyn/parallel/work_stealing_deque.hpp"
+#include "edyn/config/config.h"
+
+namespace edyn {
+
+// Implementation based on "Correct and Efficient Work-Stealing for Weak Memory
+// Models" by Lê, Pop, Cohen and Zappa Nardelli.
+
+work_stealing_deque::work_stealing_deque(size_t initial_capacity) {
+    // Capacity must be a power of two.
+    EDYN_ASSERT(initial_capacity > 0 && (initial_capacity & (initial_capacity - 1)) == 0);
+    m_buffers.push_back(std::make_unique<buffer>(initial_capacity));
+    m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+}
+
+work_stealing_deque::buffer *work_stealing_deque::grow(buffer *buf, int64_t top, int64_t bottom) {
+    auto new_buf = std::make_unique<buffer>(buf->capacity() * 2);
+
+    for (auto i = top; i < bottom; ++i) {
+        (*new_buf)[i] = (*buf)[i];
+    }
+
+    auto *ptr = new_buf.get();
+    m_buffers.push_back(std::move(new_buf));
+    m_buffer.store(ptr, std::memory_order_release);
+
+    return ptr;
+}
+
+void work_stealing_deque::push(const job &j) {
+    auto bottom = m_bottom.load(std::memory_order_relaxed);
+    auto top = m_top.load(std::memory_order_acquire);
+    auto *buf = m_buffer.load(std::memory_order_relaxed);
+
+    if (bottom - top > buf->capacity() - 1) {
+        buf = grow(buf, top, bottom);
+    }
+
+    (*buf)[bottom] = j;
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+}
+
+bool work_stealing_deque::pop(job &j) {
+    auto bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    auto *buf = m_buffer.load(std::memory_order_relaxed);
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = m_top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        // Empty.
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    j = (*buf)[bottom];
+
+    if (top == bottom) {
+        // Last job. Race against thieves.
+        auto success = m_top.compare_exchange_strong(top, top + 1,
+                                                     std::memory_order_seq_cst,
+                                                     std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return success;
+    }
+
+    return true;
+}
+
+bool work_stealing_deque::pop_after(int64_t position, job &j) {
+    // Only the owner changes the bottom, thus it can be checked beforehand.
+    if (m_bottom.load(std::memory_order_relaxed) <= position) {
+        return false;
+    }
+
+    return pop(j);
+}
+
+bool work_stealing_deque::steal(job &j) {
+    auto top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto bottom = m_bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom) {
+        return false;
+    }
+
+    auto *buf = m_buffer.load(std::memory_order_acquire);
+    auto stolen = (*buf)[top];
+
+    if (!m_top.compare_exchange_strong(top, top + 1,
+                                       std::memory_order_seq_cst,
+                                       std::memory_order_relaxed)) {
+        return false;
+    }
+
+    j = stolen;
+    return true;
+}
+
+size_t work_stealing_deque::size() const {
+    auto bottom = m_bottom.load(std::memory_order_relaxed);
+    auto top = m_top.load(std::memory_order_relaxed);
+    return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+}
+
+}
@@ -0,0 +1,143 @@
+#include "edyn/parallel/worker.hpp"
+#include "edyn/parallel/job_dispatcher.hpp"
+#include "edyn/config/config.h"
+#include <thread>
+#include <algorithm>
+
+namespace edyn {
+
+// Number of times an idle worker tries to find a job before going to sleep.
+constexpr size_t worker_num_idle_spins = 64;
+
+static thread_local worker *current_worker = nullptr;
+
+worker::worker(job_dispatcher &dispatcher, size_t index)
+    : m_dispatcher(&dispatcher)
+    , m_index(index)
+    , m_random_state(static_cast<uint32_t>(index) * 2654435761u + 1)
+{}
+
+worker *worker::current() {
+    return current_worker;
+}
+
+void worker::push_local(const job &j) {
+    EDYN_ASSERT(current_worker == this);
+    m_deque.push(j);
+}
+
+void worker::push_external(const job &j, uint32_t priority) {
+    auto lock = std::lock_guard(m_inbox_mutex);
+    m_inbox.push_back(inbox_job{j, priority, m_inbox_sequence++});
+    std::push_heap(m_inbox.begin(), m_inbox.end(), inbox_job_after{});
+    // Increment under the lock, otherwise a concurrent pop could decrement
+    // it first, making it wrap around.
+    m_inbox_size.fetch_add(1, std::memory_order_seq_cst);
+}
+
+bool worker::try_pop_inbox(job &j) {
+    if (m_inbox_size.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+
+    auto lock = std::lock_guard(m_inbox_mutex);
+
+    if (m_inbox.empty()) {
+        return false;
+    }
+
+    // Take the job with highest priority, or the oldest if equal.
+    std::pop_heap(m_inbox.begin(), m_inbox.end(), inbox_job_after{});
+    j = m_inbox.back().m_job;
+    m_inbox.pop_back();
+    m_inbox_size.fetch_sub(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+bool worker::try_pop(job &j) {
+    return m_deque.pop(j) || try_pop_inbox(j);
+}
+
+bool worker::try_steal(job &j) {
+    return m_deque.steal(j) || try_pop_inbox(j);
+}
+
+bool worker::has_jobs() const {
+    return !m_deque.empty() || m_inbox_size.load(std::memory_order_seq_cst) > 0;
+}
+
+size_t worker::num_pending_jobs() const {
+    return m_deque.size() + m_inbox_size.load(std::memory_order_relaxed);
+}
+
+bool worker::try_steal_from_others(job &j) {
+    auto num_workers = m_dispatcher->num_workers();
+
+    if (num_workers < 2) {
+        return false;
+    }
+
+    // Xorshift.
+    m_random_state ^= m_random_state << 13;
+    m_random_state ^= m_random_state >> 17;
+    m_random_state ^= m_random_state << 5;
+
+    // Visit all other workers starting at a random one.
+    auto start = m_random_state % num_workers;
+
+    for (size_t i = 0; i < num_workers; ++i) {
+        auto victim_index = (start + i) % num_workers;
+
+        if (victim_index != m_index && m_dispatcher->get_worker(victim_index).try_steal(j)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool worker::run_local_job_after(int64_t mark) {
+    EDYN_ASSERT(current_worker == this);
+    job j;
+
+    if (m_deque.pop_after(mark, j)) {
+        j();
+        return true;
+    }
+
+    return false;
+}
+
+void worker::run() {
+    current_worker = this;
+    size_t num_idle_spins = 0;
+    job j;
+
+    while (m_dispatcher->is_running()) {
+        if (try_pop(j) || try_steal_from_others(j)) {
+            j();
+            num_idle_spins = 0;
+            continue;
+        }
+
+        if (++num_idle_spins < worker_num_idle_spins) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        m_dispatcher->park();
+        num_idle_spins = 0;
+    }
+
+    // Run jobs which were still pending when the dispatcher was stopped,
+    // including the ones they schedule, until all workers are out of jobs.
+    // Island workers, for instance, are deleted by their last job.
+    while (try_pop(j) || try_steal_from_others(j)) {
+        j();
+    }
+
+    current_worker = nullptr;
+}
+
+}
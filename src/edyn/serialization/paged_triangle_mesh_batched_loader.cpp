@@ -0,0 +1,310 @@
+#include "edyn/serialization/paged_triangle_mesh_batched_loader.hpp"
+#include "edyn/serialization/paged_triangle_mesh_s11n.hpp"
+#include "edyn/serialization/triangle_mesh_s11n.hpp"
+#include "edyn/serialization/memory_archive.hpp"
+#include "edyn/parallel/job_dispatcher.hpp"
+#include "edyn/shapes/triangle_mesh.hpp"
+#include "edyn/time/time.hpp"
+#include <memory>
+#include <algorithm>
+#include <iterator>
+
+namespace edyn {
+
+uint64_t page_load_latency_histogram::total_count() const {
+    uint64_t total = 0;
+
+    for (auto count : counts) {
+        total += count;
+    }
+
+    return total;
+}
+
+uint64_t page_load_latency_histogram::percentile_us(double fraction) const {
+    auto total = total_count();
+
+    if (total == 0) {
+        return 0;
+    }
+
+    auto target = static_cast<uint64_t>(fraction * static_cast<double>(total));
+    uint64_t accumulated = 0;
+
+    for (size_t i = 0; i < num_buckets; ++i) {
+        accumulated += counts[i];
+
+        if (accumulated >= target && accumulated > 0) {
+            return uint64_t(1) << i;
+        }
+    }
+
+    return uint64_t(1) << (num_buckets - 1);
+}
+
+paged_triangle_mesh_batched_loader::paged_triangle_mesh_batched_loader(size_t max_in_flight,
+                                                                       size_t max_read_size)
+    : m_max_in_flight(max_in_flight)
+    , m_max_read_size(max_read_size)
+{
+    EDYN_ASSERT(max_in_flight > 0);
+}
+
+paged_triangle_mesh_batched_loader::~paged_triangle_mesh_batched_loader() {
+    close();
+}
+
+bool paged_triangle_mesh_batched_loader::open(const std::string &path) {
+    close();
+
+    if (!m_file.open(path)) {
+        return false;
+    }
+
+    m_path = path;
+    m_running = true;
+    m_thread = std::thread(&paged_triangle_mesh_batched_loader::run, this);
+
+    return true;
+}
+
+void paged_triangle_mesh_batched_loader::close() {
+    {
+        auto lock = std::unique_lock(m_mutex);
+        m_running = false;
+        m_queue.clear();
+    }
+
+    m_cv.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    // Wait for deserialization jobs which reference this loader.
+    {
+        auto lock = std::unique_lock(m_mutex);
+        m_cv.wait(lock, [&] { return m_num_in_flight == 0; });
+    }
+
+    m_file.close();
+}
+
+void paged_triangle_mesh_batched_loader::load(size_t index) {
+    EDYN_ASSERT(is_open() && index < m_offsets.size());
+
+    {
+        auto lock = std::lock_guard(m_mutex);
+        m_queue.push_back({index, performance_counter()});
+    }
+
+    m_cv.notify_all();
+}
+
+void paged_triangle_mesh_batched_loader::load(const std::vector<size_t> &indices) {
+    EDYN_ASSERT(is_open());
+    auto time = performance_counter();
+
+    {
+        auto lock = std::lock_guard(m_mutex);
+
+        for (auto index : indices) {
+            EDYN_ASSERT(index < m_offsets.size());
+            m_queue.push_back({index, time});
+        }
+    }
+
+    m_cv.notify_all();
+}
+
+size_t paged_triangle_mesh_batched_loader::submesh_offset(size_t index) const {
+    return m_base_offset + m_offsets[index];
+}
+
+size_t paged_triangle_mesh_batched_loader::submesh_size(size_t index) const {
+    // Submeshes are written in sequence thus the size is the distance to the
+    // next one.
+    auto end = index + 1 < m_offsets.size() ? submesh_offset(index + 1) : m_file.size();
+    return end - submesh_offset(index);
+}
+
+void paged_triangle_mesh_batched_loader::run() {
+    std::vector<request> requests;
+
+    while (true) {
+        {
+            auto lock = std::unique_lock(m_mutex);
+            m_cv.wait(lock, [&] {
+                return !m_running || (!m_queue.empty() && m_num_in_flight < m_max_in_flight);
+            });
+
+            if (!m_running) {
+                break;
+            }
+
+            // Take as many requests as allowed, oldest first.
+            auto count = std::min(m_queue.size(), m_max_in_flight - m_num_in_flight);
+            requests.assign(m_queue.begin(), m_queue.begin() + count);
+            m_queue.erase(m_queue.begin(), m_queue.begin() + count);
+            m_num_in_flight += count;
+        }
+
+        read(requests);
+        requests.clear();
+    }
+}
+
+void batched_loader_deserialize_job_func(job::data_type &data) {
+    intptr_t loader_ptr, batch_ptr;
+    auto archive = memory_input_archive(data.data(), data.size());
+    archive(loader_ptr);
+    archive(batch_ptr);
+
+    auto *loader = reinterpret_cast<paged_triangle_mesh_batched_loader *>(loader_ptr);
+    auto batch = std::unique_ptr<paged_triangle_mesh_batched_loader::read_batch>(
+        reinterpret_cast<paged_triangle_mesh_batched_loader::read_batch *>(batch_ptr));
+
+    for (size_t i = 0; i < batch->requests.size(); ++i) {
+        auto &req = batch->requests[i];
+        auto begin = batch->buffer_offsets[i];
+        auto end = i + 1 < batch->requests.size() ? batch->buffer_offsets[i + 1] : batch->buffer.size();
+        auto mesh_archive = memory_input_archive(batch->buffer.data() + begin, end - begin);
+        auto mesh = std::make_shared<triangle_mesh>();
+        serialize(mesh_archive, *mesh);
+        EDYN_ASSERT(!mesh_archive.failed());
+
+        loader->m_loaded_signal.publish(req.index, mesh);
+        loader->record_load(req);
+    }
+
+    // The loader could be destroyed right after the last request is finished.
+    auto num_requests = batch->requests.size();
+    batch.reset();
+    loader->finish_requests(num_requests);
+}
+
+void paged_triangle_mesh_batched_loader::read(std::vector<request> &requests) {
+    std::sort(requests.begin(), requests.end(), [&] (auto &a, auto &b) {
+        return m_offsets[a.index] < m_offsets[b.index];
+    });
+
+    // Remove duplicates which might happen if the cache was cleared while
+    // the submesh was still being loaded.
+    auto last = std::unique(requests.begin(), requests.end(), [] (auto &a, auto &b) {
+        return a.index == b.index;
+    });
+
+    // Duplicates are not loaded, thus they only leave the in-flight count.
+    auto num_duplicates = static_cast<size_t>(std::distance(last, requests.end()));
+    requests.erase(last, requests.end());
+
+    if (num_duplicates > 0) {
+        finish_requests(num_duplicates);
+    }
+
+    size_t begin = 0;
+
+    while (begin < requests.size()) {
+        // Extend range while the next submesh is right after the current one
+        // in the file and the read stays under the size limit.
+        auto start_offset = submesh_offset(requests[begin].index);
+        auto end_offset = start_offset + submesh_size(requests[begin].index);
+        auto end = begin + 1;
+
+        while (end < requests.size()) {
+            auto next_offset = submesh_offset(requests[end].index);
+            auto next_end_offset = next_offset + submesh_size(requests[end].index);
+
+            if (next_offset != end_offset || next_end_offset - start_offset > m_max_read_size) {
+                break;
+            }
+
+            end_offset = next_end_offset;
+            ++end;
+        }
+
+        auto batch = std::make_unique<read_batch>();
+        batch->buffer.resize(end_offset - start_offset);
+        batch->requests.assign(requests.begin() + begin, requests.begin() + end);
+
+        for (auto i = begin; i < end; ++i) {
+            batch->buffer_offsets.push_back(submesh_offset(requests[i].index) - start_offset);
+        }
+
+        m_num_reads.fetch_add(1, std::memory_order_relaxed);
+
+        if (m_file.read(batch->buffer.data(), batch->buffer.size(), start_offset)) {
+            auto j = job();
+            j.func = &batched_loader_deserialize_job_func;
+            auto archive = fixed_memory_output_archive(j.data.data(), j.data.size());
+            auto loader_ptr = reinterpret_cast<intptr_t>(this);
+            auto batch_ptr = reinterpret_cast<intptr_t>(batch.release());
+            archive(loader_ptr);
+            archive(batch_ptr);
+            job_dispatcher::global().async(j);
+        } else {
+            EDYN_ASSERT(false);
+            finish_requests(batch->requests.size());
+        }
+
+        begin = end;
+    }
+}
+
+void paged_triangle_mesh_batched_loader::record_load(const request &req) {
+    auto elapsed = performance_counter() - req.time;
+    auto us = elapsed * 1000000 / performance_frequency();
+    size_t bucket = 0;
+
+    while (bucket + 1 < page_load_latency_histogram::num_buckets && (uint64_t(1) << bucket) <= us) {
+        ++bucket;
+    }
+
+    m_latency_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_num_loaded.fetch_add(1, std::memory_order_relaxed);
+}
+
+void paged_triangle_mesh_batched_loader::finish_requests(size_t count) {
+    // Notify while holding the lock, otherwise `close` could observe no
+    // requests in flight and the loader could be destroyed before the
+    // condition variable is notified.
+    auto lock = std::lock_guard(m_mutex);
+    EDYN_ASSERT(m_num_in_flight >= count);
+    m_num_in_flight -= count;
+    m_cv.notify_all();
+}
+
+page_load_latency_histogram paged_triangle_mesh_batched_loader::get_latency_histogram() const {
+    auto histogram = page_load_latency_histogram{};
+
+    for (size_t i = 0; i < histogram.num_buckets; ++i) {
+        histogram.counts[i] = m_latency_counts[i].load(std::memory_order_relaxed);
+    }
+
+    return histogram;
+}
+
+void paged_triangle_mesh_batched_loader::reset_stats() {
+    for (auto &count : m_latency_counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+
+    m_num_reads.store(0, std::memory_order_relaxed);
+    m_num_loaded.store(0, std::memory_order_relaxed);
+}
+
+void serialize(paged_triangle_mesh_batched_loader &loader,
+               paged_triangle_mesh &paged_tri_mesh) {
+    EDYN_ASSERT(loader.is_open());
+
+    // Read the tree and the submesh offsets with the regular archive.
+    auto archive = paged_triangle_mesh_file_input_archive(loader.m_path);
+    serialize(archive, paged_tri_mesh);
+    EDYN_ASSERT(archive.m_mode == paged_triangle_mesh_serialization_mode::embedded);
+
+    auto lock = std::lock_guard(loader.m_mutex);
+    loader.m_base_offset = archive.m_base_offset;
+    loader.m_offsets = archive.m_offsets;
+}
+
+}
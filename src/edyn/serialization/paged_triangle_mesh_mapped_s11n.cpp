@@ -0,0 +1,183 @@
+#include "edyn/serialization/paged_triangle_mesh_mapped_s11n.hpp"
+#include "edyn/serialization/mapped_archive.hpp"
+#include "edyn/serialization/triangle_mesh_s11n.hpp"
+#include "edyn/serialization/static_tree_s11n.hpp"
+#include "edyn/serialization/mappable_vector_s11n.hpp"
+#include "edyn/shapes/triangle_mesh.hpp"
+#include <array>
+#include <memory>
+#include <fstream>
+
+namespace edyn {
+
+namespace {
+    constexpr std::array<char, 8> mapped_file_magic = {'E', 'D', 'Y', 'N', 'P', 'T', 'M', 'M'};
+    constexpr uint32_t mapped_file_byte_order = 0x01020304;
+
+    struct mapped_file_header {
+        std::array<char, 8> magic;
+        uint32_t version;
+        uint32_t scalar_size;
+        uint32_t byte_order;
+        uint64_t num_submeshes;
+        uint64_t tree_offset;
+        uint64_t submesh_table_offset;
+    };
+
+    template<typename Archive>
+    void serialize(Archive &archive, mapped_file_header &header) {
+        for (auto &c : header.magic) {
+            archive(c);
+        }
+
+        archive(header.version);
+        archive(header.scalar_size);
+        archive(header.byte_order);
+        archive(header.num_submeshes);
+        archive(header.tree_offset);
+        archive(header.submesh_table_offset);
+    }
+}
+
+bool write_paged_triangle_mesh_mapped(const std::string &path,
+                                      paged_triangle_mesh &paged_tri_mesh) {
+    auto file = std::ofstream(path, std::ios::binary | std::ios::out);
+
+    if (!file.good()) {
+        return false;
+    }
+
+    auto num_submeshes = paged_tri_mesh.m_cache.size();
+    auto header = mapped_file_header{};
+    header.magic = mapped_file_magic;
+    header.version = paged_triangle_mesh_mapped_version;
+    header.scalar_size = sizeof(scalar);
+    header.byte_order = mapped_file_byte_order;
+    header.num_submeshes = num_submeshes;
+
+    // Write header with placeholder offsets which are overwritten at the end.
+    auto archive = mapped_output_archive(file);
+    archive(header);
+
+    archive.align(mapped_archive_alignment);
+    header.tree_offset = archive.position();
+    archive(paged_tri_mesh.m_tree);
+
+    auto table = std::vector<paged_triangle_mesh_mapped_loader::submesh_entry>(num_submeshes);
+
+    for (size_t i = 0; i < num_submeshes; ++i) {
+        auto &node = paged_tri_mesh.m_cache[i];
+        EDYN_ASSERT(node.trimesh);
+
+        archive.align(paged_triangle_mesh_mapped_submesh_alignment);
+        auto &entry = table[i];
+        entry.num_vertices = node.num_vertices;
+        entry.num_indices = node.num_indices;
+        entry.offset = archive.position();
+        archive(*node.trimesh);
+        entry.size = archive.position() - entry.offset;
+    }
+
+    archive.align(mapped_archive_alignment);
+    header.submesh_table_offset = archive.position();
+    archive(table);
+
+    file.seekp(0);
+    auto header_archive = mapped_output_archive(file);
+    header_archive(header);
+
+    return file.good();
+}
+
+bool paged_triangle_mesh_mapped_loader::open(const std::string &path) {
+    close();
+
+    // Do not reuse the previous mapping, which might still be referenced by
+    // loaded submeshes.
+    m_file = std::make_shared<mapped_file>();
+
+    if (!m_file->open(path)) {
+        close();
+        return false;
+    }
+
+    auto archive = mapped_input_archive(m_file->data(), m_file->size());
+    auto header = mapped_file_header{};
+    archive(header);
+
+    if (archive.failed() ||
+        header.magic != mapped_file_magic ||
+        header.version != paged_triangle_mesh_mapped_version ||
+        header.scalar_size != sizeof(scalar) ||
+        header.byte_order != mapped_file_byte_order ||
+        header.submesh_table_offset >= m_file->size()) {
+        close();
+        return false;
+    }
+
+    auto table_archive = mapped_input_archive(m_file->data() + header.submesh_table_offset,
+                                              m_file->size() - header.submesh_table_offset);
+    table_archive(m_submeshes);
+
+    if (table_archive.failed() || m_submeshes.size() != header.num_submeshes) {
+        close();
+        return false;
+    }
+
+    for (auto &entry : m_submeshes) {
+        if (entry.offset % paged_triangle_mesh_mapped_submesh_alignment != 0 ||
+            entry.offset > m_file->size() || entry.size > m_file->size() - entry.offset) {
+            close();
+            return false;
+        }
+    }
+
+    m_tree_offset = header.tree_offset;
+
+    return true;
+}
+
+void paged_triangle_mesh_mapped_loader::close() {
+    // The file is unmapped once no submesh references it anymore.
+    m_file.reset();
+    m_submeshes.clear();
+}
+
+void paged_triangle_mesh_mapped_loader::load(size_t index) {
+    EDYN_ASSERT(is_open() && index < m_submeshes.size());
+    auto &entry = m_submeshes[index];
+    // The arrays of the mesh are mapped onto the file, not copied.
+    auto archive = mapped_input_archive(m_file->data() + entry.offset, entry.size);
+    auto mesh = std::make_shared<triangle_mesh>();
+    archive(*mesh);
+    EDYN_ASSERT(!archive.failed());
+    mesh->m_mapped_storage = m_file;
+
+    m_loaded_signal.publish(index, mesh);
+}
+
+void serialize(paged_triangle_mesh_mapped_loader &loader,
+               paged_triangle_mesh &paged_tri_mesh) {
+    EDYN_ASSERT(loader.is_open());
+    EDYN_ASSERT(paged_tri_mesh.m_tree.empty() && paged_tri_mesh.m_cache.empty());
+
+    auto &file = *loader.m_file;
+    // The tree is copied since the paged triangle mesh can outlive the file.
+    auto archive = mapped_input_archive(file.data() + loader.m_tree_offset,
+                                        file.size() - loader.m_tree_offset, false);
+    archive(paged_tri_mesh.m_tree);
+    EDYN_ASSERT(!archive.failed());
+
+    paged_tri_mesh.m_cache.resize(loader.m_submeshes.size());
+
+    for (size_t i = 0; i < loader.m_submeshes.size(); ++i) {
+        auto &entry = paged_tri_mesh.m_cache[i];
+        entry.num_vertices = loader.m_submeshes[i].num_vertices;
+        entry.num_indices = loader.m_submeshes[i].num_indices;
+    }
+
+    // Setup LRU list and per-submesh state. No submesh is loaded yet.
+    paged_tri_mesh.init_cache();
+}
+
+}
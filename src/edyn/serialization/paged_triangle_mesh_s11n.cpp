@@ -69,6 +69,61 @@ void serialize(paged_triangle_mesh_file_output_archive &archive,
     }
 }
 
+void begin_streamed_serialize(paged_triangle_mesh_file_output_archive &archive,
+                              paged_triangle_mesh &paged_tri_mesh) {
+    archive.m_triangle_mesh_index = 0;
+    archive(paged_tri_mesh.m_tree);
+    archive.m_submesh_info_position = archive.tell_position();
+
+    // Write placeholders with the same size as the final values.
+    auto num_submeshes = paged_tri_mesh.m_cache.size();
+    archive(num_submeshes);
+    size_t placeholder = 0;
+
+    for (size_t i = 0; i < num_submeshes; ++i) {
+        archive(placeholder);
+        archive(placeholder);
+    }
+
+    archive(archive.m_mode);
+
+    if (archive.m_mode == paged_triangle_mesh_serialization_mode::embedded) {
+        for (size_t i = 0; i < num_submeshes; ++i) {
+            archive(placeholder);
+        }
+    }
+}
+
+void end_streamed_serialize(paged_triangle_mesh_file_output_archive &archive,
+                            paged_triangle_mesh &paged_tri_mesh,
+                            const std::vector<size_t> &submesh_sizes) {
+    auto num_submeshes = paged_tri_mesh.m_cache.size();
+    EDYN_ASSERT(submesh_sizes.size() == num_submeshes);
+    EDYN_ASSERT(archive.m_triangle_mesh_index == num_submeshes);
+    EDYN_ASSERT(archive.m_submesh_info_position != SIZE_MAX);
+
+    auto end_position = archive.tell_position();
+    archive.seek_position(archive.m_submesh_info_position);
+    archive(num_submeshes);
+
+    for (auto &entry : paged_tri_mesh.m_cache) {
+        archive(entry.num_vertices);
+        archive(entry.num_indices);
+    }
+
+    archive(archive.m_mode);
+
+    if (archive.m_mode == paged_triangle_mesh_serialization_mode::embedded) {
+        size_t tri_mesh_offset = 0;
+        for (size_t i = 0; i < num_submeshes; ++i) {
+            archive(tri_mesh_offset);
+            tri_mesh_offset += submesh_sizes[i];
+        }
+    }
+
+    archive.seek_position(end_position);
+}
+
 void serialize(paged_triangle_mesh_file_input_archive &archive,
                paged_triangle_mesh &paged_tri_mesh) {
     archive(paged_tri_mesh.m_tree);
@@ -95,12 +150,8 @@ void serialize(paged_triangle_mesh_file_input_archive &archive,
         archive.m_base_offset = archive.tell_position();
     }
 
-    // Resize LRU queue to have the number of submeshes.
-    paged_tri_mesh.m_lru_indices.resize(num_submeshes);
-    std::iota(paged_tri_mesh.m_lru_indices.begin(),
-              paged_tri_mesh.m_lru_indices.end(), 0);
-
-    paged_tri_mesh.m_is_loading_submesh = std::make_unique<std::atomic<bool>[]>(num_submeshes);
+    // Setup LRU list and per-submesh state. No submesh is loaded yet.
+    paged_tri_mesh.init_cache();
 }
 
 template<typename Archive>
@@ -0,0 +1,58 @@
+#include "edyn/serialization/random_access_file.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace edyn {
+
+bool random_access_file::open(const std::string &path) {
+    close();
+
+    auto fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat st;
+
+    if (fstat(fd, &st) == -1) {
+        ::close(fd);
+        return false;
+    }
+
+    m_handle = fd;
+    m_size = static_cast<size_t>(st.st_size);
+
+    return true;
+}
+
+void random_access_file::close() {
+    if (is_open()) {
+        ::close(static_cast<int>(m_handle));
+        m_handle = invalid_handle;
+        m_size = 0;
+    }
+}
+
+bool random_access_file::read(void *buffer, size_t size, size_t offset) const {
+    auto *dest = static_cast<char *>(buffer);
+
+    // `pread` may return fewer bytes than requested.
+    while (size > 0) {
+        auto count = pread(static_cast<int>(m_handle), dest, size, static_cast<off_t>(offset));
+
+        if (count <= 0) {
+            return false;
+        }
+
+        dest += count;
+        size -= static_cast<size_t>(count);
+        offset += static_cast<size_t>(count);
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,58 @@
+#include "edyn/serialization/mapped_file.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+namespace edyn {
+
+bool mapped_file::open(const std::string &path) {
+    close();
+
+    auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    // The mapping keeps a reference to the file.
+    CloseHandle(file);
+
+    if (mapping == nullptr) {
+        return false;
+    }
+
+    auto *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (data == nullptr) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t *>(data);
+    m_size = static_cast<size_t>(size.QuadPart);
+    m_handle = mapping;
+
+    return true;
+}
+
+void mapped_file::close() {
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_handle);
+        m_data = nullptr;
+        m_size = 0;
+        m_handle = nullptr;
+    }
+}
+
+}
@@ -0,0 +1,65 @@
+#include "edyn/serialization/random_access_file.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <algorithm>
+
+namespace edyn {
+
+bool random_access_file::open(const std::string &path) {
+    close();
+
+    auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_handle = reinterpret_cast<intptr_t>(file);
+    m_size = static_cast<size_t>(size.QuadPart);
+
+    return true;
+}
+
+void random_access_file::close() {
+    if (is_open()) {
+        CloseHandle(reinterpret_cast<HANDLE>(m_handle));
+        m_handle = invalid_handle;
+        m_size = 0;
+    }
+}
+
+bool random_access_file::read(void *buffer, size_t size, size_t offset) const {
+    auto *dest = static_cast<char *>(buffer);
+
+    while (size > 0) {
+        // The offset in the `OVERLAPPED` structure is used by `ReadFile` on
+        // synchronous handles, without changing a shared file position.
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(offset & 0xffffffff);
+        overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+        auto to_read = static_cast<DWORD>(std::min(size, size_t(1) << 30));
+        DWORD count = 0;
+
+        if (!ReadFile(reinterpret_cast<HANDLE>(m_handle), dest, to_read, &count, &overlapped) || count == 0) {
+            return false;
+        }
+
+        dest += count;
+        size -= count;
+        offset += count;
+    }
+
+    return true;
+}
+
+}
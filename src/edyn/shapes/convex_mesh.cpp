@@ -1,6 +1,7 @@
 #include "edyn/shapes/convex_mesh.hpp"
 #include "edyn/sys/update_rotated_meshes.hpp"
 #include "edyn/util/shape_util.hpp"
+#include "edyn/util/aabb_util.hpp"
 
 namespace edyn {
 
@@ -185,6 +186,7 @@ rotated_mesh make_rotated_mesh(const convex_mesh &mesh, const quaternion &orn) {
     rotated.vertices.resize(mesh.vertices.size());
     rotated.relevant_normals.resize(mesh.relevant_normals.size());
     rotated.relevant_edges.resize(mesh.relevant_edges.size());
+    rotated.local_aabb = point_cloud_aabb(mesh.vertices);
 
     update_rotated_mesh(rotated, mesh, orn);
 
@@ -0,0 +1,199 @@
+#include "edyn/shapes/heightfield.hpp"
+
+namespace edyn {
+
+heightfield::heightfield(size_t num_columns, size_t num_rows, const vector2 &cell_size,
+                         const vector3 &origin, std::vector<scalar> heights)
+    : m_num_columns(num_columns)
+    , m_num_rows(num_rows)
+    , m_cell_size(cell_size)
+    , m_origin(origin)
+    , m_heights(std::move(heights))
+{
+    EDYN_ASSERT(num_columns > 1 && num_rows > 1);
+    EDYN_ASSERT(m_heights.size() == num_columns * num_rows);
+    EDYN_ASSERT(cell_size.x > 0 && cell_size.y > 0);
+
+    m_z_edges_offset = (num_columns - 1) * num_rows;
+    m_diagonal_edges_offset = m_z_edges_offset + num_columns * (num_rows - 1);
+
+    auto [min_height, max_height] = std::minmax_element(m_heights.begin(), m_heights.end());
+    m_aabb.min = origin + vector3{0, *min_height, 0};
+    m_aabb.max = origin + vector3{scalar(num_columns - 1) * cell_size.x,
+                                  *max_height,
+                                  scalar(num_rows - 1) * cell_size.y};
+}
+
+std::array<heightfield::index_type, 3> heightfield::get_triangle_vertex_indices(size_t tri_idx) const {
+    EDYN_ASSERT(tri_idx < num_triangles());
+    auto cell_idx = tri_idx / 2;
+    auto column = cell_idx % (m_num_columns - 1);
+    auto row = cell_idx / (m_num_columns - 1);
+
+    auto v00 = static_cast<index_type>(row * m_num_columns + column);
+    auto v10 = v00 + 1;
+    auto v01 = static_cast<index_type>(v00 + m_num_columns);
+    auto v11 = v01 + 1;
+
+    if (tri_idx % 2 == 0) {
+        return {v00, v01, v11};
+    }
+
+    return {v00, v11, v10};
+}
+
+heightfield::index_type heightfield::get_face_edge_index(size_t tri_idx, size_t edge_idx) const {
+    EDYN_ASSERT(tri_idx < num_triangles());
+    EDYN_ASSERT(edge_idx < 3);
+    auto cell_idx = tri_idx / 2;
+    auto column = cell_idx % (m_num_columns - 1);
+    auto row = cell_idx / (m_num_columns - 1);
+
+    auto x_edge = [&] (size_t c, size_t r) {
+        return static_cast<index_type>(r * (m_num_columns - 1) + c);
+    };
+    auto z_edge = [&] (size_t c, size_t r) {
+        return static_cast<index_type>(m_z_edges_offset + r * m_num_columns + c);
+    };
+    auto diagonal = static_cast<index_type>(m_diagonal_edges_offset + cell_idx);
+
+    if (tri_idx % 2 == 0) {
+        switch (edge_idx) {
+        case 0: return z_edge(column, row);
+        case 1: return x_edge(column, row + 1);
+        default: return diagonal;
+        }
+    }
+
+    switch (edge_idx) {
+    case 0: return diagonal;
+    case 1: return z_edge(column + 1, row);
+    default: return x_edge(column, row);
+    }
+}
+
+std::array<heightfield::index_type, 2> heightfield::get_edge_vertex_indices(size_t edge_idx) const {
+    EDYN_ASSERT(edge_idx < num_edges());
+
+    if (edge_idx < m_z_edges_offset) {
+        auto column = edge_idx % (m_num_columns - 1);
+        auto row = edge_idx / (m_num_columns - 1);
+        auto v0 = static_cast<index_type>(row * m_num_columns + column);
+        return {v0, v0 + 1};
+    }
+
+    if (edge_idx < m_diagonal_edges_offset) {
+        auto v0 = static_cast<index_type>(edge_idx - m_z_edges_offset);
+        return {v0, static_cast<index_type>(v0 + m_num_columns)};
+    }
+
+    auto cell_idx = edge_idx - m_diagonal_edges_offset;
+    auto column = cell_idx % (m_num_columns - 1);
+    auto row = cell_idx / (m_num_columns - 1);
+    auto v0 = static_cast<index_type>(row * m_num_columns + column);
+    return {v0, static_cast<index_type>(v0 + m_num_columns + 1)};
+}
+
+std::array<heightfield::index_type, 2> heightfield::get_edge_face_indices(size_t edge_idx) const {
+    EDYN_ASSERT(edge_idx < num_edges());
+    auto num_cell_columns = m_num_columns - 1;
+    auto num_cell_rows = m_num_rows - 1;
+    auto cell_tri = [&] (size_t c, size_t r, size_t k) {
+        return static_cast<index_type>((r * num_cell_columns + c) * 2 + k);
+    };
+
+    if (edge_idx < m_z_edges_offset) {
+        // Edge parallel to the x axis. The cell above contains it in its
+        // second triangle and the cell below in its first.
+        auto column = edge_idx % num_cell_columns;
+        auto row = edge_idx / num_cell_columns;
+        auto above = row < num_cell_rows ? cell_tri(column, row, 1) : cell_tri(column, row - 1, 0);
+        auto below = row > 0 ? cell_tri(column, row - 1, 0) : above;
+        return {above, below};
+    }
+
+    if (edge_idx < m_diagonal_edges_offset) {
+        // Edge parallel to the z axis. The cell to the right contains it in
+        // its first triangle and the cell to the left in its second.
+        auto vertex_idx = edge_idx - m_z_edges_offset;
+        auto column = vertex_idx % m_num_columns;
+        auto row = vertex_idx / m_num_columns;
+        auto right = column < num_cell_columns ? cell_tri(column, row, 0) : cell_tri(column - 1, row, 1);
+        auto left = column > 0 ? cell_tri(column - 1, row, 1) : right;
+        return {right, left};
+    }
+
+    auto cell_idx = edge_idx - m_diagonal_edges_offset;
+    return {static_cast<index_type>(cell_idx * 2), static_cast<index_type>(cell_idx * 2 + 1)};
+}
+
+bool heightfield::is_convex_edge(size_t edge_idx) const {
+    auto face_indices = get_edge_face_indices(edge_idx);
+
+    if (face_indices[0] == face_indices[1]) {
+        // Boundary edges are always convex.
+        return true;
+    }
+
+    // Find the edge in the first face to obtain its direction with the
+    // winding of that face.
+    auto face_idx = face_indices[0];
+    size_t i = 0;
+
+    for (; i < 3; ++i) {
+        if (get_face_edge_index(face_idx, i) == edge_idx) {
+            break;
+        }
+    }
+
+    EDYN_ASSERT(i < 3);
+    auto vertices = get_triangle_vertices(face_idx);
+    auto normal = get_triangle_normal(face_idx);
+    auto edge_dir = vertices[(i + 1) % 3] - vertices[i];
+    auto edge_normal = cross(normal, edge_dir);
+    auto other_normal = get_triangle_normal(face_indices[1]);
+
+    return dot(other_normal, edge_normal) < -EDYN_EPSILON;
+}
+
+vector3 heightfield::get_adjacent_face_normal(size_t tri_idx, size_t edge_idx) const {
+    EDYN_ASSERT(tri_idx < num_triangles());
+    EDYN_ASSERT(edge_idx < 3);
+
+    auto face_indices = get_edge_face_indices(get_face_edge_index(tri_idx, edge_idx));
+    auto other_face_idx = face_indices[0] == tri_idx ? face_indices[1] : face_indices[0];
+
+    if (other_face_idx != tri_idx) {
+        return get_triangle_normal(other_face_idx);
+    }
+
+    // This is a boundary edge. Make adjacent normal point slightly away in
+    // the edge direction to form a near 180 degree angle, in the same manner
+    // as it's done for triangle meshes.
+    auto vertices = get_triangle_vertices(tri_idx);
+    auto normal = get_triangle_normal(tri_idx);
+    auto edge_dir = vertices[(edge_idx + 1) % 3] - vertices[edge_idx];
+    auto edge_normal = cross(normal, edge_dir);
+    return -normalize(normal + edge_normal * scalar(0.1));
+}
+
+bool heightfield::get_cell_range(const AABB &aabb, size_t &col_begin, size_t &col_end,
+                                 size_t &row_begin, size_t &row_end) const {
+    if (m_heights.empty() || !intersect(aabb, m_aabb)) {
+        return false;
+    }
+
+    auto min = aabb.min - m_origin;
+    auto max = aabb.max - m_origin;
+    auto num_cell_columns = static_cast<scalar>(m_num_columns - 1);
+    auto num_cell_rows = static_cast<scalar>(m_num_rows - 1);
+
+    col_begin = static_cast<size_t>(std::clamp(std::floor(min.x / m_cell_size.x), scalar(0), num_cell_columns));
+    col_end = static_cast<size_t>(std::clamp(std::floor(max.x / m_cell_size.x) + 1, scalar(0), num_cell_columns));
+    row_begin = static_cast<size_t>(std::clamp(std::floor(min.z / m_cell_size.y), scalar(0), num_cell_rows));
+    row_end = static_cast<size_t>(std::clamp(std::floor(max.z / m_cell_size.y) + 1, scalar(0), num_cell_rows));
+
+    return col_begin < col_end && row_begin < row_end;
+}
+
+}
@@ -1,5 +1,6 @@
 #include "edyn/shapes/paged_triangle_mesh.hpp"
 #include "edyn/parallel/parallel_for.hpp"
+#include <algorithm>
 #include <atomic>
 #include <limits>
 #include <mutex>
@@ -13,6 +14,28 @@ paged_triangle_mesh::paged_triangle_mesh(std::shared_ptr<triangle_mesh_page_load
     m_page_loader->on_load_sink().connect<&paged_triangle_mesh::assign_mesh>(*this);
 }
 
+void paged_triangle_mesh::init_cache() {
+    auto num_submeshes = m_cache.size();
+    m_lru_entries.assign(num_submeshes, {});
+    m_lru_head = m_lru_tail = null_lru_index;
+    m_visit_stamps = std::make_unique<std::atomic<uint64_t>[]>(num_submeshes);
+    m_is_loading_submesh = std::make_unique<std::atomic<bool>[]>(num_submeshes);
+
+    size_t num_bytes = 0;
+
+    for (size_t i = 0; i < num_submeshes; ++i) {
+        auto &node = m_cache[i];
+
+        if (node.trimesh) {
+            node.num_bytes = node.trimesh->memory_usage();
+            num_bytes += node.num_bytes;
+            lru_push_front(i);
+        }
+    }
+
+    m_cache_num_bytes.store(num_bytes, std::memory_order_relaxed);
+}
+
 size_t paged_triangle_mesh::cache_num_vertices() const {
     size_t count = 0;
 
@@ -27,47 +50,139 @@ size_t paged_triangle_mesh::cache_num_vertices() const {
     return count;
 }
 
-void paged_triangle_mesh::load_node_if_needed(size_t trimesh_idx) {
+bool paged_triangle_mesh::load_node_if_needed(size_t trimesh_idx) {
     EDYN_ASSERT(m_is_loading_submesh && trimesh_idx < m_cache.size());
     auto already_loading = m_is_loading_submesh[trimesh_idx].exchange(true, std::memory_order_relaxed);
 
     if (already_loading) {
-        return;
+        return false;
     }
 
-    auto &node = m_cache[trimesh_idx];
-
-    if (node.trimesh) {
+    if (m_cache[trimesh_idx].trimesh) {
         m_is_loading_submesh[trimesh_idx].store(false, std::memory_order_relaxed);
-        return;
-    }
-
-    EDYN_ASSERT(node.num_vertices < m_max_cache_num_vertices);
-    // Load triangle mesh into cache. Clear cache if it would go
-    // above limits.
-    while (cache_num_vertices() + node.num_vertices > m_max_cache_num_vertices) {
-        unload_least_recently_visited_node();
+        return false;
     }
 
+    // The cache is kept within budget once the mesh is assigned, when its
+    // actual size is known.
     m_page_loader->load(trimesh_idx);
+
+    return true;
+}
+
+void paged_triangle_mesh::prefetch(const AABB &aabb) {
+    m_tree.query(aabb, [&] (auto tree_node_idx) {
+        auto mesh_idx = m_tree.get_node(tree_node_idx).id;
+
+        if (m_cache[mesh_idx].trimesh) {
+            mark_recent_visit(mesh_idx);
+        } else if (load_node_if_needed(mesh_idx)) {
+            m_num_prefetches.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+}
+
+void paged_triangle_mesh::prefetch(const AABB &aabb, const vector3 &velocity, scalar time) {
+    prefetch(swept_aabb(aabb, velocity, time));
+}
+
+paged_triangle_mesh::cache_stats paged_triangle_mesh::get_stats() const {
+    return {
+        m_num_hits.load(std::memory_order_relaxed),
+        m_num_misses.load(std::memory_order_relaxed),
+        m_num_prefetches.load(std::memory_order_relaxed),
+        m_num_evictions.load(std::memory_order_relaxed)
+    };
+}
+
+void paged_triangle_mesh::reset_stats() {
+    m_num_hits.store(0, std::memory_order_relaxed);
+    m_num_misses.store(0, std::memory_order_relaxed);
+    m_num_prefetches.store(0, std::memory_order_relaxed);
+    m_num_evictions.store(0, std::memory_order_relaxed);
 }
 
 void paged_triangle_mesh::mark_recent_visit(size_t trimesh_idx) {
-    auto lock = std::lock_guard(m_lru_mutex);
-    auto it = std::find(m_lru_indices.begin(), m_lru_indices.end(), trimesh_idx);
-    std::rotate(m_lru_indices.begin(), it, it + 1);
+    auto stamp = m_visit_clock.fetch_add(1, std::memory_order_relaxed) + 1;
+    m_visit_stamps[trimesh_idx].store(stamp, std::memory_order_relaxed);
 }
 
-void paged_triangle_mesh::unload_least_recently_visited_node() {
-    auto lock = std::lock_guard(m_lru_mutex);
+void paged_triangle_mesh::lru_push_front(size_t trimesh_idx) {
+    auto &entry = m_lru_entries[trimesh_idx];
+    entry.prev = null_lru_index;
+    entry.next = m_lru_head;
+    entry.stamp = m_visit_stamps[trimesh_idx].load(std::memory_order_relaxed);
 
-    for (auto it = m_lru_indices.rbegin(); it != m_lru_indices.rend(); ++it) {
-        auto &node = m_cache[*it];
-        if (node.trimesh) {
-            node.trimesh.reset();
+    if (m_lru_head != null_lru_index) {
+        m_lru_entries[m_lru_head].prev = trimesh_idx;
+    } else {
+        m_lru_tail = trimesh_idx;
+    }
+
+    m_lru_head = trimesh_idx;
+}
+
+void paged_triangle_mesh::lru_unlink(size_t trimesh_idx) {
+    auto &entry = m_lru_entries[trimesh_idx];
+
+    if (entry.prev != null_lru_index) {
+        m_lru_entries[entry.prev].next = entry.next;
+    } else {
+        m_lru_head = entry.next;
+    }
+
+    if (entry.next != null_lru_index) {
+        m_lru_entries[entry.next].prev = entry.prev;
+    } else {
+        m_lru_tail = entry.prev;
+    }
+
+    entry.prev = entry.next = null_lru_index;
+}
+
+bool paged_triangle_mesh::unload_least_recently_visited_node(size_t keep_idx) {
+    // Entries at the back which were visited after they were last moved to
+    // the front are moved to the front again instead of being unloaded. Each
+    // visit causes at most one move thus the amortized cost is constant. The
+    // number of moves is bounded to guarantee progress under concurrent
+    // visits.
+    auto max_moves = m_lru_entries.size();
+    auto idx = m_lru_tail;
+
+    while (idx != null_lru_index) {
+        if (idx == keep_idx && m_lru_head == m_lru_tail) {
+            return false;
+        }
+
+        auto stamp = m_visit_stamps[idx].load(std::memory_order_relaxed);
+        auto visited = stamp != m_lru_entries[idx].stamp;
+
+        if (idx != keep_idx && (!visited || max_moves == 0)) {
             break;
         }
+
+        lru_unlink(idx);
+        lru_push_front(idx);
+        idx = m_lru_tail;
+
+        // The node to be kept can still be moved once the budget is spent.
+        if (max_moves > 0) {
+            --max_moves;
+        }
+    }
+
+    if (idx == null_lru_index) {
+        return false;
     }
+
+    auto &node = m_cache[idx];
+    lru_unlink(idx);
+    node.trimesh.reset();
+    m_cache_num_bytes.fetch_sub(node.num_bytes, std::memory_order_relaxed);
+    node.num_bytes = 0;
+    m_num_evictions.fetch_add(1, std::memory_order_relaxed);
+
+    return true;
 }
 
 triangle_vertices paged_triangle_mesh::get_triangle_vertices(size_t mesh_idx, size_t tri_idx) {
@@ -77,16 +192,46 @@ triangle_vertices paged_triangle_mesh::get_triangle_vertices(size_t mesh_idx, si
 }
 
 void paged_triangle_mesh::clear_cache() {
+    auto lock = std::lock_guard(m_lru_mutex);
+
     for (auto &node : m_cache) {
         node.trimesh.reset();
+        node.num_bytes = 0;
     }
+
+    std::fill(m_lru_entries.begin(), m_lru_entries.end(), lru_entry{});
+    m_lru_head = m_lru_tail = null_lru_index;
+    m_cache_num_bytes.store(0, std::memory_order_relaxed);
 }
 
 void paged_triangle_mesh::assign_mesh(size_t index, std::shared_ptr<triangle_mesh> mesh) {
     // Use lock to prevent assigning to the same trimesh shared_ptr concurrently
     // if `unload_least_recently_visited_node` is executing in another thread.
     auto lock = std::lock_guard(m_lru_mutex);
-    m_cache[index].trimesh = mesh;
+    auto &node = m_cache[index];
+
+    if (node.trimesh) {
+        lru_unlink(index);
+        m_cache_num_bytes.fetch_sub(node.num_bytes, std::memory_order_relaxed);
+    }
+
+    node.trimesh = mesh;
+    node.num_bytes = mesh ? mesh->memory_usage() : 0;
+
+    if (mesh) {
+        // A newly loaded submesh counts as the most recently visited so it
+        // is not unloaded before it's used.
+        m_cache_num_bytes.fetch_add(node.num_bytes, std::memory_order_relaxed);
+        mark_recent_visit(index);
+        lru_push_front(index);
+
+        while (m_cache_num_bytes.load(std::memory_order_relaxed) > m_max_cache_num_bytes) {
+            if (!unload_least_recently_visited_node(index)) {
+                break;
+            }
+        }
+    }
+
     m_is_loading_submesh[index].store(false, std::memory_order_release);
 }
 
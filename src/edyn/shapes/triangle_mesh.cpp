@@ -5,6 +5,7 @@
 namespace edyn {
 
 void triangle_mesh::initialize() {
+    EDYN_ASSERT(!m_compressed);
     // Order is important.
     calculate_face_normals();
     init_edge_indices();
@@ -38,7 +39,9 @@ void triangle_mesh::init_edge_indices() {
             auto pair = unordered_pair(i0, i1);
             auto edge_idx = SIZE_MAX;
 
-            for (size_t k = 0; k < m_edge_vertex_indices.size(); ++k) {
+            // If this edge already exists, it's among the edges which share
+            // the first vertex.
+            for (auto k : vertex_edge_indices[i0]) {
                 if (m_edge_vertex_indices[k] == pair) {
                     edge_idx = k;
                     break;
@@ -141,9 +144,123 @@ void triangle_mesh::build_triangle_tree() {
     m_triangle_tree.build(aabbs.begin(), aabbs.end(), report_leaf);
 }
 
+void triangle_mesh::build_soa_layout() {
+    auto soa = std::make_shared<triangle_mesh_soa>();
+    soa->build(*this);
+    m_soa = std::move(soa);
+}
+
+void triangle_mesh::compress() {
+    EDYN_ASSERT(!m_compressed);
+    EDYN_ASSERT(m_normals.size() == m_indices.size());
+
+    if (m_vertices.empty()) {
+        return;
+    }
+
+    auto min = m_vertices.front();
+    auto max = m_vertices.front();
+
+    for (auto &v : m_vertices) {
+        min = edyn::min(min, v);
+        max = edyn::max(max, v);
+    }
+
+    auto extent = max - min;
+    auto inv_scale = vector3_zero;
+
+    for (size_t i = 0; i < 3; ++i) {
+        m_quantization_scale[i] = extent[i] / scalar(UINT16_MAX);
+
+        // Flat axes are left with a zero scale and thus decode to the minimum.
+        // Any non-zero extent must be quantized, however thin.
+        if (extent[i] > scalar(0)) {
+            inv_scale[i] = scalar(1) / m_quantization_scale[i];
+        }
+    }
+
+    m_quantization_origin = min;
+
+    m_quantized_vertices.reserve(m_vertices.size());
+
+    for (auto &v : m_vertices) {
+        m_quantized_vertices.push_back(quantize_position(v, min, inv_scale));
+    }
+
+    m_packed_normals.reserve(m_normals.size());
+
+    for (auto &normal : m_normals) {
+        m_packed_normals.push_back(pack_unit_vector_octahedral(normal));
+    }
+
+    m_packed_adjacent_normals.reserve(m_adjacent_normals.size());
+
+    for (auto &normals : m_adjacent_normals) {
+        m_packed_adjacent_normals.push_back({
+            pack_unit_vector_octahedral(normals[0]),
+            pack_unit_vector_octahedral(normals[1]),
+            pack_unit_vector_octahedral(normals[2])
+        });
+    }
+
+    m_vertices = {};
+    m_normals = {};
+    m_adjacent_normals = {};
+    m_compressed = true;
+
+    // Vertices moved slightly, thus the tree must be rebuilt for the
+    // triangle AABBs to enclose the decoded triangles.
+    m_triangle_tree.clear();
+    build_triangle_tree();
+
+    if (m_soa) {
+        build_soa_layout();
+    }
+}
+
+template<typename T>
+static size_t vector_memory_usage(const mappable_vector<T> &vec) {
+    return vec.capacity() * sizeof(T);
+}
+
+static size_t vector_memory_usage(const mappable_vector<bool> &vec) {
+    return vec.capacity() / 8;
+}
+
+size_t triangle_mesh::memory_usage() const {
+    return
+        sizeof(triangle_mesh) +
+        vector_memory_usage(m_vertices) +
+        vector_memory_usage(m_indices) +
+        vector_memory_usage(m_normals) +
+        vector_memory_usage(m_adjacent_normals) +
+        vector_memory_usage(m_edge_vertex_indices) +
+        m_vertex_edge_indices.memory_usage() +
+        vector_memory_usage(m_face_edge_indices) +
+        vector_memory_usage(m_edge_face_indices) +
+        vector_memory_usage(m_is_boundary_edge) +
+        vector_memory_usage(m_is_convex_edge) +
+        vector_memory_usage(m_friction) +
+        vector_memory_usage(m_restitution) +
+        m_triangle_tree.memory_usage() +
+        vector_memory_usage(m_quantized_vertices) +
+        vector_memory_usage(m_packed_normals) +
+        vector_memory_usage(m_packed_adjacent_normals) +
+        (m_soa ? m_soa->memory_usage() : 0);
+}
+
 triangle_vertices triangle_mesh::get_triangle_vertices(size_t tri_idx) const {
     EDYN_ASSERT(tri_idx < m_indices.size());
     auto indices = m_indices[tri_idx];
+
+    if (m_compressed) {
+        return {
+            get_vertex_position(indices[0]),
+            get_vertex_position(indices[1]),
+            get_vertex_position(indices[2])
+        };
+    }
+
     return {
         m_vertices[indices[0]],
         m_vertices[indices[1]],
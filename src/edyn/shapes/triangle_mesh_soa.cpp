@@ -0,0 +1,85 @@
+#include "edyn/shapes/triangle_mesh_soa.hpp"
+#include "edyn/shapes/triangle_mesh.hpp"
+
+namespace edyn {
+
+void triangle_mesh_soa::build(const triangle_mesh &mesh) {
+    m_tree.clear();
+    m_blocks.clear();
+
+    if (mesh.num_triangles() == 0) {
+        return;
+    }
+
+    std::vector<AABB> aabbs;
+    aabbs.reserve(mesh.num_triangles());
+
+    for (size_t i = 0; i < mesh.num_triangles(); ++i) {
+        aabbs.push_back(get_triangle_aabb(mesh.get_triangle_vertices(i)));
+    }
+
+    auto report_leaf = [&] (static_tree::tree_node &node, auto ids_begin, auto ids_end) {
+        node.id = m_blocks.size();
+        auto &block = m_blocks.emplace_back();
+        block.count = 0;
+
+        for (auto it = ids_begin; it != ids_end; ++it) {
+            auto tri_idx = *it;
+            auto lane = block.count++;
+            auto vertices = mesh.get_triangle_vertices(tri_idx);
+            auto normal = mesh.get_triangle_normal(tri_idx);
+            auto &aabb = aabbs[tri_idx];
+
+            for (size_t i = 0; i < 3; ++i) {
+                for (size_t j = 0; j < 3; ++j) {
+                    block.vertices[i][j][lane] = vertices[i][j];
+                }
+
+                block.normals[i][lane] = normal[i];
+                block.aabb_min[i][lane] = aabb.min[i];
+                block.aabb_max[i][lane] = aabb.max[i];
+            }
+
+            block.plane_distance[lane] = dot(vertices[0], normal);
+            block.tri_idx[lane] = tri_idx;
+
+            uint8_t flags = 0;
+
+            for (size_t i = 0; i < 3; ++i) {
+                auto edge_idx = mesh.get_face_edge_index(tri_idx, i);
+
+                if (mesh.is_convex_edge(edge_idx)) {
+                    flags |= edge_flag_convex << i;
+                }
+
+                if (mesh.is_boundary_edge(edge_idx)) {
+                    flags |= edge_flag_boundary << i;
+                }
+            }
+
+            block.edge_flags[lane] = flags;
+        }
+
+        // Fill the remaining lanes with data that never passes the culling
+        // tests so the whole block can be processed unconditionally.
+        for (auto lane = block.count; lane < lane_width; ++lane) {
+            for (size_t i = 0; i < 3; ++i) {
+                for (size_t j = 0; j < 3; ++j) {
+                    block.vertices[i][j][lane] = 0;
+                }
+
+                block.normals[i][lane] = 0;
+                block.aabb_min[i][lane] = EDYN_SCALAR_MAX;
+                block.aabb_max[i][lane] = -EDYN_SCALAR_MAX;
+            }
+
+            block.plane_distance[lane] = -EDYN_SCALAR_MAX;
+            block.tri_idx[lane] = 0;
+            block.edge_flags[lane] = 0;
+        }
+    };
+
+    m_tree.build(aabbs.begin(), aabbs.end(), report_leaf, lane_width);
+}
+
+}
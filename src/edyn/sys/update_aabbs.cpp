@@ -19,11 +19,9 @@ AABB updated_aabb(const polyhedron_shape &polyhedron,
                   const vector3 &pos, const quaternion &orn) {
     // `shape_aabb(const polyhedron_shape &, ...)` rotates each vertex of a
     // polyhedron to calculate the AABB. Specialize `updated_aabb` for
-    // polyhedrons to use the rotated mesh.
-    auto aabb = point_cloud_aabb(polyhedron.rotated->vertices);
-    aabb.min += pos;
-    aabb.max += pos;
-    return aabb;
+    // polyhedrons to transform the local AABB instead, which gives a slightly
+    // larger bound but does not depend on the rotated mesh being up to date.
+    return aabb_to_world_space(polyhedron.rotated->local_aabb, pos, orn);
 }
 
 template<typename ShapeType, typename TransformView, typename OriginView>
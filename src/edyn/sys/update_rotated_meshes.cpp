@@ -7,6 +7,12 @@
 
 namespace edyn {
 
+// Current version of the rotated meshes in a registry. Rotated mesh lists with
+// a different version are outdated.
+struct rotated_mesh_version {
+    uint32_t value {1};
+};
+
 static void update_rotated_mesh_vertices(rotated_mesh &rotated, const convex_mesh &mesh,
                                          const quaternion &orn) {
     EDYN_ASSERT(mesh.vertices.size() == rotated.vertices.size());
@@ -44,9 +50,12 @@ void update_rotated_mesh(rotated_mesh &rotated, const convex_mesh &mesh,
 }
 
 template<typename RotatedView, typename OrientationView>
-void update_rotated_mesh(entt::entity entity, RotatedView &rotated_view, OrientationView &orn_view) {
+void update_rotated_mesh(entt::entity entity, RotatedView &rotated_view,
+                         OrientationView &orn_view, uint32_t version) {
     auto &orn = orn_view.template get<orientation>(entity);
     auto &rotated_list = rotated_view.template get<rotated_mesh_list>(entity);
+    rotated_list.version = version;
+    rotated_list.body_orientation = orn;
 
     auto *rot_list_ptr = &rotated_list;
 
@@ -66,16 +75,50 @@ void update_rotated_mesh(entt::entity entity, RotatedView &rotated_view, Orienta
 void update_rotated_mesh(entt::registry &registry, entt::entity entity) {
     auto rotated_view = registry.view<rotated_mesh_list>();
     auto orn_view = registry.view<orientation>();
-    update_rotated_mesh(entity, rotated_view, orn_view);
+    auto version = registry.ctx_or_set<rotated_mesh_version>().value;
+    update_rotated_mesh(entity, rotated_view, orn_view, version);
 }
 
 void update_rotated_meshes(entt::registry &registry) {
     auto rotated_view = registry.view<rotated_mesh_list>();
     auto view = registry.view<orientation, rotated_mesh_list>();
+    auto version = registry.ctx_or_set<rotated_mesh_version>().value;
 
     for (auto entity : view) {
-        update_rotated_mesh(entity, rotated_view, view);
+        update_rotated_mesh(entity, rotated_view, view, version);
     }
 }
 
+void invalidate_rotated_meshes(entt::registry &registry) {
+    ++registry.ctx_or_set<rotated_mesh_version>().value;
+}
+
+void update_rotated_mesh_if_outdated(entt::registry &registry, entt::entity entity) {
+    auto rotated_view = registry.view<rotated_mesh_list>();
+
+    if (!rotated_view.contains(entity)) {
+        return;
+    }
+
+    auto version = registry.ctx_or_set<rotated_mesh_version>().value;
+
+    auto &rotated_list = rotated_view.get<rotated_mesh_list>(entity);
+
+    if (rotated_list.version == version) {
+        return;
+    }
+
+    auto orn_view = registry.view<orientation>();
+
+    // Bodies which haven't rotated since the last update, such as resting
+    // ones, only need their version stamp to be refreshed.
+    if (rotated_list.version != 0 &&
+        rotated_list.body_orientation == orn_view.get<orientation>(entity)) {
+        rotated_list.version = version;
+        return;
+    }
+
+    update_rotated_mesh(entity, rotated_view, orn_view, version);
+}
+
 }
@@ -5,9 +5,16 @@
 #include "edyn/math/math.hpp"
 #include "edyn/math/vector3.hpp"
 #include "edyn/shapes/triangle_mesh.hpp"
+#include "edyn/shapes/heightfield.hpp"
+#include "edyn/serialization/mapped_file.hpp"
+#include "edyn/parallel/job_dispatcher.hpp"
+#include "edyn/parallel/parallel_for.hpp"
 #include <fstream>
 #include <sstream>
 #include <numeric>
+#include <charconv>
+#include <cstring>
+#include <cstdlib>
 
 namespace edyn {
 
@@ -224,6 +231,361 @@ bool load_tri_mesh_from_obj(const std::string &path,
     return true;
 }
 
+namespace {
+
+// Parses the contents of a line of a memory mapped *.obj file with the same
+// rules as `std::istringstream` does in the functions above.
+struct obj_line_parser {
+    const char *cur;
+    const char *end;
+
+    static bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    void skip_space() {
+        while (cur < end && is_space(*cur)) ++cur;
+    }
+
+    bool read_scalar(scalar &value) {
+        skip_space();
+        auto *first = cur;
+
+        // Unlike stream extraction, `from_chars` does not accept a plus sign.
+        if (first < end && *first == '+') {
+            ++first;
+        }
+
+    #if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        auto [ptr, ec] = std::from_chars(first, end, value);
+
+        if (ec != std::errc{}) {
+            return false;
+        }
+
+        cur = ptr;
+    #else
+        // Floating point `from_chars` is not available thus copy the token
+        // into a null-terminated buffer which can be parsed with `strtod`.
+        char buffer[64];
+        size_t length = 0;
+
+        while (first + length < end && !is_space(first[length]) && length < sizeof(buffer) - 1) {
+            buffer[length] = first[length];
+            ++length;
+        }
+
+        buffer[length] = '\0';
+        char *ptr;
+
+        if constexpr(std::is_same_v<scalar, float>) {
+            value = std::strtof(buffer, &ptr);
+        } else {
+            value = std::strtod(buffer, &ptr);
+        }
+
+        if (ptr == buffer) {
+            return false;
+        }
+
+        cur = first + (ptr - buffer);
+    #endif
+
+        return true;
+    }
+
+    bool read_vector3(vector3 &v) {
+        return read_scalar(v.x) && read_scalar(v.y) && read_scalar(v.z);
+    }
+
+    // Reads the first element in a "v/vt/vn" sequence and moves to the next
+    // sequence. Returns false when there are no more sequences.
+    bool read_index(int &index) {
+        skip_space();
+
+        if (cur == end) {
+            return false;
+        }
+
+        auto *token_end = cur;
+        while (token_end < end && !is_space(*token_end)) ++token_end;
+
+        auto *first = cur;
+
+        if (*first == '+') {
+            ++first;
+        }
+
+        auto [ptr, ec] = std::from_chars(first, token_end, index);
+        EDYN_ASSERT(ec == std::errc{});
+        cur = token_end;
+
+        return ec == std::errc{};
+    }
+};
+
+// Content of a line after the command, which is the text before the first
+// space.
+struct obj_line {
+    const char *cmd;
+    size_t cmd_size;
+    obj_line_parser args;
+
+    bool is(const char *name) const {
+        return std::strlen(name) == cmd_size && std::memcmp(cmd, name, cmd_size) == 0;
+    }
+};
+
+// Splits the text in `[begin, end)` in lines and invokes `func` for each
+// line which contains a space.
+template<typename Func>
+void for_each_obj_line(const char *begin, const char *end, Func func) {
+    while (begin < end) {
+        auto *line_end = static_cast<const char *>(std::memchr(begin, '\n', end - begin));
+
+        if (line_end == nullptr) {
+            line_end = end;
+        }
+
+        auto *space = static_cast<const char *>(std::memchr(begin, ' ', line_end - begin));
+
+        if (space != nullptr) {
+            func(obj_line{begin, size_t(space - begin), {space, line_end}});
+        }
+
+        begin = line_end + 1;
+    }
+}
+
+vector3 transform_obj_vertex(vector3 v, vector3 pos, quaternion orn, vector3 scale) {
+    if (scale != vector3_one) {
+        v *= scale;
+    }
+
+    if (orn != quaternion_identity) {
+        v = rotate(orn, v);
+    }
+
+    if (pos != vector3_zero ) {
+        v += pos;
+    }
+
+    return v;
+}
+
+void read_obj_vertex(obj_line_parser &args, std::vector<vector3> &vertices,
+                     std::vector<vector3> *colors,
+                     vector3 pos, quaternion orn, vector3 scale) {
+    auto v = vector3_zero;
+    auto valid = args.read_vector3(v);
+    vertices.push_back(transform_obj_vertex(v, pos, orn, scale));
+
+    // Try reading vertex color.
+    if (colors != nullptr && valid) {
+        auto color = vector3{};
+
+        if (args.read_vector3(color)) {
+            colors->push_back(color);
+        }
+    }
+}
+
+void read_obj_face_indices(obj_line_parser &args, std::vector<uint32_t> &indices,
+                           uint32_t offset, bool triangulate) {
+    auto count = size_t{};
+    uint32_t first_idx;
+    uint32_t prev_idx;
+    int value;
+
+    while (args.read_index(value)) {
+        auto idx = static_cast<uint32_t>(value);
+        EDYN_ASSERT(idx >= 1 + offset);
+
+        if (triangulate && count >= 3) {
+            indices.push_back(first_idx);
+            indices.push_back(prev_idx);
+        }
+
+        indices.push_back(idx - 1 - offset);
+
+        if (count == 0) {
+            first_idx = indices.back();
+        }
+
+        prev_idx = indices.back();
+        ++count;
+    }
+}
+
+// Number of vertices and faces in the text in `[begin, end)`.
+std::pair<size_t, size_t> count_obj_elements(const char *begin, const char *end) {
+    size_t num_vertices = 0, num_faces = 0;
+
+    for_each_obj_line(begin, end, [&] (const obj_line &line) {
+        if (line.is("v")) {
+            ++num_vertices;
+        } else if (line.is("f")) {
+            ++num_faces;
+        }
+    });
+
+    return {num_vertices, num_faces};
+}
+
+struct obj_tri_mesh_chunk {
+    const char *begin;
+    const char *end;
+    std::vector<vector3> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<vector3> colors;
+};
+
+void parse_obj_tri_mesh_chunk(obj_tri_mesh_chunk &chunk, bool read_colors,
+                              vector3 pos, quaternion orn, vector3 scale) {
+    auto [num_vertices, num_faces] = count_obj_elements(chunk.begin, chunk.end);
+    chunk.vertices.reserve(num_vertices);
+    chunk.indices.reserve(num_faces * 3);
+
+    if (read_colors) {
+        chunk.colors.reserve(num_vertices);
+    }
+
+    auto *colors = read_colors ? &chunk.colors : nullptr;
+
+    for_each_obj_line(chunk.begin, chunk.end, [&] (obj_line line) {
+        if (line.is("v")) {
+            read_obj_vertex(line.args, chunk.vertices, colors, pos, orn, scale);
+        } else if (line.is("f")) {
+            read_obj_face_indices(line.args, chunk.indices, 0, true);
+        }
+    });
+}
+
+template<typename T>
+void append(std::vector<T> &dest, const std::vector<T> &src) {
+    dest.insert(dest.end(), src.begin(), src.end());
+}
+
+}
+
+bool load_meshes_from_obj_mapped(const std::string &path,
+                                 std::vector<obj_mesh> &meshes,
+                                 vector3 pos,
+                                 quaternion orn,
+                                 vector3 scale) {
+    auto file = mapped_file{};
+
+    if (!file.open(path)) {
+        // Empty files cannot be mapped.
+        return std::ifstream(path).is_open();
+    }
+
+    auto *begin = reinterpret_cast<const char *>(file.data());
+    auto *end = begin + file.size();
+    auto mesh = obj_mesh{};
+    uint32_t index_offset = 0;
+
+    for_each_obj_line(begin, end, [&] (obj_line line) {
+        if (line.is("o")) {
+            if (!mesh.vertices.empty()) {
+                index_offset += mesh.vertices.size();
+                meshes.emplace_back(std::move(mesh));
+                mesh = obj_mesh{};
+            }
+        } else if (line.is("v")) {
+            read_obj_vertex(line.args, mesh.vertices, &mesh.colors, pos, orn, scale);
+        } else if (line.is("f")) {
+            mesh.faces.push_back(mesh.indices.size());
+            read_obj_face_indices(line.args, mesh.indices, index_offset, false);
+            auto count = mesh.indices.size() - mesh.faces.back();
+            mesh.faces.push_back(count);
+        }
+    });
+
+    if (!mesh.vertices.empty()) {
+        meshes.emplace_back(std::move(mesh));
+    }
+
+    return true;
+}
+
+bool load_tri_mesh_from_obj_mapped(const std::string &path,
+                                   std::vector<vector3> &vertices,
+                                   std::vector<uint32_t> &indices,
+                                   std::vector<vector3> *colors,
+                                   vector3 pos,
+                                   quaternion orn,
+                                   vector3 scale,
+                                   size_t min_chunk_size) {
+    auto file = mapped_file{};
+
+    if (!file.open(path)) {
+        // Empty files cannot be mapped.
+        return std::ifstream(path).is_open();
+    }
+
+    auto *begin = reinterpret_cast<const char *>(file.data());
+    auto *end = begin + file.size();
+
+    // Split file in chunks at line breaks, one for each worker thread.
+    auto num_workers = job_dispatcher::global().num_workers();
+    auto num_chunks = std::max(size_t{1}, std::min(num_workers + 1, file.size() / std::max(min_chunk_size, size_t{1})));
+    auto chunks = std::vector<obj_tri_mesh_chunk>(num_chunks);
+    auto *chunk_begin = begin;
+
+    for (size_t i = 0; i < num_chunks; ++i) {
+        auto *chunk_end = i + 1 < num_chunks ? begin + file.size() * (i + 1) / num_chunks : end;
+
+        if (chunk_end < chunk_begin) {
+            chunk_end = chunk_begin;
+        } else if (chunk_end < end) {
+            auto *line_end = static_cast<const char *>(std::memchr(chunk_end, '\n', end - chunk_end));
+            chunk_end = line_end != nullptr ? line_end + 1 : end;
+        }
+
+        chunks[i].begin = chunk_begin;
+        chunks[i].end = chunk_end;
+        chunk_begin = chunk_end;
+    }
+
+    auto read_colors = colors != nullptr;
+
+    if (num_chunks > 1) {
+        parallel_for(size_t{0}, num_chunks, [&] (size_t i) {
+            parse_obj_tri_mesh_chunk(chunks[i], read_colors, pos, orn, scale);
+        });
+    } else {
+        parse_obj_tri_mesh_chunk(chunks[0], read_colors, pos, orn, scale);
+    }
+
+    // Face indices are absolute thus the chunks can be simply concatenated.
+    size_t num_vertices = 0, num_indices = 0, num_colors = 0;
+
+    for (auto &chunk : chunks) {
+        num_vertices += chunk.vertices.size();
+        num_indices += chunk.indices.size();
+        num_colors += chunk.colors.size();
+    }
+
+    vertices.reserve(vertices.size() + num_vertices);
+    indices.reserve(indices.size() + num_indices);
+
+    if (read_colors) {
+        colors->reserve(colors->size() + num_colors);
+    }
+
+    for (auto &chunk : chunks) {
+        append(vertices, chunk.vertices);
+        append(indices, chunk.indices);
+
+        if (read_colors) {
+            append(*colors, chunk.colors);
+        }
+    }
+
+    return true;
+}
+
 vector3 support_point_box(const vector3 &half_extents, const vector3 &dir) {
     return {
         dir.x > 0 ? half_extents.x : -half_extents.x,
@@ -535,4 +897,18 @@ size_t get_triangle_mesh_feature_index(const triangle_mesh &mesh, size_t tri_idx
     return SIZE_MAX;
 }
 
+size_t get_triangle_mesh_feature_index(const heightfield &field, size_t tri_idx,
+                                       triangle_feature tri_feature, size_t tri_feature_idx) {
+    switch (tri_feature) {
+    case triangle_feature::face:
+        return tri_idx;
+    case triangle_feature::edge:
+        return field.get_face_edge_index(tri_idx, tri_feature_idx);
+    case triangle_feature::vertex:
+        return field.get_face_vertex_index(tri_idx, tri_feature_idx);
+    }
+
+    return SIZE_MAX;
+}
+
 }
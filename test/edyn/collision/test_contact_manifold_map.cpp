@@ -0,0 +1,213 @@
+#include "../common/common.hpp"
+#include <map>
+#include <random>
+
+// Number of slots of an empty `edyn::contact_manifold_map`.
+static constexpr size_t initial_capacity = 64;
+
+// Same hash used by `edyn::contact_manifold_map` to find the ideal slot of a
+// key, which allows picking pairs of entities that collide in the table.
+static size_t ideal_slot(entt::entity first, entt::entity second, size_t capacity) {
+    uint64_t a = entt::to_integral(first);
+    uint64_t b = entt::to_integral(second);
+    uint64_t key = a < b ? (a << 32) | b : (b << 32) | a;
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ull;
+    key ^= key >> 33;
+    return static_cast<size_t>(key) & (capacity - 1);
+}
+
+class contact_manifold_map_test: public ::testing::Test {
+protected:
+    using reference_map = std::map<std::pair<entt::entity, entt::entity>, entt::entity>;
+
+    // Pairs are unordered in the manifold map.
+    static std::pair<entt::entity, entt::entity> make_pair(entt::entity first, entt::entity second) {
+        return std::make_pair(std::min(first, second), std::max(first, second));
+    }
+
+    void SetUp() override {
+        for (size_t i = 0; i < 256; ++i) {
+            bodies.push_back(registry.create());
+        }
+    }
+
+    entt::entity insert(entt::entity first, entt::entity second) {
+        auto manifold = edyn::contact_manifold{};
+        manifold.body = {first, second};
+        auto entity = registry.create();
+        registry.emplace<edyn::contact_manifold>(entity, manifold);
+        reference[make_pair(first, second)] = entity;
+        return entity;
+    }
+
+    void erase(entt::entity first, entt::entity second) {
+        auto it = reference.find(make_pair(first, second));
+        ASSERT_NE(it, reference.end());
+        registry.destroy(it->second);
+        erased.push_back(it->first);
+        reference.erase(it);
+    }
+
+    // Check that lookups agree with the reference map, in either order of
+    // the pair, and that erased pairs cannot be found anymore.
+    void check() {
+        ASSERT_EQ(manifold_map.size(), reference.size());
+
+        for (auto &[pair, entity] : reference) {
+            ASSERT_EQ(manifold_map.find(pair.first, pair.second), entity);
+            ASSERT_EQ(manifold_map.find(pair.second, pair.first), entity);
+            ASSERT_TRUE(manifold_map.contains(pair.first, pair.second));
+            ASSERT_TRUE(manifold_map.contains(pair));
+            ASSERT_EQ(manifold_map.get(pair), entity);
+        }
+
+        for (auto &pair : erased) {
+            if (reference.count(pair) == 0) {
+                ASSERT_TRUE(manifold_map.find(pair) == entt::null);
+                ASSERT_FALSE(manifold_map.contains(pair.second, pair.first));
+            }
+        }
+    }
+
+    // Find pairs of bodies which map into the given slot.
+    std::vector<std::pair<entt::entity, entt::entity>> colliding_pairs(size_t slot, size_t count) {
+        auto pairs = std::vector<std::pair<entt::entity, entt::entity>>{};
+
+        for (size_t i = 0; i < bodies.size() && pairs.size() < count; ++i) {
+            for (size_t j = i + 1; j < bodies.size() && pairs.size() < count; ++j) {
+                if (ideal_slot(bodies[i], bodies[j], initial_capacity) == slot) {
+                    pairs.emplace_back(bodies[i], bodies[j]);
+                }
+            }
+        }
+
+        EDYN_ASSERT(pairs.size() == count);
+        return pairs;
+    }
+
+    entt::registry registry;
+    edyn::contact_manifold_map manifold_map {registry};
+    std::vector<entt::entity> bodies;
+    reference_map reference;
+    std::vector<std::pair<entt::entity, entt::entity>> erased;
+};
+
+TEST_F(contact_manifold_map_test, colliding_keys) {
+    // Keys which hash to the last slots, so their probe sequences wrap
+    // around the end of the table, mixed with keys whose ideal slot is at the
+    // beginning of the table which are thus displaced by the former. Stay
+    // below half of the capacity so the table doesn't grow.
+    auto last = colliding_pairs(initial_capacity - 1, 8);
+    auto second_last = colliding_pairs(initial_capacity - 2, 4);
+    auto first = colliding_pairs(0, 6);
+    auto second = colliding_pairs(1, 4);
+
+    for (size_t i = 0; i < 8; ++i) {
+        insert(last[i].first, last[i].second);
+        check();
+
+        if (i < second_last.size()) {
+            insert(second_last[i].second, second_last[i].first);
+            check();
+        }
+
+        if (i < first.size()) {
+            insert(first[i].first, first[i].second);
+            check();
+        }
+
+        if (i < second.size()) {
+            insert(second[i].first, second[i].second);
+            check();
+        }
+    }
+
+    // Erase from the middle of the probe chains, which forces entries after
+    // it to be shifted back, including across the end of the table.
+    erase(last[3].first, last[3].second);
+    check();
+    erase(last[0].first, last[0].second);
+    check();
+    erase(second_last[1].second, second_last[1].first);
+    check();
+    erase(first[2].first, first[2].second);
+    check();
+    erase(second[0].first, second[0].second);
+    check();
+
+    // Reinsert erased keys, which must go back into the shortened chains.
+    insert(last[3].first, last[3].second);
+    check();
+    insert(first[2].second, first[2].first);
+    check();
+
+    // Erase everything from the middle out.
+    while (!reference.empty()) {
+        auto it = reference.begin();
+        std::advance(it, reference.size() / 2);
+        auto pair = it->first;
+        erase(pair.first, pair.second);
+        check();
+    }
+
+    ASSERT_EQ(manifold_map.size(), 0);
+}
+
+TEST_F(contact_manifold_map_test, growth_and_reserve) {
+    auto rng = std::mt19937(42);
+    auto dist = std::uniform_int_distribution<size_t>(0, bodies.size() - 1);
+
+    auto random_pair = [&] {
+        while (true) {
+            auto a = bodies[dist(rng)];
+            auto b = bodies[dist(rng)];
+            auto pair = make_pair(a, b);
+
+            if (a != b && reference.count(pair) == 0) {
+                return pair;
+            }
+        }
+    };
+
+    // Grow the table multiple times by insertion.
+    for (size_t i = 0; i < 1000; ++i) {
+        auto pair = random_pair();
+        insert(pair.first, pair.second);
+
+        if (i % 50 == 0) {
+            check();
+        }
+    }
+
+    check();
+
+    // Reserving more than the current capacity rehashes all entries.
+    manifold_map.reserve(5000);
+    check();
+
+    // Reserving less than the current size does nothing.
+    manifold_map.reserve(10);
+    check();
+
+    // Interleave random erasures and insertions.
+    for (size_t i = 0; i < 2000; ++i) {
+        if (i % 3 == 0) {
+            auto pair = random_pair();
+            insert(pair.first, pair.second);
+        } else {
+            auto it = reference.begin();
+            std::advance(it, dist(rng) % reference.size());
+            auto pair = it->first;
+            erase(pair.first, pair.second);
+        }
+
+        if (i % 50 == 0) {
+            check();
+        }
+    }
+
+    check();
+}
@@ -0,0 +1,110 @@
+#include "../common/common.hpp"
+
+TEST(async_update_test, test_update_async) {
+    entt::registry registry;
+
+    edyn::init({2});
+    edyn::attach(registry);
+
+    auto def = edyn::rigidbody_def();
+    def.position = {0, 10, 0};
+    def.shape = edyn::box_shape{0.5, 0.5, 0.5};
+    auto entity = edyn::make_rigidbody(registry, def);
+
+    // Wait for the body to be put into an island and start falling.
+    auto fell = false;
+
+    for (int i = 0; i < 200 && !fell; ++i) {
+        edyn::update_async(registry);
+        edyn::delay(10);
+        edyn::wait_update(registry);
+
+        fell = registry.all_of<edyn::island_resident>(entity) &&
+               registry.get<edyn::present_position>(entity).y < edyn::scalar(10);
+    }
+
+    ASSERT_TRUE(fell);
+
+    // Detaching waits for a pending update.
+    edyn::update_async(registry);
+    edyn::detach(registry);
+    edyn::deinit();
+}
+
+TEST(async_update_test, presentation_snapshot) {
+    entt::registry registry;
+
+    edyn::init({2});
+    edyn::attach(registry);
+
+    auto def = edyn::rigidbody_def();
+    def.shape = edyn::sphere_shape{0.5};
+    auto entities = std::vector<entt::entity>{};
+
+    for (int i = 0; i < 4; ++i) {
+        def.position = {edyn::scalar(i * 2), 10, 0};
+        entities.push_back(edyn::make_rigidbody(registry, def));
+    }
+
+    auto &snapshot = edyn::get_presentation_snapshot(registry);
+    ASSERT_TRUE(snapshot.entries.empty());
+
+    for (int i = 0; i < 50; ++i) {
+        edyn::update_async(registry);
+        ASSERT_TRUE(edyn::is_update_pending(registry));
+
+        // The snapshot of the previous update stays the same while the
+        // background job is running.
+        auto previous = snapshot.entries;
+
+        for (int j = 0; j < 5; ++j) {
+            ASSERT_EQ(snapshot.entries.size(), previous.size());
+
+            for (size_t k = 0; k < previous.size(); ++k) {
+                auto &entry = snapshot.entries[k];
+                ASSERT_EQ(entry.entity, previous[k].entity);
+                ASSERT_VECTOR3_EQ(entry.position, previous[k].position);
+                ASSERT_SCALAR_EQ(entry.orientation.x, previous[k].orientation.x);
+                ASSERT_SCALAR_EQ(entry.orientation.y, previous[k].orientation.y);
+                ASSERT_SCALAR_EQ(entry.orientation.z, previous[k].orientation.z);
+                ASSERT_SCALAR_EQ(entry.orientation.w, previous[k].orientation.w);
+            }
+
+            edyn::delay(1);
+        }
+
+        // Entry points which access the registry fail while pending.
+        ASSERT_THROW(edyn::update(registry), std::logic_error);
+        ASSERT_THROW(edyn::update_async(registry), std::logic_error);
+        ASSERT_THROW(edyn::step_simulation(registry), std::logic_error);
+        ASSERT_THROW(edyn::set_paused(registry, true), std::logic_error);
+        ASSERT_THROW(edyn::set_gravity(registry, edyn::vector3_zero), std::logic_error);
+        ASSERT_THROW(edyn::manifold_exists(registry, entities[0], entities[1]), std::logic_error);
+
+        edyn::wait_update(registry);
+        ASSERT_FALSE(edyn::is_update_pending(registry));
+        ASSERT_THROW(edyn::wait_update(registry), std::logic_error);
+
+        // After the update, the snapshot matches the presentation components.
+        ASSERT_EQ(snapshot.entries.size(), entities.size());
+
+        for (auto entity : entities) {
+            auto *entry = snapshot.find(entity);
+            ASSERT_NE(entry, nullptr);
+            ASSERT_VECTOR3_EQ(entry->position, registry.get<edyn::present_position>(entity));
+            auto &orn = registry.get<edyn::present_orientation>(entity);
+            ASSERT_SCALAR_EQ(entry->orientation.x, orn.x);
+            ASSERT_SCALAR_EQ(entry->orientation.y, orn.y);
+            ASSERT_SCALAR_EQ(entry->orientation.z, orn.z);
+            ASSERT_SCALAR_EQ(entry->orientation.w, orn.w);
+        }
+
+        edyn::delay(5);
+    }
+
+    // Synchronous updates work again once the update is completed.
+    edyn::update(registry);
+
+    edyn::detach(registry);
+    edyn::deinit();
+}
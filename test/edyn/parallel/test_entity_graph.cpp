@@ -1,5 +1,11 @@
 #include "../common/common.hpp"
 #include <edyn/parallel/entity_graph.hpp>
+#include <edyn/parallel/job_dispatcher.hpp>
+#include <algorithm>
+
+static constexpr auto connected = edyn::entity_graph::disconnection_result::connected;
+static constexpr auto disconnected = edyn::entity_graph::disconnection_result::disconnected;
+static constexpr auto undetermined = edyn::entity_graph::disconnection_result::undetermined;
 
 TEST(entity_graph_test, test_connected_components) {
     auto registry = entt::registry();
@@ -63,3 +69,280 @@ TEST(entity_graph_test, test_connected_components) {
         ASSERT_EQ(edge_entity, edge_entity01_1);
     });
 }
+
+TEST(entity_graph_test, test_check_disconnection) {
+    auto registry = entt::registry();
+    auto graph = edyn::entity_graph();
+    graph.set_track_disconnections(true);
+
+    // A cycle of four nodes 0-1-2-3-0 with a double edge between 0 and 1 and
+    // a non-connecting node attached to 2 and 3.
+    std::vector<edyn::entity_graph::index_type> node_indices;
+
+    for (int i = 0; i < 4; ++i) {
+        node_indices.push_back(graph.insert_node(registry.create()));
+    }
+
+    auto non_connecting_index = graph.insert_node(registry.create(), true);
+    graph.insert_edge(registry.create(), node_indices[2], non_connecting_index);
+    graph.insert_edge(registry.create(), node_indices[3], non_connecting_index);
+
+    auto edge01_0 = graph.insert_edge(registry.create(), node_indices[0], node_indices[1]);
+    auto edge01_1 = graph.insert_edge(registry.create(), node_indices[0], node_indices[1]);
+    graph.insert_edge(registry.create(), node_indices[1], node_indices[2]);
+    auto edge23 = graph.insert_edge(registry.create(), node_indices[2], node_indices[3]);
+    graph.insert_edge(registry.create(), node_indices[3], node_indices[0]);
+
+    ASSERT_EQ(graph.check_disconnection(), connected);
+
+    // Another edge remains between 0 and 1.
+    graph.remove_edge(edge01_0);
+    ASSERT_EQ(graph.check_disconnection(), connected);
+
+    // Breaking the cycle keeps it connected.
+    graph.remove_edge(edge01_1);
+    ASSERT_EQ(graph.check_disconnection(), connected);
+
+    // Nodes are not connected through non-connecting nodes.
+    graph.remove_edge(edge23);
+    ASSERT_EQ(graph.check_disconnection(), disconnected);
+    ASSERT_FALSE(graph.is_single_connected_component());
+
+    // Reconnect and remove a node which joins the two halves.
+    graph.insert_edge(registry.create(), node_indices[2], node_indices[3]);
+    ASSERT_TRUE(graph.is_single_connected_component());
+
+    graph.remove_all_edges(node_indices[3]);
+    graph.remove_node(node_indices[3]);
+    ASSERT_EQ(graph.check_disconnection(), disconnected);
+    ASSERT_EQ(graph.connected_components().size(), 2);
+}
+
+TEST(entity_graph_test, test_check_disconnection_recycled_node) {
+    auto registry = entt::registry();
+    auto graph = edyn::entity_graph();
+    graph.set_track_disconnections(true);
+
+    auto node_index0 = graph.insert_node(registry.create());
+    auto node_index1 = graph.insert_node(registry.create());
+    auto node_index2 = graph.insert_node(registry.create());
+    graph.insert_edge(registry.create(), node_index0, node_index1);
+    graph.insert_edge(registry.create(), node_index1, node_index2);
+    auto edge_index = graph.insert_edge(registry.create(), node_index2, node_index0);
+
+    // Removing the edge records 2 and 0 as a candidate pair, but node 2 is
+    // removed and its index is taken by a new node without edges before the
+    // check. The new node must not be reported as disconnected.
+    graph.remove_edge(edge_index);
+    graph.remove_all_edges(node_index2);
+    graph.remove_node(node_index2);
+    ASSERT_EQ(graph.insert_node(registry.create()), node_index2);
+
+    ASSERT_EQ(graph.check_disconnection(), connected);
+}
+
+TEST(entity_graph_test, test_check_disconnection_budget) {
+    auto registry = entt::registry();
+    auto graph = edyn::entity_graph();
+    graph.set_track_disconnections(true);
+
+    // A long cycle of nodes with a single node hanging from it.
+    constexpr size_t num_nodes = 2000;
+    std::vector<edyn::entity_graph::index_type> node_indices;
+    std::vector<edyn::entity_graph::index_type> edge_indices;
+
+    for (size_t i = 0; i < num_nodes; ++i) {
+        node_indices.push_back(graph.insert_node(registry.create()));
+    }
+
+    for (size_t i = 0; i < num_nodes; ++i) {
+        auto next = (i + 1) % num_nodes;
+        edge_indices.push_back(graph.insert_edge(registry.create(), node_indices[i], node_indices[next]));
+    }
+
+    auto leaf_index = graph.insert_node(registry.create());
+    auto leaf_edge_index = graph.insert_edge(registry.create(), node_indices[0], leaf_index);
+
+    // Detaching the leaf is detected right away since the smaller side is
+    // exhausted first, even with a tiny budget.
+    graph.remove_edge(leaf_edge_index);
+    ASSERT_EQ(graph.check_disconnection(4), disconnected);
+
+    // Breaking the cycle leaves a long path between the nodes which were
+    // joined by the removed edge. It cannot be found within a small budget.
+    graph.remove_edge(edge_indices[0]);
+    ASSERT_EQ(graph.check_disconnection(100), undetermined);
+
+    // Candidates are discarded after each check.
+    ASSERT_EQ(graph.check_disconnection(100), connected);
+
+    // Close the cycle again and break it elsewhere. The long path is found
+    // with the default budget.
+    graph.insert_edge(registry.create(), node_indices[0], node_indices[1]);
+    graph.remove_edge(edge_indices[num_nodes / 2]);
+    ASSERT_EQ(graph.check_disconnection(), connected);
+}
+
+TEST(entity_graph_test, test_compact_connected_components) {
+    auto registry = entt::registry();
+    auto graph = edyn::entity_graph();
+
+    // Many chains which share a non-connecting node, enough to have the
+    // connected components calculated in parallel.
+    constexpr size_t num_chains = 64;
+    constexpr size_t chain_length = 320;
+    auto non_connecting_index = graph.insert_node(registry.create(), true);
+    std::vector<edyn::entity_graph::index_type> chain_ends;
+
+    for (size_t i = 0; i < num_chains; ++i) {
+        auto prev_index = graph.insert_node(registry.create());
+        graph.insert_edge(registry.create(), prev_index, non_connecting_index);
+
+        for (size_t j = 1; j < chain_length; ++j) {
+            auto node_index = graph.insert_node(registry.create());
+            graph.insert_edge(registry.create(), prev_index, node_index);
+            prev_index = node_index;
+        }
+
+        chain_ends.push_back(prev_index);
+    }
+
+    auto sort_components = [] (edyn::entity_graph::connected_components_t components) {
+        for (auto &component : components) {
+            std::sort(component.nodes.begin(), component.nodes.end());
+            std::sort(component.edges.begin(), component.edges.end());
+        }
+
+        std::sort(components.begin(), components.end(), [] (auto &a, auto &b) {
+            return a.nodes < b.nodes;
+        });
+
+        return components;
+    };
+
+    auto &dispatcher = edyn::job_dispatcher::global();
+    auto was_running = dispatcher.running();
+
+    if (was_running) {
+        dispatcher.stop();
+    }
+
+    auto expected = sort_components(graph.connected_components());
+    ASSERT_EQ(expected.size(), num_chains);
+
+    for (auto &component : expected) {
+        // The non-connecting node is present in all components.
+        ASSERT_EQ(component.nodes.size(), chain_length + 1);
+        ASSERT_EQ(component.edges.size(), chain_length);
+    }
+
+    graph.compact();
+    ASSERT_FALSE(graph.is_single_connected_component());
+
+    dispatcher.start();
+
+    auto compact_components = sort_components(graph.connected_components());
+    ASSERT_EQ(compact_components.size(), expected.size());
+
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(compact_components[i].nodes, expected[i].nodes);
+        ASSERT_EQ(compact_components[i].edges, expected[i].edges);
+    }
+
+    // Changing the graph discards the compact form.
+    graph.insert_edge(registry.create(), chain_ends[0], chain_ends[1]);
+    ASSERT_EQ(graph.connected_components().size(), num_chains - 1);
+
+    if (!was_running) {
+        dispatcher.stop();
+    }
+}
+
+TEST(entity_graph_test, test_reach_parallel) {
+    auto registry = entt::registry();
+    auto graph = edyn::entity_graph();
+
+    // Many chains which share a non-connecting node and are cut in parts by
+    // nodes that should not be visited. Enough nodes are reached for the
+    // connected components to be calculated in parallel.
+    constexpr size_t num_chains = 64;
+    constexpr size_t chain_length = 100;
+    auto non_connecting_index = graph.insert_node(registry.create(), true);
+    std::vector<edyn::entity_graph::index_type> start_indices;
+    std::vector<bool> blocked;
+
+    auto insert_node = [&] () {
+        auto node_index = graph.insert_node(registry.create());
+        blocked.resize(std::max(blocked.size(), node_index + 1), false);
+        blocked[node_index] = start_indices.size() % 40 == 20;
+        start_indices.push_back(node_index);
+        return node_index;
+    };
+
+    for (size_t i = 0; i < num_chains; ++i) {
+        auto prev_index = insert_node();
+        graph.insert_edge(registry.create(), prev_index, non_connecting_index);
+
+        for (size_t j = 1; j < chain_length; ++j) {
+            auto node_index = insert_node();
+            graph.insert_edge(registry.create(), prev_index, node_index);
+            prev_index = node_index;
+        }
+    }
+
+    std::reverse(start_indices.begin(), start_indices.end());
+
+    struct component {
+        std::vector<entt::entity> nodes;
+        std::vector<entt::entity> edges;
+    };
+
+    auto reach = [&] () {
+        auto components = std::vector<component>{};
+        auto current = component{};
+
+        graph.reach(
+            start_indices.begin(), start_indices.end(),
+            [&] (entt::entity entity) { current.nodes.push_back(entity); },
+            [&] (entt::entity entity) { current.edges.push_back(entity); },
+            [&] (edyn::entity_graph::index_type node_index) {
+                return node_index >= blocked.size() || !blocked[node_index];
+            },
+            [&] () {
+                std::sort(current.nodes.begin(), current.nodes.end());
+                std::sort(current.edges.begin(), current.edges.end());
+                components.push_back(std::move(current));
+                current = {};
+            });
+
+        return components;
+    };
+
+    auto &dispatcher = edyn::job_dispatcher::global();
+    auto was_running = dispatcher.running();
+
+    if (was_running) {
+        dispatcher.stop();
+    }
+
+    auto expected = reach();
+    // Each chain is cut in three parts.
+    ASSERT_EQ(expected.size(), num_chains * 3);
+
+    dispatcher.start();
+
+    auto components = reach();
+    ASSERT_EQ(components.size(), expected.size());
+
+    // Components are found in the same order and nodes and edges are visited
+    // once per component.
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(components[i].nodes, expected[i].nodes);
+        ASSERT_EQ(components[i].edges, expected[i].edges);
+        ASSERT_TRUE(std::adjacent_find(components[i].nodes.begin(), components[i].nodes.end()) == components[i].nodes.end());
+    }
+
+    if (!was_running) {
+        dispatcher.stop();
+    }
+}
@@ -0,0 +1,157 @@
+#include "../common/common.hpp"
+#include "edyn/util/aabb_util.hpp"
+
+// AABBs and manifolds are only sent from the island workers to the main
+// registry when they change significantly. Since operations are imported into
+// the main registry without emitting signals, these tests detect whether an
+// update was sent by looking at the values in the main registry.
+
+class island_worker_sync_test: public ::testing::Test {
+protected:
+    void SetUp() override {
+        edyn::init({2});
+        edyn::attach(registry);
+
+        auto floor_def = edyn::rigidbody_def();
+        floor_def.kind = edyn::rigidbody_kind::rb_static;
+        floor_def.shape = edyn::plane_shape{{0, 1, 0}, 0};
+        floor = edyn::make_rigidbody(registry, floor_def);
+    }
+
+    void TearDown() override {
+        edyn::detach(registry);
+        edyn::deinit();
+    }
+
+    void update() {
+        edyn::update(registry);
+        edyn::delay(10);
+    }
+
+    // Updates until the predicate is satisfied or the time runs out.
+    template<typename Predicate>
+    bool update_until(Predicate predicate) {
+        for (int i = 0; i < 300; ++i) {
+            update();
+
+            if (predicate()) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void set_linvel(entt::entity entity, edyn::vector3 v) {
+        registry.replace<edyn::linvel>(entity, v);
+        edyn::refresh<edyn::linvel>(registry, entity);
+    }
+
+    // The AABB in the main registry, inflated by the contact breaking
+    // threshold, must contain the AABB at the current transform.
+    void check_aabb_bound(entt::entity entity) {
+        auto &shape = registry.get<edyn::box_shape>(entity);
+        auto &pos = registry.get<edyn::position>(entity);
+        auto &orn = registry.get<edyn::orientation>(entity);
+        auto current = edyn::shape_aabb(shape, pos, orn);
+        auto offset = edyn::vector3_one * -(edyn::contact_breaking_threshold + edyn::scalar(0.001));
+        auto &aabb = registry.get<edyn::AABB>(entity);
+        ASSERT_TRUE(aabb.inset(offset).contains(current));
+    }
+
+    entt::registry registry;
+    entt::entity floor;
+};
+
+TEST_F(island_worker_sync_test, aabb) {
+    auto def = edyn::rigidbody_def();
+    def.position = {0, 0.5, 0};
+    def.shape = edyn::box_shape{0.5, 0.5, 0.5};
+    def.sleeping_disabled = true;
+    auto entity = edyn::make_rigidbody(registry, def);
+
+    ASSERT_TRUE(update_until([&] { return registry.all_of<edyn::island_resident>(entity); }));
+
+    // Let it settle on the floor.
+    for (int i = 0; i < 50; ++i) {
+        update();
+        check_aabb_bound(entity);
+    }
+
+    // A resting body doesn't send its AABB anymore, even though the island
+    // keeps being stepped because sleeping is disabled.
+    auto resting_aabb = registry.get<edyn::AABB>(entity);
+    auto resting_pos = registry.get<edyn::position>(entity);
+
+    for (int i = 0; i < 50; ++i) {
+        update();
+        check_aabb_bound(entity);
+        auto &aabb = registry.get<edyn::AABB>(entity);
+        ASSERT_EQ(aabb.min, resting_aabb.min);
+        ASSERT_EQ(aabb.max, resting_aabb.max);
+    }
+
+    // Make it slide along the floor. The AABB is sent once it leaves the
+    // inflated bound of the last one sent.
+    set_linvel(entity, {1, 0, 0});
+
+    ASSERT_TRUE(update_until([&] {
+        check_aabb_bound(entity);
+        return registry.get<edyn::position>(entity).x - resting_pos.x >
+               edyn::contact_breaking_threshold * 2;
+    }));
+
+    auto &aabb = registry.get<edyn::AABB>(entity);
+    ASSERT_GT(aabb.min.x, resting_aabb.min.x);
+}
+
+TEST_F(island_worker_sync_test, manifold) {
+    // Place a sphere slightly above the floor without gravity so that a
+    // manifold is created but without contact points.
+    auto def = edyn::rigidbody_def();
+    def.position = {0, edyn::scalar(0.5) + edyn::contact_breaking_threshold * edyn::scalar(0.75), 0};
+    def.shape = edyn::sphere_shape{0.5};
+    def.gravity = edyn::vector3_zero;
+    def.sleeping_disabled = true;
+    auto entity = edyn::make_rigidbody(registry, def);
+
+    ASSERT_TRUE(update_until([&] { return edyn::manifold_exists(registry, entity, floor); }));
+    auto manifold_entity = edyn::get_manifold_entity(registry, entity, floor);
+
+    // Let the worker send the manifold for the first time.
+    for (int i = 0; i < 20; ++i) {
+        update();
+    }
+
+    // An empty manifold is not sent anymore. Mark it in the main registry,
+    // which would be overwritten if it were.
+    constexpr auto sentinel = edyn::scalar(-1);
+    registry.get<edyn::contact_manifold>(manifold_entity).separation_threshold = sentinel;
+
+    for (int i = 0; i < 20; ++i) {
+        update();
+        auto &manifold = registry.get<edyn::contact_manifold>(manifold_entity);
+        ASSERT_EQ(manifold.num_points, 0);
+        ASSERT_EQ(manifold.separation_threshold, sentinel);
+    }
+
+    // Push it into the floor. The manifold is sent once it gains points.
+    set_linvel(entity, {0, -0.5, 0});
+
+    ASSERT_TRUE(update_until([&] {
+        return registry.get<edyn::contact_manifold>(manifold_entity).num_points > 0;
+    }));
+
+    ASSERT_NE(registry.get<edyn::contact_manifold>(manifold_entity).separation_threshold, sentinel);
+
+    // Slowly lift it so the contact points are removed before the manifold is
+    // destroyed. The manifold is sent once it loses its last point.
+    set_linvel(entity, {0, 0.05, 0});
+
+    ASSERT_TRUE(update_until([&] {
+        return !registry.valid(manifold_entity) ||
+               registry.get<edyn::contact_manifold>(manifold_entity).num_points == 0;
+    }));
+
+    ASSERT_TRUE(registry.valid(manifold_entity));
+}
@@ -2,6 +2,7 @@
 
 #include <array>
 #include <atomic>
+#include <thread>
 
 class job_dispatcher_test: public ::testing::Test {
 protected:
@@ -16,6 +17,10 @@ protected:
 public:
     edyn::job_dispatcher dispatcher;
     std::atomic<bool> done {false};
+    // Results of jobs which run in the background. Kept in the fixture so
+    // they outlive the jobs, which are finished when the dispatcher stops.
+    std::atomic<size_t> num_completed_jobs {0};
+    std::atomic<bool> all_succeeded {true};
 };
 
 TEST_F(job_dispatcher_test, parallel_for) {
@@ -126,7 +131,6 @@ TEST_F(job_dispatcher_test, parallel_for_async) {
     }
 }
 
-/*
 TEST_F(job_dispatcher_test, nested_parallel_for) {
     constexpr size_t rows = 2012;
     constexpr size_t columns = 2459;
@@ -151,4 +155,261 @@ TEST_F(job_dispatcher_test, nested_parallel_for) {
             ASSERT_EQ((*A)[i][j], 33 + 17);
         }
     }
-}*/
+}
+
+void nested_parallel_for_job(edyn::job::data_type &data) {
+    auto archive = edyn::memory_input_archive(data.data(), data.size());
+    intptr_t self_ptr;
+    archive(self_ptr);
+    auto self = reinterpret_cast<job_dispatcher_test *>(self_ptr);
+
+    // Parallel for called from a worker thread which must not block. Each
+    // inner iteration writes to its own slot.
+    constexpr size_t num_inner = 64;
+    std::vector<std::array<int, num_inner>> values(1000);
+
+    edyn::parallel_for(self->dispatcher, size_t{0}, values.size(), size_t{1}, [&] (size_t i) {
+        edyn::parallel_for(self->dispatcher, size_t{0}, num_inner, size_t{1}, [&] (size_t j) {
+            values[i][j] += 1;
+        });
+    });
+
+    auto success = true;
+
+    for (auto &inner_values : values) {
+        for (auto value : inner_values) {
+            success &= value == 1;
+        }
+    }
+
+    if (!success) {
+        self->all_succeeded.store(false, std::memory_order_relaxed);
+    }
+
+    self->num_completed_jobs.fetch_add(1, std::memory_order_release);
+}
+
+TEST_F(job_dispatcher_test, parallel_for_in_every_worker) {
+    // Run as many jobs as workers so that all of them end up waiting on a
+    // parallel for at the same time.
+    auto num_jobs = dispatcher.num_workers();
+
+    auto j = edyn::job();
+    auto archive = edyn::fixed_memory_output_archive(j.data.data(), j.data.size());
+    auto self_ptr = reinterpret_cast<intptr_t>(this);
+    archive(self_ptr);
+    j.func = &nested_parallel_for_job;
+
+    for (size_t i = 0; i < num_jobs; ++i) {
+        dispatcher.async(j);
+    }
+
+    // Stay under the test timeout.
+    for (size_t i = 0; i < 400 && num_completed_jobs.load(std::memory_order_acquire) < num_jobs; ++i) {
+        edyn::delay(10);
+    }
+
+    ASSERT_EQ(num_completed_jobs.load(std::memory_order_acquire), num_jobs);
+    ASSERT_TRUE(all_succeeded.load(std::memory_order_relaxed));
+}
+
+void count_job(edyn::job::data_type &data) {
+    auto archive = edyn::memory_input_archive(data.data(), data.size());
+    intptr_t counter_ptr;
+    archive(counter_ptr);
+    auto *counter = reinterpret_cast<std::atomic<size_t> *>(counter_ptr);
+    counter->fetch_add(1, std::memory_order_relaxed);
+}
+
+TEST_F(job_dispatcher_test, async_after) {
+    constexpr size_t num_jobs = 2000;
+    std::atomic<size_t> counter {0};
+
+    auto j = edyn::job();
+    auto archive = edyn::fixed_memory_output_archive(j.data.data(), j.data.size());
+    auto counter_ptr = reinterpret_cast<intptr_t>(&counter);
+    archive(counter_ptr);
+    j.func = &count_job;
+
+    // Schedule with delays out of order, many of them expiring together.
+    for (size_t i = 0; i < num_jobs; ++i) {
+        auto delay = 0.001 * static_cast<double>((i * 7919) % 50 + 1);
+        dispatcher.async_after(delay, j);
+    }
+
+    for (size_t i = 0; i < 1000 && counter.load(std::memory_order_relaxed) < num_jobs; ++i) {
+        edyn::delay(10);
+    }
+
+    ASSERT_EQ(counter.load(std::memory_order_relaxed), num_jobs);
+}
+
+TEST_F(job_dispatcher_test, async_with_affinity) {
+    ASSERT_EQ(dispatcher.current_worker_index(), edyn::job_dispatcher::invalid_worker_index);
+
+    constexpr size_t num_jobs_per_worker = 100;
+    std::atomic<size_t> counter {0};
+
+    auto j = edyn::job();
+    auto archive = edyn::fixed_memory_output_archive(j.data.data(), j.data.size());
+    auto counter_ptr = reinterpret_cast<intptr_t>(&counter);
+    archive(counter_ptr);
+    j.func = &count_job;
+
+    for (size_t i = 0; i < num_jobs_per_worker; ++i) {
+        for (size_t k = 0; k < dispatcher.num_workers(); ++k) {
+            dispatcher.async_with_affinity(j, k);
+        }
+
+        dispatcher.async_after(0.001, j, i % dispatcher.num_workers());
+    }
+
+    auto num_jobs = num_jobs_per_worker * (dispatcher.num_workers() + 1);
+
+    for (size_t i = 0; i < 1000 && counter.load(std::memory_order_relaxed) < num_jobs; ++i) {
+        edyn::delay(10);
+    }
+
+    ASSERT_EQ(counter.load(std::memory_order_relaxed), num_jobs);
+}
+
+struct priority_test_context {
+    std::atomic<bool> started {false};
+    std::atomic<bool> released {false};
+    std::atomic<size_t> count {0};
+    std::vector<uint32_t> order;
+};
+
+void blocking_job(edyn::job::data_type &data) {
+    auto archive = edyn::memory_input_archive(data.data(), data.size());
+    intptr_t ctx_ptr;
+    archive(ctx_ptr);
+    auto *ctx = reinterpret_cast<priority_test_context *>(ctx_ptr);
+    ctx->started.store(true, std::memory_order_release);
+
+    while (!ctx->released.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+void record_priority_job(edyn::job::data_type &data) {
+    auto archive = edyn::memory_input_archive(data.data(), data.size());
+    intptr_t ctx_ptr;
+    uint32_t priority;
+    archive(ctx_ptr);
+    archive(priority);
+    auto *ctx = reinterpret_cast<priority_test_context *>(ctx_ptr);
+    ctx->order.push_back(priority);
+    ctx->count.fetch_add(1, std::memory_order_release);
+}
+
+TEST(job_dispatcher_priority_test, higher_priority_first) {
+    // Use a single worker so jobs run sequentially.
+    edyn::job_dispatcher dispatcher;
+    dispatcher.start(1);
+
+    priority_test_context ctx;
+    auto ctx_ptr = reinterpret_cast<intptr_t>(&ctx);
+
+    auto blocking = edyn::job();
+    auto blocking_archive = edyn::fixed_memory_output_archive(blocking.data.data(), blocking.data.size());
+    blocking_archive(ctx_ptr);
+    blocking.func = &blocking_job;
+
+    // Keep the worker busy while the prioritized jobs are scheduled.
+    dispatcher.async(blocking);
+
+    while (!ctx.started.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    for (uint32_t priority : {2u, 7u, 1u, 7u, 5u}) {
+        auto j = edyn::job();
+        auto archive = edyn::fixed_memory_output_archive(j.data.data(), j.data.size());
+        archive(ctx_ptr);
+        archive(priority);
+        j.func = &record_priority_job;
+        dispatcher.async_with_affinity(j, 0, priority);
+    }
+
+    ctx.released.store(true, std::memory_order_release);
+
+    for (size_t i = 0; i < 1000 && ctx.count.load(std::memory_order_acquire) < 5; ++i) {
+        edyn::delay(1);
+    }
+
+    dispatcher.stop();
+
+    ASSERT_EQ(ctx.count.load(std::memory_order_acquire), 5);
+
+    ASSERT_EQ(ctx.order, (std::vector<uint32_t>{7, 7, 5, 2, 1}));
+}
+
+struct drain_test_context {
+    std::atomic<bool> started {false};
+    std::atomic<bool> released {false};
+    std::atomic<size_t> count {0};
+};
+
+static void drain_blocking_job(edyn::job::data_type &data) {
+    auto archive = edyn::memory_input_archive(data.data(), data.size());
+    intptr_t ctx_ptr;
+    archive(ctx_ptr);
+    auto *ctx = reinterpret_cast<drain_test_context *>(ctx_ptr);
+    ctx->started.store(true, std::memory_order_release);
+
+    while (!ctx->released.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+static void drain_count_job(edyn::job::data_type &data) {
+    auto archive = edyn::memory_input_archive(data.data(), data.size());
+    intptr_t ctx_ptr;
+    archive(ctx_ptr);
+    auto *ctx = reinterpret_cast<drain_test_context *>(ctx_ptr);
+    ctx->count.fetch_add(1, std::memory_order_relaxed);
+}
+
+TEST(job_dispatcher_stop_test, runs_pending_jobs) {
+    edyn::job_dispatcher dispatcher;
+    dispatcher.start(1);
+
+    drain_test_context ctx;
+    auto ctx_ptr = reinterpret_cast<intptr_t>(&ctx);
+
+    auto blocking = edyn::job();
+    auto blocking_archive = edyn::fixed_memory_output_archive(blocking.data.data(), blocking.data.size());
+    blocking_archive(ctx_ptr);
+    blocking.func = &drain_blocking_job;
+
+    // Keep the only worker busy so the other jobs are still pending when
+    // the dispatcher is stopped.
+    dispatcher.async(blocking);
+
+    while (!ctx.started.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    constexpr size_t num_jobs = 100;
+
+    for (size_t i = 0; i < num_jobs; ++i) {
+        auto j = edyn::job();
+        auto archive = edyn::fixed_memory_output_archive(j.data.data(), j.data.size());
+        archive(ctx_ptr);
+        j.func = &drain_count_job;
+        dispatcher.async(j);
+    }
+
+    // Release the worker from another thread since `stop` blocks until it
+    // finishes.
+    auto releaser = std::thread([&] {
+        edyn::delay(10);
+        ctx.released.store(true, std::memory_order_release);
+    });
+
+    dispatcher.stop();
+    releaser.join();
+
+    ASSERT_EQ(ctx.count.load(std::memory_order_relaxed), num_jobs);
+}
@@ -1,12 +1,16 @@
 #include "../common/common.hpp"
 
+#include <thread>
+
 class message_queue_test: public ::testing::Test {
 public:
     void on_int(int i) {
         m_value = i;
+        m_received.push_back(i);
     }
 
     int m_value;
+    std::vector<int> m_received;
 
     std::unique_ptr<edyn::message_queue_input> m_input;
     std::unique_ptr<edyn::message_queue_output> m_output;
@@ -30,4 +34,28 @@ TEST_F(message_queue_test, write_read_messages) {
     ASSERT_NE(m_value, 667);
     m_output->update();
     ASSERT_EQ(m_value, 667);
-}
\ No newline at end of file
+}
+
+TEST_F(message_queue_test, messages_from_another_thread) {
+    // Send enough messages to span many blocks of the underlying queue.
+    constexpr int num_messages = 100000;
+
+    auto producer = std::thread([&] {
+        for (int i = 0; i < num_messages; ++i) {
+            m_input->send<int>(i);
+        }
+    });
+
+    while (m_received.size() < num_messages) {
+        m_output->update();
+    }
+
+    producer.join();
+    m_output->update();
+
+    ASSERT_EQ(m_received.size(), num_messages);
+
+    for (int i = 0; i < num_messages; ++i) {
+        ASSERT_EQ(m_received[i], i);
+    }
+}
@@ -0,0 +1,94 @@
+#include "../common/common.hpp"
+
+#include <atomic>
+#include <thread>
+
+static void write_job_value(edyn::job &j, size_t value) {
+    auto archive = edyn::fixed_memory_output_archive(j.data.data(), j.data.size());
+    archive(value);
+}
+
+static size_t read_job_value(edyn::job &j) {
+    auto archive = edyn::memory_input_archive(j.data.data(), j.data.size());
+    size_t value;
+    archive(value);
+    return value;
+}
+
+TEST(work_stealing_deque, owner_lifo) {
+    auto deque = edyn::work_stealing_deque(2);
+
+    // Push more than the initial capacity to force growth.
+    for (size_t i = 0; i < 10; ++i) {
+        auto j = edyn::job();
+        write_job_value(j, i);
+        deque.push(j);
+    }
+
+    ASSERT_EQ(deque.size(), 10);
+
+    auto j = edyn::job();
+    ASSERT_TRUE(deque.steal(j));
+    ASSERT_EQ(read_job_value(j), 0);
+
+    for (size_t i = 9; i > 0; --i) {
+        ASSERT_TRUE(deque.pop(j));
+        ASSERT_EQ(read_job_value(j), i);
+    }
+
+    ASSERT_FALSE(deque.pop(j));
+    ASSERT_FALSE(deque.steal(j));
+    ASSERT_TRUE(deque.empty());
+}
+
+TEST(work_stealing_deque, concurrent_steal) {
+    constexpr size_t num_jobs = 200000;
+    constexpr size_t num_thieves = 3;
+    auto deque = edyn::work_stealing_deque(16);
+    auto taken = std::vector<std::atomic<int>>(num_jobs);
+    std::atomic<bool> done {false};
+
+    auto take = [&] (edyn::job &j) {
+        taken[read_job_value(j)].fetch_add(1, std::memory_order_relaxed);
+    };
+
+    std::vector<std::thread> thieves;
+
+    for (size_t i = 0; i < num_thieves; ++i) {
+        thieves.emplace_back([&] {
+            auto j = edyn::job();
+
+            while (!done.load(std::memory_order_relaxed) || !deque.empty()) {
+                if (deque.steal(j)) {
+                    take(j);
+                }
+            }
+        });
+    }
+
+    // Owner pushes and occasionally pops.
+    auto j = edyn::job();
+
+    for (size_t i = 0; i < num_jobs; ++i) {
+        write_job_value(j, i);
+        deque.push(j);
+
+        if (i % 3 == 0 && deque.pop(j)) {
+            take(j);
+        }
+    }
+
+    while (deque.pop(j)) {
+        take(j);
+    }
+
+    done.store(true, std::memory_order_relaxed);
+
+    for (auto &t : thieves) {
+        t.join();
+    }
+
+    for (auto &count : taken) {
+        ASSERT_EQ(count.load(), 1);
+    }
+}
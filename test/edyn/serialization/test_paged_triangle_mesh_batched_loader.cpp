@@ -0,0 +1,96 @@
+#include "../common/common.hpp"
+
+TEST(paged_triangle_mesh_batched_loader, test) {
+    edyn::init({2});
+
+    std::vector<edyn::vector3> vertices;
+    std::vector<edyn::triangle_mesh::index_type> indices;
+    edyn::make_plane_mesh(20, 20, 16, 16, vertices, indices);
+
+    for (auto &v : vertices) {
+        v.y = std::sin(v.x) * std::cos(v.z);
+    }
+
+    auto filename = "paged_trimesh_batched.bin";
+    auto output_loader = std::make_shared<edyn::paged_triangle_mesh_file_input_archive>();
+    auto paged_trimesh = edyn::paged_triangle_mesh(output_loader);
+    edyn::create_paged_triangle_mesh(paged_trimesh, vertices.begin(), vertices.end(),
+                                     indices.begin(), indices.end(), 32, {});
+
+    {
+        auto output = edyn::paged_triangle_mesh_file_output_archive(
+            filename, edyn::paged_triangle_mesh_serialization_mode::embedded);
+        edyn::serialize(output, paged_trimesh);
+    }
+
+    // Allow a few submeshes in flight so requests have to wait in the queue.
+    auto loader = std::make_shared<edyn::paged_triangle_mesh_batched_loader>(4);
+    ASSERT_TRUE(loader->open(filename));
+
+    auto input_paged_trimesh = edyn::paged_triangle_mesh(loader);
+    edyn::serialize(*loader, input_paged_trimesh);
+
+    ASSERT_EQ(input_paged_trimesh.num_submeshes(), paged_trimesh.num_submeshes());
+    ASSERT_EQ(input_paged_trimesh.cache_num_vertices(), 0);
+
+    // Request all submeshes and wait for them to be loaded in the background.
+    input_paged_trimesh.visit_triangles(input_paged_trimesh.get_aabb(), [] (auto, auto) {});
+
+    for (size_t i = 0; i < 500 && loader->num_loaded() < paged_trimesh.num_submeshes(); ++i) {
+        edyn::delay(10);
+    }
+
+    ASSERT_EQ(loader->num_loaded(), paged_trimesh.num_submeshes());
+
+    auto histogram = loader->get_latency_histogram();
+    ASSERT_EQ(histogram.total_count(), loader->num_loaded());
+    ASSERT_GT(histogram.percentile_us(0.99), 0);
+
+    for (size_t i = 0; i < paged_trimesh.num_submeshes(); ++i) {
+        auto submesh = paged_trimesh.get_submesh(i);
+        auto input_submesh = input_paged_trimesh.get_submesh(i);
+        ASSERT_TRUE(input_submesh);
+        ASSERT_EQ(input_submesh->num_vertices(), submesh->num_vertices());
+        ASSERT_EQ(input_submesh->num_triangles(), submesh->num_triangles());
+
+        for (size_t j = 0; j < submesh->num_vertices(); ++j) {
+            ASSERT_VECTOR3_EQ(input_submesh->get_vertex_position(j), submesh->get_vertex_position(j));
+        }
+
+        for (size_t j = 0; j < submesh->num_edges(); ++j) {
+            ASSERT_EQ(input_submesh->is_convex_edge(j), submesh->is_convex_edge(j));
+        }
+    }
+
+    loader->close();
+    ASSERT_FALSE(loader->is_open());
+
+    // Request every submesh twice at once. Submeshes are adjacent in the file
+    // thus reads are merged and duplicates are dropped.
+    auto num_submeshes = paged_trimesh.num_submeshes();
+    std::vector<size_t> requests;
+
+    for (size_t i = 0; i < num_submeshes; ++i) {
+        requests.push_back(i);
+        requests.push_back(i);
+    }
+
+    auto batch_loader = std::make_shared<edyn::paged_triangle_mesh_batched_loader>(requests.size());
+    ASSERT_TRUE(batch_loader->open(filename));
+
+    auto batch_paged_trimesh = edyn::paged_triangle_mesh(batch_loader);
+    edyn::serialize(*batch_loader, batch_paged_trimesh);
+    batch_loader->load(requests);
+
+    for (size_t i = 0; i < 500 && batch_loader->num_loaded() < num_submeshes; ++i) {
+        edyn::delay(10);
+    }
+
+    batch_loader->close();
+
+    ASSERT_EQ(batch_loader->num_loaded(), num_submeshes);
+    ASSERT_EQ(batch_loader->get_latency_histogram().total_count(), num_submeshes);
+    ASSERT_LT(batch_loader->num_reads(), num_submeshes);
+
+    edyn::deinit();
+}
@@ -0,0 +1,144 @@
+#include "../common/common.hpp"
+
+TEST(paged_triangle_mesh_mapped_serialization, test) {
+    edyn::init({2});
+
+    std::vector<edyn::vector3> vertices;
+    std::vector<edyn::triangle_mesh::index_type> indices;
+    edyn::make_plane_mesh(20, 20, 16, 16, vertices, indices);
+
+    for (auto &v : vertices) {
+        v.y = std::sin(v.x) * std::cos(v.z);
+    }
+
+    auto output_loader = std::make_shared<edyn::paged_triangle_mesh_mapped_loader>();
+    auto paged_trimesh = edyn::paged_triangle_mesh(output_loader);
+    edyn::create_paged_triangle_mesh(paged_trimesh, vertices.begin(), vertices.end(),
+                                     indices.begin(), indices.end(), 32, {});
+
+    auto filename = "paged_trimesh_mapped.bin";
+    ASSERT_TRUE(edyn::write_paged_triangle_mesh_mapped(filename, paged_trimesh));
+
+    auto loader = std::make_shared<edyn::paged_triangle_mesh_mapped_loader>();
+    ASSERT_TRUE(loader->open(filename));
+
+    auto input_paged_trimesh = edyn::paged_triangle_mesh(loader);
+    edyn::serialize(*loader, input_paged_trimesh);
+
+    ASSERT_EQ(input_paged_trimesh.num_submeshes(), paged_trimesh.num_submeshes());
+    ASSERT_EQ(input_paged_trimesh.cache_num_vertices(), 0);
+    ASSERT_VECTOR3_EQ(input_paged_trimesh.get_aabb().min, paged_trimesh.get_aabb().min);
+    ASSERT_VECTOR3_EQ(input_paged_trimesh.get_aabb().max, paged_trimesh.get_aabb().max);
+
+    // Submeshes are loaded synchronously thus the first query already visits
+    // all triangles.
+    size_t num_visited = 0;
+
+    input_paged_trimesh.visit_triangles(input_paged_trimesh.get_aabb(), [&] (auto mesh_idx, auto tri_idx) {
+        auto input_vertices = input_paged_trimesh.get_triangle_vertices(mesh_idx, tri_idx);
+        auto vertices = paged_trimesh.get_triangle_vertices(mesh_idx, tri_idx);
+
+        for (size_t i = 0; i < 3; ++i) {
+            ASSERT_VECTOR3_EQ(input_vertices[i], vertices[i]);
+        }
+
+        ++num_visited;
+    });
+
+    size_t num_triangles = 0;
+
+    for (size_t i = 0; i < paged_trimesh.num_submeshes(); ++i) {
+        auto submesh = paged_trimesh.get_submesh(i);
+        auto input_submesh = input_paged_trimesh.get_submesh(i);
+        ASSERT_TRUE(input_submesh);
+        ASSERT_EQ(input_submesh->num_edges(), submesh->num_edges());
+
+        for (size_t j = 0; j < submesh->num_edges(); ++j) {
+            ASSERT_EQ(input_submesh->is_convex_edge(j), submesh->is_convex_edge(j));
+            ASSERT_EQ(input_submesh->is_boundary_edge(j), submesh->is_boundary_edge(j));
+        }
+
+        for (size_t j = 0; j < submesh->num_triangles(); ++j) {
+            for (size_t k = 0; k < 3; ++k) {
+                ASSERT_VECTOR3_EQ(input_submesh->get_adjacent_face_normal(j, k),
+                                  submesh->get_adjacent_face_normal(j, k));
+            }
+        }
+
+        num_triangles += submesh->num_triangles();
+    }
+
+    ASSERT_EQ(num_visited, num_triangles);
+
+    edyn::deinit();
+}
+
+TEST(paged_triangle_mesh_mapped_serialization, reject_invalid) {
+    auto filename = "paged_trimesh_invalid.bin";
+
+    {
+        auto output = edyn::file_output_archive(filename);
+        uint64_t garbage = 0xdeadbeef;
+        output(garbage, garbage, garbage, garbage, garbage, garbage);
+    }
+
+    auto loader = edyn::paged_triangle_mesh_mapped_loader();
+    ASSERT_FALSE(loader.open(filename));
+    ASSERT_FALSE(loader.is_open());
+    ASSERT_FALSE(loader.open("file_that_does_not_exist.bin"));
+}
+
+TEST(paged_triangle_mesh_mapped_serialization, zero_copy) {
+    edyn::init({2});
+
+    std::vector<edyn::vector3> vertices;
+    std::vector<edyn::triangle_mesh::index_type> indices;
+    edyn::make_plane_mesh(10, 10, 8, 8, vertices, indices);
+
+    auto output_loader = std::make_shared<edyn::paged_triangle_mesh_mapped_loader>();
+    auto paged_trimesh = edyn::paged_triangle_mesh(output_loader);
+    edyn::create_paged_triangle_mesh(paged_trimesh, vertices.begin(), vertices.end(),
+                                     indices.begin(), indices.end(), 16, {});
+
+    auto filename = "paged_trimesh_zero_copy.bin";
+    ASSERT_TRUE(edyn::write_paged_triangle_mesh_mapped(filename, paged_trimesh));
+
+    auto loader = std::make_shared<edyn::paged_triangle_mesh_mapped_loader>();
+    ASSERT_TRUE(loader->open(filename));
+
+    auto input_paged_trimesh = edyn::paged_triangle_mesh(loader);
+    edyn::serialize(*loader, input_paged_trimesh);
+    input_paged_trimesh.visit_triangles(input_paged_trimesh.get_aabb(), [] (auto, auto) {});
+
+    auto *mapping_begin = loader->mapped_data();
+    auto *mapping_end = mapping_begin + loader->mapped_size();
+
+    auto points_into_mapping = [&] (const void *ptr) {
+        auto *bytes = static_cast<const uint8_t *>(ptr);
+        return bytes >= mapping_begin && bytes < mapping_end;
+    };
+
+    auto submeshes = std::vector<std::shared_ptr<edyn::triangle_mesh>>{};
+
+    for (size_t i = 0; i < input_paged_trimesh.num_submeshes(); ++i) {
+        auto submesh = input_paged_trimesh.get_submesh(i);
+        ASSERT_TRUE(submesh);
+        ASSERT_TRUE(submesh->is_mapped());
+        ASSERT_TRUE(points_into_mapping(submesh->get_vertex_data()));
+        ASSERT_TRUE(points_into_mapping(submesh->get_index_data()));
+        submeshes.push_back(submesh);
+    }
+
+    // Loaded submeshes keep the file mapped.
+    loader->close();
+
+    for (size_t i = 0; i < submeshes.size(); ++i) {
+        auto submesh = paged_trimesh.get_submesh(i);
+
+        for (size_t j = 0; j < submesh->num_vertices(); ++j) {
+            ASSERT_VECTOR3_EQ(submeshes[i]->get_vertex_position(j), submesh->get_vertex_position(j));
+        }
+    }
+
+    edyn::deinit();
+}
@@ -69,3 +69,77 @@ TEST(triangle_mesh_serialization, test) {
         ASSERT_EQ(trimesh.is_convex_edge(i), input_trimesh.is_convex_edge(i));
     }
 }
+
+TEST(triangle_mesh_serialization, compressed) {
+    std::vector<edyn::vector3> vertices;
+    std::vector<edyn::triangle_mesh::index_type> indices;
+    edyn::make_plane_mesh(10, 10, 8, 8, vertices, indices);
+
+    for (auto &v : vertices) {
+        v.y = v.x * v.z * edyn::scalar(0.05);
+    }
+
+    auto trimesh = edyn::triangle_mesh();
+    trimesh.insert_vertices(vertices.begin(), vertices.end());
+    trimesh.insert_indices(indices.begin(), indices.end());
+    trimesh.initialize();
+    trimesh.compress();
+
+    auto filename = "trimesh_compressed.bin";
+
+    {
+        auto output = edyn::file_output_archive(filename);
+        edyn::serialize(output, trimesh);
+    }
+
+    auto input_trimesh = edyn::triangle_mesh();
+
+    {
+        auto input = edyn::file_input_archive(filename);
+        edyn::serialize(input, input_trimesh);
+    }
+
+    ASSERT_TRUE(input_trimesh.is_compressed());
+    ASSERT_EQ(trimesh.num_vertices(), input_trimesh.num_vertices());
+
+    for (size_t i = 0; i < trimesh.num_vertices(); ++i) {
+        ASSERT_VECTOR3_EQ(trimesh.get_vertex_position(i), input_trimesh.get_vertex_position(i));
+    }
+
+    for (size_t i = 0; i < trimesh.num_triangles(); ++i) {
+        ASSERT_VECTOR3_EQ(trimesh.get_triangle_normal(i), input_trimesh.get_triangle_normal(i));
+    }
+}
+
+TEST(triangle_mesh_serialization, legacy) {
+    std::vector<edyn::vector3> vertices;
+    std::vector<edyn::triangle_mesh::index_type> indices;
+    edyn::make_plane_mesh(4, 4, 3, 3, vertices, indices);
+
+    auto trimesh = edyn::triangle_mesh();
+    trimesh.insert_vertices(vertices.begin(), vertices.end());
+    trimesh.insert_indices(indices.begin(), indices.end());
+    trimesh.initialize();
+
+    auto data = edyn::memory_output_archive::buffer_type{};
+    auto output = edyn::memory_output_archive(data);
+    edyn::serialize(output, trimesh);
+    ASSERT_EQ(data.size(), edyn::serialization_sizeof(trimesh));
+
+    // Meshes written before versioning have no marker and version at the
+    // start and no compression flag at the end.
+    auto header_size = 2 * sizeof(uint16_t);
+    auto legacy_data = std::vector<uint8_t>(data.begin() + header_size, data.end() - sizeof(bool));
+
+    auto input_trimesh = edyn::triangle_mesh();
+    auto input = edyn::memory_input_archive(legacy_data.data(), legacy_data.size());
+    edyn::serialize(input, input_trimesh);
+    ASSERT_FALSE(input.failed());
+    ASSERT_FALSE(input_trimesh.is_compressed());
+    ASSERT_EQ(input_trimesh.num_vertices(), trimesh.num_vertices());
+    ASSERT_EQ(input_trimesh.num_triangles(), trimesh.num_triangles());
+
+    for (size_t i = 0; i < trimesh.num_vertices(); ++i) {
+        ASSERT_VECTOR3_EQ(trimesh.get_vertex_position(i), input_trimesh.get_vertex_position(i));
+    }
+}
@@ -0,0 +1,122 @@
+#include "../common/common.hpp"
+#include "edyn/collision/collide.hpp"
+
+static edyn::heightfield make_heightfield() {
+    constexpr size_t num_columns = 6;
+    constexpr size_t num_rows = 5;
+    auto heights = std::vector<edyn::scalar>{};
+
+    for (size_t row = 0; row < num_rows; ++row) {
+        for (size_t col = 0; col < num_columns; ++col) {
+            heights.push_back(std::sin(edyn::scalar(col)) * std::cos(edyn::scalar(row) * edyn::scalar(0.7)));
+        }
+    }
+
+    return {num_columns, num_rows, {1, 2}, {-3, 1, -4}, heights};
+}
+
+TEST(test_heightfield, matches_triangle_mesh) {
+    auto field = make_heightfield();
+
+    // Build equivalent triangle mesh.
+    auto vertices = std::vector<edyn::vector3>{};
+    auto indices = std::vector<uint32_t>{};
+
+    for (size_t i = 0; i < field.num_vertices(); ++i) {
+        vertices.push_back(field.get_vertex_position(i));
+    }
+
+    for (size_t i = 0; i < field.num_triangles(); ++i) {
+        auto tri_indices = field.get_triangle_vertex_indices(i);
+        indices.insert(indices.end(), tri_indices.begin(), tri_indices.end());
+    }
+
+    auto trimesh = edyn::triangle_mesh{};
+    trimesh.insert_vertices(vertices.begin(), vertices.end());
+    trimesh.insert_indices(indices.begin(), indices.end());
+    trimesh.initialize();
+
+    ASSERT_EQ(field.num_triangles(), trimesh.num_triangles());
+    ASSERT_EQ(field.num_edges(), trimesh.num_edges());
+    ASSERT_VECTOR3_EQ(field.get_aabb().min, trimesh.get_aabb().min);
+    ASSERT_VECTOR3_EQ(field.get_aabb().max, trimesh.get_aabb().max);
+
+    for (size_t tri_idx = 0; tri_idx < field.num_triangles(); ++tri_idx) {
+        ASSERT_GT(field.get_triangle_normal(tri_idx).y, 0);
+        ASSERT_VECTOR3_EQ(field.get_triangle_normal(tri_idx), trimesh.get_triangle_normal(tri_idx));
+
+        for (size_t i = 0; i < 3; ++i) {
+            auto field_edge_idx = field.get_face_edge_index(tri_idx, i);
+            auto mesh_edge_idx = trimesh.get_face_edge_index(tri_idx, i);
+            auto field_edge = field.get_edge_vertex_indices(field_edge_idx);
+            auto mesh_edge = trimesh.get_edge_vertex_indices(mesh_edge_idx);
+            ASSERT_EQ(std::min(field_edge[0], field_edge[1]), std::min(mesh_edge[0], mesh_edge[1]));
+            ASSERT_EQ(std::max(field_edge[0], field_edge[1]), std::max(mesh_edge[0], mesh_edge[1]));
+
+            ASSERT_EQ(field.is_boundary_edge(field_edge_idx), trimesh.is_boundary_edge(mesh_edge_idx));
+            ASSERT_EQ(field.is_convex_edge(field_edge_idx), trimesh.is_convex_edge(mesh_edge_idx));
+            ASSERT_VECTOR3_EQ(field.get_adjacent_face_normal(tri_idx, i),
+                              trimesh.get_adjacent_face_normal(tri_idx, i));
+        }
+    }
+
+    // Visiting must find the same triangles as the tree.
+    auto aabb = edyn::AABB{{-1.2, -2, -1.5}, {0.4, 2, 3.1}};
+    auto field_tris = std::vector<size_t>{};
+    auto mesh_tris = std::vector<size_t>{};
+    field.visit_triangles(aabb, [&] (auto tri_idx) { field_tris.push_back(tri_idx); });
+    trimesh.visit_triangles(aabb, [&] (auto tri_idx) { mesh_tris.push_back(tri_idx); });
+    std::sort(mesh_tris.begin(), mesh_tris.end());
+    ASSERT_FALSE(field_tris.empty());
+    ASSERT_EQ(field_tris, mesh_tris);
+}
+
+TEST(test_heightfield, raycast) {
+    auto field = make_heightfield();
+    auto shape = edyn::heightfield_shape{std::make_shared<edyn::heightfield>(field)};
+
+    // Vertical ray over a sample.
+    auto sample = field.get_vertex_position(2 * field.num_columns() + 3);
+    auto ctx = edyn::raycast_context{edyn::vector3_zero, edyn::quaternion_identity,
+                                     sample + edyn::vector3{0, 5, 0}, sample - edyn::vector3{0, 5, 0}};
+    auto result = edyn::shape_raycast(shape, ctx);
+    ASSERT_LT(result.fraction, 1);
+    ASSERT_VECTOR3_EQ(edyn::lerp(ctx.p0, ctx.p1, result.fraction), sample);
+
+    // Diagonal ray crossing many cells.
+    ctx.p0 = edyn::vector3{-4, 3, -5};
+    ctx.p1 = edyn::vector3{4, -3, 6};
+    result = edyn::shape_raycast(shape, ctx);
+    ASSERT_LT(result.fraction, 1);
+    auto &info = std::get<edyn::heightfield_raycast_info>(result.info_var);
+    auto point = edyn::lerp(ctx.p0, ctx.p1, result.fraction);
+    auto vertices = field.get_triangle_vertices(info.triangle_index);
+    ASSERT_NEAR(edyn::dot(point - vertices[0], result.normal), 0, 0.001);
+
+    // Ray outside.
+    ctx.p0 = edyn::vector3{-10, 3, -5};
+    ctx.p1 = edyn::vector3{-10, -3, -5};
+    result = edyn::shape_raycast(shape, ctx);
+    ASSERT_EQ(result.fraction, EDYN_SCALAR_MAX);
+}
+
+TEST(test_heightfield, collide_sphere) {
+    auto heights = std::vector<edyn::scalar>(4 * 4, 0);
+    auto field = edyn::heightfield{4, 4, {1, 1}, edyn::vector3_zero, heights};
+    auto sphere = edyn::sphere_shape{0.5};
+    auto pos = edyn::vector3{1.3, 0.49, 1.6};
+
+    auto ctx = edyn::collision_context{};
+    ctx.posA = pos;
+    ctx.ornA = edyn::quaternion_identity;
+    ctx.aabbA = edyn::shape_aabb(sphere, pos, ctx.ornA);
+    ctx.threshold = edyn::contact_breaking_threshold;
+
+    auto result = edyn::collision_result{};
+    edyn::collide(sphere, field, ctx, result);
+
+    ASSERT_EQ(result.num_points, 1);
+    ASSERT_VECTOR3_EQ(result.point[0].normal, edyn::vector3_y);
+    ASSERT_NEAR(result.point[0].distance, -0.01, 0.0001);
+    ASSERT_VECTOR3_EQ(result.point[0].pivotB, {1.3, 0, 1.6});
+}
@@ -51,3 +51,269 @@ TEST(test_paged_trimesh, voronoi_regions) {
 
 	edyn::deinit();
 }
+
+class recording_page_loader: public edyn::triangle_mesh_page_loader_base {
+public:
+    void load(size_t index) override {
+        loaded.push_back(index);
+    }
+
+    virtual entt::sink<entt::sigh<loaded_mesh_func_t>> on_load_sink() override {
+        return {m_loaded_signal};
+    }
+
+    std::vector<size_t> loaded;
+
+private:
+    entt::sigh<loaded_mesh_func_t> m_loaded_signal;
+};
+
+TEST(test_paged_trimesh, prefetch) {
+    edyn::init({2});
+
+    std::vector<edyn::vector3> vertices;
+    std::vector<edyn::triangle_mesh::index_type> indices;
+
+    // Long strip along the x axis.
+    const auto num_columns = 32;
+
+    for (auto i = 0; i < num_columns; ++i) {
+        vertices.push_back({edyn::scalar(i), 0, 0});
+        vertices.push_back({edyn::scalar(i), 0, 1});
+    }
+
+    for (edyn::triangle_mesh::index_type i = 0; i < num_columns - 1; ++i) {
+        indices.insert(indices.end(), {i * 2, i * 2 + 1, i * 2 + 3});
+        indices.insert(indices.end(), {i * 2, i * 2 + 3, i * 2 + 2});
+    }
+
+    auto loader = std::make_shared<recording_page_loader>();
+    auto trimesh = edyn::paged_triangle_mesh(loader);
+    edyn::create_paged_triangle_mesh(trimesh, vertices.begin(), vertices.end(), indices.begin(), indices.end(), 4, {});
+    trimesh.clear_cache();
+    trimesh.reset_stats();
+
+    auto aabb = edyn::AABB{{0.1, -0.1, 0.1}, {0.9, 0.1, 0.9}};
+
+    // Stationary prefetch only touches submeshes near the AABB.
+    trimesh.prefetch(aabb, edyn::vector3_zero, 1);
+    auto num_stationary = loader->loaded.size();
+    ASSERT_GT(num_stationary, 0);
+
+    // Moving along the strip should request submeshes further ahead.
+    trimesh.prefetch(aabb, {20, 0, 0}, 1);
+    ASSERT_GT(loader->loaded.size(), num_stationary);
+    ASSERT_EQ(trimesh.get_stats().prefetches, loader->loaded.size());
+
+    // Submeshes already being loaded are not requested again.
+    auto num_requested = loader->loaded.size();
+    trimesh.prefetch(aabb, {20, 0, 0}, 1);
+    ASSERT_EQ(loader->loaded.size(), num_requested);
+
+    // Submeshes still loading are counted as misses. Once assigned, hits.
+    trimesh.visit_triangles(aabb, [] (auto, auto) {});
+    auto stats = trimesh.get_stats();
+    ASSERT_GT(stats.misses, 0);
+    ASSERT_EQ(stats.hits, 0);
+
+    for (auto idx : loader->loaded) {
+        trimesh.assign_mesh(idx, std::make_shared<edyn::triangle_mesh>());
+    }
+
+    trimesh.visit_submeshes(aabb, [] (auto) {});
+    ASSERT_GT(trimesh.get_stats().hits, 0);
+    ASSERT_EQ(trimesh.get_stats().misses, stats.misses);
+
+    edyn::deinit();
+}
+
+TEST(test_paged_trimesh, cache_budget) {
+    edyn::init({2});
+
+    std::vector<edyn::vector3> vertices;
+    std::vector<edyn::triangle_mesh::index_type> indices;
+    const auto num_columns = 16;
+
+    for (auto i = 0; i < num_columns; ++i) {
+        vertices.push_back({edyn::scalar(i), 0, 0});
+        vertices.push_back({edyn::scalar(i), 0, 1});
+    }
+
+    for (edyn::triangle_mesh::index_type i = 0; i < num_columns - 1; ++i) {
+        indices.insert(indices.end(), {i * 2, i * 2 + 1, i * 2 + 3});
+        indices.insert(indices.end(), {i * 2, i * 2 + 3, i * 2 + 2});
+    }
+
+    auto loader = std::make_shared<recording_page_loader>();
+    auto trimesh = edyn::paged_triangle_mesh(loader);
+    edyn::create_paged_triangle_mesh(trimesh, vertices.begin(), vertices.end(), indices.begin(), indices.end(), 4, {});
+    ASSERT_GT(trimesh.num_submeshes(), 2);
+    ASSERT_GT(trimesh.cache_num_bytes(), 0);
+
+    std::vector<std::shared_ptr<edyn::triangle_mesh>> submeshes;
+    size_t total_bytes = 0;
+
+    for (size_t i = 0; i < 3; ++i) {
+        submeshes.push_back(trimesh.get_submesh(i));
+        total_bytes += submeshes.back()->memory_usage();
+    }
+
+    // Only fits two of the three submeshes.
+    trimesh.m_max_cache_num_bytes = total_bytes - 1;
+    trimesh.clear_cache();
+    trimesh.reset_stats();
+    ASSERT_EQ(trimesh.cache_num_bytes(), 0);
+
+    trimesh.assign_mesh(0, submeshes[0]);
+    trimesh.assign_mesh(1, submeshes[1]);
+    ASSERT_EQ(trimesh.cache_num_bytes(), submeshes[0]->memory_usage() + submeshes[1]->memory_usage());
+    ASSERT_EQ(trimesh.get_stats().evictions, 0);
+
+    // Visit the first submesh so the second becomes the least recently used.
+    auto center = submeshes[0]->get_aabb().center();
+    auto offset = edyn::vector3_one * edyn::scalar(0.01);
+    trimesh.visit_submeshes({center - offset, center + offset}, [] (auto) {});
+
+    trimesh.assign_mesh(2, submeshes[2]);
+    ASSERT_EQ(trimesh.get_stats().evictions, 1);
+    ASSERT_TRUE(trimesh.get_submesh(0));
+    ASSERT_FALSE(trimesh.get_submesh(1));
+    ASSERT_TRUE(trimesh.get_submesh(2));
+    ASSERT_EQ(trimesh.cache_num_bytes(), submeshes[0]->memory_usage() + submeshes[2]->memory_usage());
+    ASSERT_LE(trimesh.cache_num_bytes(), trimesh.m_max_cache_num_bytes);
+
+    edyn::deinit();
+}
+
+TEST(test_paged_trimesh, streamed_file) {
+    edyn::init({2});
+
+    std::vector<edyn::vector3> vertices;
+    std::vector<edyn::triangle_mesh::index_type> indices;
+    edyn::make_plane_mesh(20, 20, 16, 16, vertices, indices);
+
+    for (auto &v : vertices) {
+        v.y = std::sin(v.x) * std::cos(v.z);
+    }
+
+    auto loader = std::make_shared<edyn::paged_triangle_mesh_file_input_archive>();
+    auto mode = edyn::paged_triangle_mesh_serialization_mode::embedded;
+
+    auto serial_filename = "paged_trimesh_serial.bin";
+    auto serial_trimesh = edyn::paged_triangle_mesh(loader);
+    edyn::create_paged_triangle_mesh(serial_trimesh, vertices.begin(), vertices.end(),
+                                     indices.begin(), indices.end(), 32, {});
+
+    {
+        auto output = edyn::paged_triangle_mesh_file_output_archive(serial_filename, mode);
+        edyn::serialize(output, serial_trimesh);
+    }
+
+    // Build in batches smaller than the number of submeshes.
+    auto streamed_filename = "paged_trimesh_streamed.bin";
+    auto streamed_trimesh = edyn::paged_triangle_mesh(loader);
+    edyn::create_paged_triangle_mesh_file(streamed_filename, mode, streamed_trimesh,
+                                          vertices.begin(), vertices.end(),
+                                          indices.begin(), indices.end(), 32, {}, 3);
+
+    ASSERT_EQ(streamed_trimesh.num_submeshes(), serial_trimesh.num_submeshes());
+    ASSERT_EQ(streamed_trimesh.cache_num_vertices(), 0);
+
+    auto read_file = [] (const char *filename) {
+        auto file = std::ifstream(filename, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(file), {});
+    };
+
+    auto serial_data = read_file(serial_filename);
+    auto streamed_data = read_file(streamed_filename);
+    ASSERT_FALSE(serial_data.empty());
+    ASSERT_TRUE(serial_data == streamed_data);
+
+    edyn::deinit();
+}
+
+TEST(test_paged_trimesh, compressed_file) {
+    edyn::init({2});
+
+    std::vector<edyn::vector3> vertices;
+    std::vector<edyn::triangle_mesh::index_type> indices;
+    edyn::make_plane_mesh(20, 20, 16, 16, vertices, indices);
+
+    for (auto &v : vertices) {
+        v.y = std::sin(v.x) * std::cos(v.z);
+    }
+
+    auto reference_loader = std::make_shared<triangle_mesh_page_loader>();
+    auto reference_trimesh = edyn::paged_triangle_mesh(reference_loader);
+    edyn::create_paged_triangle_mesh(reference_trimesh, vertices.begin(), vertices.end(),
+                                     indices.begin(), indices.end(), 32, {});
+
+    auto filename = "paged_trimesh_compressed.bin";
+    auto mode = edyn::paged_triangle_mesh_serialization_mode::embedded;
+    auto streamed_trimesh = edyn::paged_triangle_mesh(reference_loader);
+    edyn::create_paged_triangle_mesh_file(filename, mode, streamed_trimesh,
+                                          vertices.begin(), vertices.end(),
+                                          indices.begin(), indices.end(), 32, {}, 3, true);
+
+    auto loader = std::make_shared<edyn::paged_triangle_mesh_batched_loader>(4);
+    ASSERT_TRUE(loader->open(filename));
+
+    auto input_trimesh = edyn::paged_triangle_mesh(loader);
+    edyn::serialize(*loader, input_trimesh);
+    ASSERT_EQ(input_trimesh.num_submeshes(), reference_trimesh.num_submeshes());
+
+    input_trimesh.visit_triangles(input_trimesh.get_aabb(), [] (auto, auto) {});
+
+    for (size_t i = 0; i < 500 && loader->num_loaded() < input_trimesh.num_submeshes(); ++i) {
+        edyn::delay(10);
+    }
+
+    ASSERT_EQ(loader->num_loaded(), input_trimesh.num_submeshes());
+    ASSERT_EQ(input_trimesh.cache_num_vertices(), reference_trimesh.cache_num_vertices());
+
+    for (size_t i = 0; i < reference_trimesh.num_submeshes(); ++i) {
+        auto submesh = reference_trimesh.get_submesh(i);
+        auto input_submesh = input_trimesh.get_submesh(i);
+        ASSERT_TRUE(input_submesh);
+        ASSERT_TRUE(input_submesh->is_compressed());
+        ASSERT_EQ(input_submesh->num_vertices(), submesh->num_vertices());
+
+        // Positions are quantized relative to the AABB of each submesh.
+        for (size_t j = 0; j < submesh->num_vertices(); ++j) {
+            auto dist = edyn::distance(input_submesh->get_vertex_position(j), submesh->get_vertex_position(j));
+            ASSERT_LT(dist, edyn::scalar(0.001));
+        }
+    }
+
+    loader->close();
+    edyn::deinit();
+}
+
+TEST(test_paged_trimesh, empty_streamed_file) {
+    edyn::init({2});
+
+    std::vector<edyn::vector3> vertices;
+    std::vector<edyn::triangle_mesh::index_type> indices;
+    auto loader = std::make_shared<edyn::paged_triangle_mesh_file_input_archive>();
+    auto mode = edyn::paged_triangle_mesh_serialization_mode::embedded;
+
+    auto filename = "paged_trimesh_empty.bin";
+    auto trimesh = edyn::paged_triangle_mesh(loader);
+    edyn::create_paged_triangle_mesh_file(filename, mode, trimesh,
+                                          vertices.begin(), vertices.end(),
+                                          indices.begin(), indices.end(), 32, {});
+    ASSERT_EQ(trimesh.num_submeshes(), 0);
+
+    loader->open(filename);
+    ASSERT_TRUE(loader->is_file_open());
+    auto input_trimesh = edyn::paged_triangle_mesh(loader);
+    edyn::serialize(*loader, input_trimesh);
+    ASSERT_EQ(input_trimesh.num_submeshes(), 0);
+
+    auto num_visited = 0;
+    auto aabb = edyn::AABB{-edyn::vector3_one, edyn::vector3_one};
+    input_trimesh.visit_triangles(aabb, [&] (auto, auto) { ++num_visited; });
+    ASSERT_EQ(num_visited, 0);
+
+    edyn::deinit();
+}
@@ -39,3 +39,144 @@ TEST(test_trimesh, voronoi_regions) {
     ASSERT_VECTOR3_EQ(trimesh.get_aabb().min, {-1, 0, -1});
     ASSERT_VECTOR3_EQ(trimesh.get_aabb().max, {2, 1, 1});
 }
+
+TEST(test_trimesh, soa_layout_culling) {
+    // Flat grid of 8x8 quads on the XZ plane.
+    auto vertices = std::vector<edyn::vector3>{};
+    auto indices = std::vector<uint32_t>{};
+    constexpr uint32_t size = 9;
+
+    for (uint32_t i = 0; i < size; ++i) {
+        for (uint32_t j = 0; j < size; ++j) {
+            vertices.push_back({edyn::scalar(i), 0, edyn::scalar(j)});
+        }
+    }
+
+    for (uint32_t i = 0; i < size - 1; ++i) {
+        for (uint32_t j = 0; j < size - 1; ++j) {
+            auto v0 = i * size + j;
+            auto v1 = v0 + 1;
+            auto v2 = v0 + size;
+            auto v3 = v2 + 1;
+            indices.insert(indices.end(), {v0, v1, v3});
+            indices.insert(indices.end(), {v0, v3, v2});
+        }
+    }
+
+    auto trimesh = edyn::triangle_mesh{};
+    trimesh.insert_vertices(vertices.begin(), vertices.end());
+    trimesh.insert_indices(indices.begin(), indices.end());
+    trimesh.initialize();
+
+    auto query_aabb = edyn::AABB{{1.5, -1, 1.5}, {3.5, 1, 3.5}};
+    auto resting_aabb = edyn::AABB{{1.5, -0.1, 1.5}, {3.5, 1, 3.5}};
+    auto hovering_aabb = edyn::AABB{{1.5, 0.5, 1.5}, {3.5, 1, 3.5}};
+    auto threshold = edyn::scalar(0.02);
+
+    auto collect = [&] (const edyn::AABB &shape_aabb) {
+        auto result = std::vector<uint32_t>{};
+        trimesh.visit_triangles_culled(query_aabb, shape_aabb, threshold,
+                                       [&] (auto tri_idx, const auto &verts, const auto &normal) {
+            ASSERT_VECTOR3_EQ(normal, trimesh.get_triangle_normal(tri_idx));
+            ASSERT_VECTOR3_EQ(verts[0], trimesh.get_triangle_vertices(tri_idx)[0]);
+            result.push_back(tri_idx);
+        });
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+
+    auto resting_scalar = collect(resting_aabb);
+    auto hovering_scalar = collect(hovering_aabb);
+
+    trimesh.build_soa_layout();
+    ASSERT_TRUE(trimesh.has_soa_layout());
+
+    auto resting_soa = collect(resting_aabb);
+    auto hovering_soa = collect(hovering_aabb);
+
+    ASSERT_FALSE(resting_scalar.empty());
+    ASSERT_EQ(resting_scalar, resting_soa);
+    // Shape is further than the threshold above the plane.
+    ASSERT_TRUE(hovering_scalar.empty());
+    ASSERT_TRUE(hovering_soa.empty());
+}
+
+TEST(test_trimesh, compression) {
+    auto vertices = std::vector<edyn::vector3>{};
+    auto indices = std::vector<edyn::triangle_mesh::index_type>{};
+    edyn::make_plane_mesh(40, 40, 16, 16, vertices, indices);
+
+    for (auto &v : vertices) {
+        v.y = std::sin(v.x * edyn::scalar(0.3)) * std::cos(v.z * edyn::scalar(0.2)) * 4;
+    }
+
+    auto trimesh = edyn::triangle_mesh{};
+    trimesh.insert_vertices(vertices.begin(), vertices.end());
+    trimesh.insert_indices(indices.begin(), indices.end());
+    trimesh.initialize();
+
+    auto compressed = trimesh;
+    compressed.compress();
+    ASSERT_TRUE(compressed.is_compressed());
+    ASSERT_EQ(compressed.num_vertices(), trimesh.num_vertices());
+
+    // Quantization step is the extent divided by 65535.
+    auto position_tolerance = edyn::scalar(0.001);
+    auto normal_tolerance = edyn::scalar(0.0001);
+
+    for (size_t i = 0; i < trimesh.num_vertices(); ++i) {
+        auto dist = edyn::distance(trimesh.get_vertex_position(i), compressed.get_vertex_position(i));
+        ASSERT_LT(dist, position_tolerance);
+    }
+
+    for (size_t i = 0; i < trimesh.num_triangles(); ++i) {
+        auto n0 = trimesh.get_triangle_normal(i);
+        auto n1 = compressed.get_triangle_normal(i);
+        ASSERT_GT(edyn::dot(n0, n1), 1 - normal_tolerance);
+
+        for (size_t j = 0; j < 3; ++j) {
+            auto a0 = trimesh.get_adjacent_face_normal(i, j);
+            auto a1 = compressed.get_adjacent_face_normal(i, j);
+            ASSERT_GT(edyn::dot(a0, a1), 1 - normal_tolerance);
+        }
+    }
+
+    // Decoded triangles must be enclosed by the rebuilt tree.
+    auto aabb = compressed.get_aabb();
+
+    compressed.visit_all([&] (auto tri_idx, auto &verts) {
+        for (auto &v : verts) {
+            ASSERT_TRUE(aabb.contains(v));
+        }
+    });
+}
+
+TEST(test_trimesh, compression_thin_axis) {
+    auto vertices = std::vector<edyn::vector3>{};
+    auto indices = std::vector<edyn::triangle_mesh::index_type>{};
+    edyn::make_plane_mesh(10, 10, 8, 8, vertices, indices);
+
+    // Height varies by a couple millimeters only, which must be preserved.
+    auto height = edyn::scalar(0.002);
+
+    for (auto &v : vertices) {
+        v.y = (std::sin(v.x) * std::cos(v.z) + 1) * height / 2;
+    }
+
+    auto trimesh = edyn::triangle_mesh{};
+    trimesh.insert_vertices(vertices.begin(), vertices.end());
+    trimesh.insert_indices(indices.begin(), indices.end());
+    trimesh.initialize();
+
+    auto compressed = trimesh;
+    compressed.compress();
+
+    // Quantization step along y is the height divided by 65535.
+    auto tolerance = height / 1000;
+
+    for (size_t i = 0; i < trimesh.num_vertices(); ++i) {
+        auto y0 = trimesh.get_vertex_position(i).y;
+        auto y1 = compressed.get_vertex_position(i).y;
+        ASSERT_NEAR(y0, y1, tolerance);
+    }
+}
@@ -0,0 +1,70 @@
+#include "../common/common.hpp"
+#include <edyn/sys/update_rotated_meshes.hpp>
+#include <edyn/comp/rotated_mesh_list.hpp>
+
+TEST(update_rotated_meshes, on_demand) {
+    entt::registry registry;
+
+    auto mesh = std::make_shared<edyn::convex_mesh>();
+    edyn::make_box_mesh({0.5, 0.5, 0.5}, mesh->vertices, mesh->indices, mesh->faces);
+    mesh->initialize();
+
+    auto entity = registry.create();
+    auto &orn = registry.emplace<edyn::orientation>(entity, edyn::quaternion_identity);
+    auto rotated = std::make_unique<edyn::rotated_mesh>(edyn::make_rotated_mesh(*mesh, orn));
+    auto &rotated_list = registry.emplace<edyn::rotated_mesh_list>(entity, mesh, std::move(rotated));
+    auto &rotated_vertices = rotated_list.rotated->vertices;
+
+    // Overwrite a rotated vertex with a value that a recomputation would
+    // replace, to tell whether the rotated mesh was recomputed.
+    const auto sentinel = edyn::vector3{100, 100, 100};
+    auto was_recomputed = [&] {
+        auto recomputed = rotated_vertices[0] != sentinel;
+        rotated_vertices[0] = sentinel;
+        return recomputed;
+    };
+
+    // Never updated lists are always recomputed.
+    edyn::invalidate_rotated_meshes(registry);
+    rotated_vertices[0] = sentinel;
+    edyn::update_rotated_mesh_if_outdated(registry, entity);
+    ASSERT_TRUE(was_recomputed());
+    ASSERT_VECTOR3_EQ(mesh->vertices[1], rotated_vertices[1]);
+
+    // Same version: not recomputed even if the orientation changed.
+    orn = edyn::quaternion_axis_angle({0, 1, 0}, edyn::pi_half);
+    edyn::update_rotated_mesh_if_outdated(registry, entity);
+    ASSERT_FALSE(was_recomputed());
+
+    // New version and new orientation: recomputed.
+    edyn::invalidate_rotated_meshes(registry);
+    edyn::update_rotated_mesh_if_outdated(registry, entity);
+    ASSERT_TRUE(was_recomputed());
+    ASSERT_VECTOR3_EQ(edyn::rotate(orn, mesh->vertices[1]), rotated_vertices[1]);
+
+    // Updating again with the same version does nothing.
+    edyn::update_rotated_mesh_if_outdated(registry, entity);
+    ASSERT_FALSE(was_recomputed());
+
+    // New version but same orientation: only the version stamp is refreshed.
+    edyn::invalidate_rotated_meshes(registry);
+    auto version = rotated_list.version;
+    edyn::update_rotated_mesh_if_outdated(registry, entity);
+    ASSERT_FALSE(was_recomputed());
+    ASSERT_NE(rotated_list.version, version);
+
+    // The refreshed stamp avoids further checks until the next invalidation.
+    orn = edyn::quaternion_axis_angle({1, 0, 0}, edyn::pi_half);
+    edyn::update_rotated_mesh_if_outdated(registry, entity);
+    ASSERT_FALSE(was_recomputed());
+
+    edyn::invalidate_rotated_meshes(registry);
+    edyn::update_rotated_mesh_if_outdated(registry, entity);
+    ASSERT_TRUE(was_recomputed());
+    ASSERT_VECTOR3_EQ(edyn::rotate(orn, mesh->vertices[1]), rotated_vertices[1]);
+
+    // Entities without rotated meshes are ignored.
+    auto other = registry.create();
+    registry.emplace<edyn::orientation>(other, edyn::quaternion_identity);
+    edyn::update_rotated_mesh_if_outdated(registry, other);
+}
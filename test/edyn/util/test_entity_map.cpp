@@ -0,0 +1,127 @@
+#include "../common/common.hpp"
+#include "edyn/util/entity_map.hpp"
+#include <map>
+
+TEST(test_entity_map, insert_erase) {
+    auto reg0 = entt::registry{};
+    auto reg1 = entt::registry{};
+
+    auto ent00 = reg0.create();
+    auto ent01 = reg0.create();
+    auto ent10 = reg1.create();
+    auto ent11 = reg1.create();
+
+    auto emap = edyn::entity_map{};
+    emap.insert(ent00, ent11);
+    emap.insert(ent01, ent10);
+
+    ASSERT_TRUE(emap.contains(ent00));
+    ASSERT_TRUE(emap.contains_other(ent11));
+    ASSERT_EQ(emap.at(ent00), ent11);
+    ASSERT_EQ(emap.at_other(ent10), ent01);
+    ASSERT_EQ(emap.find(ent01), ent10);
+
+    emap.erase(ent00);
+    ASSERT_FALSE(emap.contains(ent00));
+    ASSERT_FALSE(emap.contains_other(ent11));
+    ASSERT_EQ(emap.find(ent00), entt::entity{entt::null});
+
+    emap.erase_other(ent10);
+    ASSERT_FALSE(emap.contains(ent01));
+
+    // Entities which are not mapped are rejected.
+    ASSERT_THROW(emap.at(ent00), std::out_of_range);
+    ASSERT_THROW(emap.at_other(ent10), std::out_of_range);
+    ASSERT_THROW(emap.erase(ent01), std::out_of_range);
+    ASSERT_THROW(emap.erase_other(ent11), std::out_of_range);
+}
+
+TEST(test_entity_map, version_check) {
+    auto reg0 = entt::registry{};
+    auto reg1 = entt::registry{};
+
+    auto ent0 = reg0.create();
+    auto ent1 = reg1.create();
+
+    auto emap = edyn::entity_map{};
+    emap.insert(ent0, ent1);
+
+    // A recycled entity has the same index but another version, thus it must
+    // not be found in the map.
+    reg0.destroy(ent0);
+    auto recycled = reg0.create();
+    ASSERT_EQ(entt::to_entity(recycled), entt::to_entity(ent0));
+    ASSERT_FALSE(emap.contains(recycled));
+    ASSERT_EQ(emap.find(recycled), entt::entity{entt::null});
+}
+
+TEST(test_entity_map, each_swap) {
+    auto emap = edyn::entity_map{};
+
+    for (unsigned i = 0; i < 100; ++i) {
+        emap.insert(entt::entity{i * 3}, entt::entity{i});
+    }
+
+    unsigned count = 0;
+    emap.each([&] (entt::entity entity, entt::entity other) {
+        ASSERT_EQ(entt::to_integral(entity), entt::to_integral(other) * 3);
+        ++count;
+    });
+    ASSERT_EQ(count, 100);
+
+    emap.erase_if([] (entt::entity, entt::entity other) {
+        return entt::to_integral(other) % 2 == 0;
+    });
+
+    emap.swap();
+
+    for (unsigned i = 0; i < 100; ++i) {
+        ASSERT_EQ(emap.contains(entt::entity{i}), i % 2 == 1);
+    }
+}
+
+TEST(test_entity_map, sparse_indices) {
+    auto emap = edyn::entity_map{};
+    auto reference = std::map<unsigned, unsigned>{};
+
+    // Indices spread over many pages, including far apart ones.
+    for (unsigned i = 0; i < 200; ++i) {
+        auto index = (i * 7919u) % 100000u;
+        emap.insert(entt::entity{index}, entt::entity{i});
+        reference[index] = i;
+    }
+
+    ASSERT_EQ(emap.size(), reference.size());
+
+    // Erase entries in an order unrelated to insertion, which moves other
+    // entries around in the packed array.
+    for (unsigned i = 0; i < 200; i += 3) {
+        auto index = (i * 7919u) % 100000u;
+        emap.erase_other(entt::entity{i});
+        reference.erase(index);
+    }
+
+    ASSERT_EQ(emap.size(), reference.size());
+
+    for (auto &[index, other] : reference) {
+        ASSERT_EQ(emap.at(entt::entity{index}), entt::entity{other});
+        ASSERT_EQ(emap.at_other(entt::entity{other}), entt::entity{index});
+    }
+
+    // Only mapped entities are visited.
+    size_t count = 0;
+    emap.each([&] (entt::entity entity, entt::entity other) {
+        ASSERT_EQ(reference.at(entt::to_integral(entity)), entt::to_integral(other));
+        ++count;
+    });
+    ASSERT_EQ(count, reference.size());
+
+    // Erase everything, which releases all pages, then map again.
+    emap.erase_if([] (entt::entity, entt::entity) { return true; });
+    ASSERT_EQ(emap.size(), 0);
+    ASSERT_FALSE(emap.contains(entt::entity{0}));
+
+    emap.insert(entt::entity{99999}, entt::entity{1});
+    ASSERT_EQ(emap.at(entt::entity{99999}), entt::entity{1});
+    ASSERT_EQ(emap.size(), 1);
+}
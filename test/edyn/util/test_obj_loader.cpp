@@ -0,0 +1,72 @@
+#include "../common/common.hpp"
+#include <fstream>
+
+static void write_test_obj(const char *filename) {
+    auto file = std::ofstream(filename, std::ios::binary);
+    file << "# comment line\n"
+         << "o first\n"
+         << "v 0 0 0\n"
+         << "v 1.5 0 -0.25 0.5 0.25 1\n"
+         << "v 1 1e-3 +1\r\n"
+         << "v .5 2. -3.125 \n"
+         << "vn 0 1 0\n"
+         << "vt 0.5 0.5\n"
+         << "s off\n"
+         << "f 1/1/1 2/1/1 3/1/1\n"
+         << "f 1 3 4 2\r\n"
+         << "o second\n"
+         << "v 4 4 4 1 0 0\n"
+         << "v 5 4 4 0 1 0\n"
+         << "v 5 5 4 0 0 1\n"
+         << "f 5//1 6//1 7//1\n"
+         << "f 7 6 5";
+}
+
+TEST(test_obj_loader, meshes) {
+    auto filename = "test_obj_loader_meshes.obj";
+    write_test_obj(filename);
+
+    auto pos = edyn::vector3{1, 2, 3};
+    auto orn = edyn::quaternion_axis_angle({0, 1, 0}, edyn::to_radians(30));
+    auto scale = edyn::vector3{2, 2, 2};
+
+    std::vector<edyn::obj_mesh> meshes, mapped_meshes;
+    ASSERT_TRUE(edyn::load_meshes_from_obj(filename, meshes, pos, orn, scale));
+    ASSERT_TRUE(edyn::load_meshes_from_obj_mapped(filename, mapped_meshes, pos, orn, scale));
+    ASSERT_EQ(meshes.size(), 2);
+    ASSERT_EQ(mapped_meshes.size(), meshes.size());
+
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        ASSERT_EQ(mapped_meshes[i].vertices, meshes[i].vertices);
+        ASSERT_EQ(mapped_meshes[i].colors, meshes[i].colors);
+        ASSERT_EQ(mapped_meshes[i].indices, meshes[i].indices);
+        ASSERT_EQ(mapped_meshes[i].faces, meshes[i].faces);
+    }
+
+    ASSERT_FALSE(edyn::load_meshes_from_obj_mapped("file_that_does_not_exist.obj", mapped_meshes));
+}
+
+TEST(test_obj_loader, tri_mesh) {
+    edyn::init({2});
+
+    auto filename = "test_obj_loader_tri_mesh.obj";
+    write_test_obj(filename);
+
+    std::vector<edyn::vector3> vertices, colors;
+    std::vector<uint32_t> indices;
+    ASSERT_TRUE(edyn::load_tri_mesh_from_obj(filename, vertices, indices, &colors));
+
+    // Use tiny chunks to parse in parallel.
+    for (auto min_chunk_size : {size_t(1) << 20, size_t(16)}) {
+        std::vector<edyn::vector3> mapped_vertices, mapped_colors;
+        std::vector<uint32_t> mapped_indices;
+        ASSERT_TRUE(edyn::load_tri_mesh_from_obj_mapped(filename, mapped_vertices, mapped_indices, &mapped_colors,
+                                                        edyn::vector3_zero, edyn::quaternion_identity,
+                                                        edyn::vector3_one, min_chunk_size));
+        ASSERT_EQ(mapped_vertices, vertices);
+        ASSERT_EQ(mapped_colors, colors);
+        ASSERT_EQ(mapped_indices, indices);
+    }
+
+    edyn::deinit();
+}
@@ -158,3 +158,113 @@ TEST(test_registry_operation, test_impl) {
 
     ASSERT_FALSE(reg1.all_of<another_comp>(ent11));
 }
+
+struct update_counter {
+    void on_update(entt::registry &, entt::entity) {
+        ++count;
+    }
+
+    int count {0};
+};
+
+TEST(test_registry_operation, test_bulk_replace) {
+    auto reg0 = entt::registry{};
+    auto reg1 = entt::registry{};
+
+    auto builder = edyn::registry_operation_builder_impl<another_comp>{};
+    std::vector<entt::entity> entities;
+
+    for (int i = 0; i < 10; ++i) {
+        auto entity = reg0.create();
+        reg0.emplace<another_comp>(entity, double(i));
+        builder.create(entity);
+        builder.emplace<another_comp>(reg0, entity);
+        entities.push_back(entity);
+    }
+
+    auto emap = edyn::entity_map{};
+    builder.finish().execute(reg1, emap);
+
+    auto counter = update_counter{};
+    reg1.on_update<another_comp>().connect<&update_counter::on_update>(counter);
+
+    // Remove one component in the target registry. It must be skipped.
+    reg1.remove<another_comp>(emap.at(entities[3]));
+
+    for (auto entity : entities) {
+        reg0.get<another_comp>(entity).d += 100;
+    }
+
+    builder.replace<another_comp>(reg0, entities.begin(), entities.end());
+    auto ops = builder.finish();
+
+    // Signals are not emitted by default.
+    ops.execute(reg1, emap);
+    ASSERT_EQ(counter.count, 0);
+
+    for (size_t i = 0; i < entities.size(); ++i) {
+        auto local_entity = emap.at(entities[i]);
+
+        if (i == 3) {
+            ASSERT_FALSE(reg1.all_of<another_comp>(local_entity));
+        } else {
+            ASSERT_EQ(reg1.get<another_comp>(local_entity).d, double(i) + 100);
+        }
+    }
+
+    // Opt into signals.
+    ops.execute(reg1, emap, false, true);
+    ASSERT_EQ(counter.count, int(entities.size()) - 1);
+}
+
+TEST(test_registry_operation, test_insert_dirty) {
+    auto reg0 = entt::registry{};
+    auto reg1 = entt::registry{};
+
+    auto ent0 = reg0.create();
+    reg0.emplace<edyn::linvel>(ent0, edyn::vector3_x);
+    reg0.emplace<another_comp>(ent0, 3.14);
+
+    edyn::registry_operation_builder *builder =
+        new edyn::registry_operation_builder_impl<edyn::linvel, another_comp>;
+
+    // `linvel` is a shared component and is tracked by index whereas
+    // `another_comp` is tracked by type id.
+    auto dirty = edyn::dirty{};
+    dirty.created<edyn::linvel, another_comp>();
+    ASSERT_TRUE(dirty.created_indexes.any());
+    ASSERT_EQ(dirty.created_ids.size(), size_t(1));
+
+    builder->create(ent0);
+    builder->insert_dirty(reg0, ent0, dirty);
+    auto ops = builder->finish();
+
+    auto emap = edyn::entity_map{};
+    ops.execute(reg1, emap);
+
+    auto ent1 = emap.at(ent0);
+    ASSERT_EQ(reg1.get<edyn::linvel>(ent1), edyn::vector3_x);
+    ASSERT_EQ(reg1.get<another_comp>(ent1).d, 3.14);
+
+    // Update and remove.
+    reg0.get<edyn::linvel>(ent0) = edyn::vector3_y;
+    reg0.remove<another_comp>(ent0);
+
+    dirty = edyn::dirty{};
+    dirty.updated<edyn::linvel>().destroyed<another_comp>();
+
+    auto num_updated = 0;
+    dirty.each_updated_id([&] (entt::id_type id) {
+        ASSERT_EQ(id, entt::type_index<edyn::linvel>::value());
+        ++num_updated;
+    });
+    ASSERT_EQ(num_updated, 1);
+
+    builder->insert_dirty(reg0, ent0, dirty);
+    builder->finish().execute(reg1, emap);
+
+    ASSERT_EQ(reg1.get<edyn::linvel>(ent1), edyn::vector3_y);
+    ASSERT_FALSE(reg1.all_of<another_comp>(ent1));
+
+    delete builder;
+}
@@ -0,0 +1,96 @@
+#include "../common/common.hpp"
+#include "edyn/util/registry_operation.hpp"
+#include "edyn/util/registry_operation_builder.hpp"
+#include <new>
+#include <atomic>
+#include <cstdlib>
+
+// The global allocation functions are replaced to count heap allocations,
+// which is why these tests are built into their own executable.
+//
+// Only the exchange of registry operations is checked for allocations since
+// stepping a world still allocates in every step, for instance:
+// - `edyn::broadphase_worker::view` creates a new `edyn::tree_view` for the
+//   island after every step, which allocates its array of nodes.
+// - `edyn::broadphase_main::update` collects the awake islands and the pairs
+//   of intersecting islands into new vectors.
+
+// Counts heap allocations while enabled.
+static std::atomic<bool> count_allocations {false};
+static std::atomic<size_t> num_allocations {0};
+
+void * operator new(size_t size) {
+    if (count_allocations.load(std::memory_order_relaxed)) {
+        num_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (auto *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+struct another_comp {
+    double d;
+};
+
+TEST(test_registry_operation_allocations, test_recycle) {
+    auto reg0 = entt::registry{};
+    auto reg1 = entt::registry{};
+
+    auto builder = edyn::registry_operation_builder_impl<another_comp>{};
+    std::vector<entt::entity> entities;
+
+    for (int i = 0; i < 100; ++i) {
+        auto entity = reg0.create();
+        reg0.emplace<another_comp>(entity, double(i));
+        builder.create(entity);
+        builder.emplace<another_comp>(reg0, entity);
+        entities.push_back(entity);
+    }
+
+    auto emap = edyn::entity_map{};
+    auto ops = builder.finish();
+    ops.execute(reg1, emap);
+    ops.recycle();
+
+    auto step = [&] {
+        for (auto entity : entities) {
+            reg0.get<another_comp>(entity).d += 1;
+        }
+
+        builder.replace<another_comp>(reg0, entities.begin(), entities.end());
+        auto ops = builder.finish();
+        ops.execute(reg1, emap);
+        ops.recycle();
+    };
+
+    // Warm up so all storage has been allocated, including the blocks of the
+    // recycle queue.
+    for (int i = 0; i < 200; ++i) {
+        step();
+    }
+
+    count_allocations = true;
+
+    for (int i = 0; i < 100; ++i) {
+        step();
+    }
+
+    count_allocations = false;
+
+    ASSERT_EQ(num_allocations.load(), size_t(0));
+
+    for (auto entity : entities) {
+        ASSERT_EQ(reg1.get<another_comp>(emap.at(entity)).d, reg0.get<another_comp>(entity).d);
+    }
+}